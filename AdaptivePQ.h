@@ -0,0 +1,416 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef ADAPTIVEPQ_H
+#define ADAPTIVEPQ_H
+
+#include "Eecs281PQ.h"
+#include "BinaryPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+// A priority queue that watches how it is used and moves its contents
+// between UnorderedFastPQ, BinaryPQ and SortedPQ to suit the workload.
+//
+// Every 'window' mutating operations (at least MIN_WINDOW, and never less
+// than the current size so a migration's O(n) cost is amortized over the
+// window) the counts of pushes, pops and updatePriorities() calls since the
+// last check are compared against the thresholds below. top() is not
+// counted: peeking without popping costs O(1) in every representation, so
+// it is no reason to pay SortedPQ's O(n) pushes.
+// Each representation is entered at one threshold and only left at a
+// looser one, so a workload that sits near a boundary does not thrash.
+//
+// The representations are built over Allocator, and the representation
+// object itself is allocated with it.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class AdaptivePQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Unordered = UnorderedFastPQ<TYPE, COMP_FUNCTOR, Allocator>;
+    using Binary = BinaryPQ<TYPE, COMP_FUNCTOR, Allocator>;
+    using Sorted = SortedPQ<TYPE, COMP_FUNCTOR, Allocator>;
+
+public:
+    using allocator_type = Allocator;
+
+    enum class Representation { Unordered, Binary, Sorted };
+
+    // Below SMALL_ENTER elements a linear scan beats a heap, and a queue
+    // already using the scan keeps it until it grows past SMALL_LEAVE.
+    // bench/benchAdaptive measures the crossover at 12-16 int elements.
+    static constexpr size_t SMALL_ENTER = 12;
+    static constexpr size_t SMALL_LEAVE = 24;
+
+    // SortedPQ pays O(n) per push for an O(1) pop, so it is only used when
+    // pops outnumber pushes by SORTED_ENTER to 1, and abandoned once they
+    // fall below SORTED_LEAVE to 1 (or on any updatePriorities()).
+    static constexpr size_t SORTED_ENTER = 32;
+    static constexpr size_t SORTED_LEAVE = 8;
+
+    // updatePriorities() is O(1) for the unordered scan but O(n) for the
+    // heap, so a large queue switches to the scan when there is at least
+    // one update per UPDATE_ENTER pops and back below one per UPDATE_LEAVE.
+    static constexpr size_t UPDATE_ENTER = 2;
+    static constexpr size_t UPDATE_LEAVE = 8;
+
+    static constexpr size_t MIN_WINDOW = 64;
+
+
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit AdaptivePQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                        const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, alloc{ alloc }, kind{ Representation::Unordered },
+        impl{ create<Unordered>(alloc, comp, alloc) } {
+    } // AdaptivePQ()
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit AdaptivePQ(const Allocator &alloc) :
+        AdaptivePQ{ COMP_FUNCTOR(), alloc } {
+    } // AdaptivePQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor. Starts in whichever representation
+    //              fits the size of the range.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    AdaptivePQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+               const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, alloc{ alloc }, kind{ Representation::Unordered },
+        impl{ create<Unordered>(alloc, start, end, comp, alloc) } {
+        if(impl->size() > SMALL_ENTER) {
+            migrate(Representation::Binary);
+        }
+    } // AdaptivePQ()
+
+
+    // Description: Copy constructor, keeps the same representation.
+    // Runtime: O(n)
+    AdaptivePQ(const AdaptivePQ &other) :
+        AdaptivePQ{ other,
+                    std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc) } {
+    } // AdaptivePQ()
+
+
+    // Description: Copy constructor that allocates with 'alloc'.
+    // Runtime: O(n)
+    AdaptivePQ(const AdaptivePQ &other, const Allocator &alloc) :
+        BaseClass{ other.compare }, alloc{ alloc }, kind{ other.kind },
+        impl{ other.cloneImpl(alloc) }, window{ other.window } {
+    } // AdaptivePQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    AdaptivePQ &operator=(const AdaptivePQ &rhs) {
+        // built with this PQ's allocator, so the representations can be
+        // swapped
+        AdaptivePQ temp(rhs, alloc);
+
+        std::swap(kind, temp.kind);
+        std::swap(impl, temp.impl);
+        std::swap(window, temp.window);
+
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor, releases the current representation.
+    virtual ~AdaptivePQ() {
+        destroy(impl, kind);
+    } // ~AdaptivePQ()
+
+
+    // Description: Restores the PQ invariant in the current representation.
+    // Runtime: O(1), O(n) or O(n log(n)) depending on the representation.
+    virtual void updatePriorities() {
+        impl->updatePriorities();
+        window.updates++;
+        countOperation();
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: That of the current representation, plus amortized O(1)
+    //          for migrations.
+    virtual void push(const TYPE &val) {
+        impl->push(val);
+        window.pushes++;
+        countOperation();
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: That of the current representation, plus amortized O(1)
+    //          for migrations.
+    virtual void pop() {
+        impl->pop();
+        window.pops++;
+        countOperation();
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: That of the current representation.
+    virtual const TYPE &top() const {
+        return impl->top();
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return impl->size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return impl->empty();
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order, using the bulk pop of the
+    //              current representation. Counts as k pops.
+    // Runtime: That of the current representation's pop_k().
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        k = std::min(k, impl->size());
+        switch(kind) {
+        case Representation::Unordered:
+            out = static_cast<Unordered&>(*impl).pop_k(k, out);
+            break;
+        case Representation::Binary:
+            out = static_cast<Binary&>(*impl).pop_k(k, out);
+            break;
+        case Representation::Sorted:
+            out = static_cast<Sorted&>(*impl).pop_k(k, out);
+            break;
+        }
+        window.pops += k;
+        countOperation();
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: That of the current representation's pop_k().
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(impl->size(), out);
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed, using the bulk removal of
+    //              the current representation. It is not counted in the
+    //              operation profile.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        switch(kind) {
+        case Representation::Unordered:
+            return static_cast<Unordered&>(*impl).remove_if(pred);
+        case Representation::Binary:
+            return static_cast<Binary&>(*impl).remove_if(pred);
+        case Representation::Sorted:
+            return static_cast<Sorted&>(*impl).remove_if(pred);
+        }
+        return 0;
+    } // remove_if()
+
+
+    // Description: Which structure currently holds the elements.
+    // Runtime: O(1)
+    Representation representation() const {
+        return kind;
+    } // representation()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return alloc;
+    } // get_allocator()
+
+
+private:
+    // Operation counts since the last time the profile was checked.
+    struct Window {
+        size_t pushes = 0;
+        size_t pops = 0;
+        size_t updates = 0;
+
+        size_t mutations() const { return pushes + pops + updates; }
+    };
+
+    void countOperation() {
+        size_t length = std::max(MIN_WINDOW, impl->size());
+        if(window.mutations() < length) {
+            return;
+        }
+        Representation target = choose();
+        if(target != kind) {
+            migrate(target);
+        }
+        window = Window{};
+    }
+
+    // Picks a representation for the window that just ended, preferring
+    // the current one whenever it is still inside its leave threshold.
+    Representation choose() const {
+        size_t n = impl->size();
+        size_t pops = window.pops;
+
+        if(n <= SMALL_ENTER || (kind == Representation::Unordered && n < SMALL_LEAVE)) {
+            return Representation::Unordered;
+        }
+
+        if(window.updates > 0) {
+            bool stay = kind == Representation::Unordered && window.updates * UPDATE_LEAVE >= pops;
+            if(stay || window.updates * UPDATE_ENTER >= pops) {
+                return Representation::Unordered;
+            }
+            return Representation::Binary;
+        }
+
+        if(kind == Representation::Sorted) {
+            return window.pushes * SORTED_LEAVE > pops ? Representation::Binary
+                                                       : Representation::Sorted;
+        }
+        if(window.pushes * SORTED_ENTER <= pops) {
+            return Representation::Sorted;
+        }
+        return Representation::Binary;
+    }
+
+    // Moves every element into a freshly built representation.
+    // Runtime: O(n), or O(n log(n)) when the target is SortedPQ.
+    void migrate(Representation target) {
+        std::vector<TYPE, Allocator> elements = releaseImpl();
+        auto first = std::make_move_iterator(elements.begin());
+        auto last = std::make_move_iterator(elements.end());
+        BaseClass *next = nullptr;
+        switch(target) {
+        case Representation::Unordered:
+            next = create<Unordered>(alloc, first, last, this->compare, alloc);
+            break;
+        case Representation::Binary:
+            next = create<Binary>(alloc, first, last, this->compare, alloc);
+            break;
+        case Representation::Sorted:
+            next = create<Sorted>(alloc, first, last, this->compare, alloc);
+            break;
+        }
+        destroy(impl, kind);
+        impl = next;
+        kind = target;
+    }
+
+    std::vector<TYPE, Allocator> releaseImpl() {
+        switch(kind) {
+        case Representation::Unordered:
+            return static_cast<Unordered&>(*impl).release();
+        case Representation::Binary:
+            return static_cast<Binary&>(*impl).release();
+        case Representation::Sorted:
+            return static_cast<Sorted&>(*impl).release();
+        }
+        return std::vector<TYPE, Allocator>(alloc);
+    }
+
+    // A copy of the current representation allocated with 'to'.
+    BaseClass* cloneImpl(const Allocator &to) const {
+        switch(kind) {
+        case Representation::Unordered:
+            return cloneAs<Unordered>(to);
+        case Representation::Binary:
+            return cloneAs<Binary>(to);
+        case Representation::Sorted:
+            return cloneAs<Sorted>(to);
+        }
+        return nullptr;
+    }
+
+    template<typename PQ>
+    BaseClass* cloneAs(const Allocator &to) const {
+        PQ *copy = create<PQ>(to, this->compare, to);
+        *copy = static_cast<const PQ&>(*impl);
+        return copy;
+    }
+
+    // Allocates a representation with 'with' and constructs it from 'args'.
+    // A clone runs as a member of the source PQ, so the allocator is always
+    // the target's, passed in, never the member. The representation's own
+    // allocator is always passed explicitly too, so this constructs in place
+    // rather than through allocator_traits, which would add it a second time
+    // for an allocator such as polymorphic_allocator.
+    template<typename PQ, typename... Args>
+    static PQ* create(const Allocator &with, Args&&... args) {
+        ReboundAllocator<Allocator, PQ> pqAlloc(with);
+        PQ *pq = std::allocator_traits<decltype(pqAlloc)>::allocate(pqAlloc, 1);
+        try {
+            ::new(static_cast<void*>(pq)) PQ(std::forward<Args>(args)...);
+        }
+        catch(...) {
+            std::allocator_traits<decltype(pqAlloc)>::deallocate(pqAlloc, pq, 1);
+            throw;
+        }
+        return pq;
+    }
+
+    void destroy(BaseClass *pq, Representation representation) {
+        switch(representation) {
+        case Representation::Unordered:
+            destroyAs<Unordered>(pq);
+            break;
+        case Representation::Binary:
+            destroyAs<Binary>(pq);
+            break;
+        case Representation::Sorted:
+            destroyAs<Sorted>(pq);
+            break;
+        }
+    }
+
+    template<typename PQ>
+    void destroyAs(BaseClass *pq) {
+        if(pq == nullptr) return;
+        ReboundAllocator<Allocator, PQ> pqAlloc(alloc);
+        PQ *typed = static_cast<PQ*>(pq);
+        typed->~PQ();
+        std::allocator_traits<decltype(pqAlloc)>::deallocate(pqAlloc, typed, 1);
+    }
+
+    Allocator alloc;
+    Representation kind;
+    BaseClass *impl;
+    Window window;
+}; // AdaptivePQ
+
+
+namespace pmr {
+    // AdaptivePQ drawing its storage from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using AdaptivePQ = ::AdaptivePQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // ADAPTIVEPQ_H
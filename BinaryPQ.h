@@ -5,20 +5,41 @@
 
 
 #include <algorithm>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
 #include "Eecs281PQ.h"
 
 // A specialized version of the priority queue ADT implemented as a binary
 // heap.
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+//
+// For arithmetic keys ordered by std::less or std::greater the sifts down
+// pick the more extreme child arithmetically, by adding the result of the
+// comparison to the child's index, rather than with a branch. With random
+// keys that branch is mispredicted about half the time; the arithmetic form
+// compiles to a flag-setting instruction and costs the same on any input.
+// Other key types and comparators keep the branching code.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
 class BinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
+    using allocator_type = Allocator;
+
     // Description: Construct an empty PQ with an optional comparison functor.
     // Runtime: O(1)
-    explicit BinaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp } {
+    explicit BinaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                      const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data(alloc) {
+    } // BinaryPQ
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit BinaryPQ(const Allocator &alloc) :
+        BinaryPQ{ COMP_FUNCTOR(), alloc } {
     } // BinaryPQ
 
 
@@ -26,8 +47,9 @@ public:
     //              comparison functor.
     // Runtime: O(n) where n is number of elements in range.
     template<typename InputIterator>
-    BinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp } {
+    BinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data(alloc) {
         while(start != end) {
             data.push_back(*start);
             start++;
@@ -48,9 +70,8 @@ public:
     // Runtime: O(n)
     virtual void updatePriorities() {
         for(size_t i = data.size()/2; i > 0; i--) {
-            fixDown(i);
+            fixDown(i - 1);
         }
-        fixDown(0);
     } // updatePriorities()
 
 
@@ -69,10 +90,18 @@ public:
     //       you are familiar with them, you do not need to use exceptions in
     //       this project.
     // Runtime: O(log(n))
+    // Note: This is a bottom-up pop. The hole left at the root is walked
+    //       down the path of more extreme children to a leaf (one compare
+    //       per level), then the old back element is sifted up from there.
+    //       Since that element usually belongs near the bottom, the sift up
+    //       is short, giving about log(n) compares instead of 2*log(n).
     virtual void pop() {
-        data[0] = data.back();
+        TYPE last = std::move(data.back());
         data.pop_back();
-        fixDown(0);
+        if(data.empty()) return;
+        size_t hole = fixDownToLeaf(0);
+        data[hole] = std::move(last);
+        fixUp(hole);
     } // pop()
 
 
@@ -100,42 +129,209 @@ public:
     } // empty()
 
 
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order. Each root is moved out and
+    //              refilled with the same bottom-up sift as pop(), in one
+    //              loop with no virtual call per element.
+    // Runtime: O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, data.size()); k > 0; --k) {
+            *out++ = std::move(data.front());
+            BinaryPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order. Sorting the vector once is cheaper than n
+    //              separate sifts.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        std::sort(data.begin(), data.end(),
+                  [this](const TYPE &a, const TYPE &b) { return this->compare(b, a); });
+        out = std::move(data.begin(), data.end(), out);
+        data.clear();
+        return out;
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed. The vector is compacted in
+    //              place and then heapified once, bottom-up.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        auto kept = std::remove_if(data.begin(), data.end(), pred);
+        auto removed = static_cast<std::size_t>(data.end() - kept);
+        if(removed > 0) {
+            data.erase(kept, data.end());
+            BinaryPQ::updatePriorities();
+        }
+        return removed;
+    } // remove_if()
+
+
+    // Description: Moves every element out of the PQ, in storage order
+    //              rather than priority order, and leaves the PQ empty.
+    // Runtime: O(1)
+    std::vector<TYPE, Allocator> release() {
+        std::vector<TYPE, Allocator> out(data.get_allocator());
+        out.swap(data);
+        return out;
+    } // release()
+
+
+    // Description: Make room for 'n' elements, so pushes up to that size
+    //              do not allocate.
+    // Runtime: O(size()) if it reallocates, otherwise O(1)
+    void reserve(std::size_t n) {
+        data.reserve(n);
+    } // reserve()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return data.get_allocator();
+    } // get_allocator()
+
+
 private:
+    static constexpr bool BRANCHLESS = std::is_arithmetic<TYPE>::value
+        && (std::is_same<COMP_FUNCTOR, std::less<TYPE>>::value
+            || std::is_same<COMP_FUNCTOR, std::greater<TYPE>>::value
+            || std::is_same<COMP_FUNCTOR, std::less<>>::value
+            || std::is_same<COMP_FUNCTOR, std::greater<>>::value);
+
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
+    std::vector<TYPE, Allocator> data;
+
+    // The more extreme of the sibling pair starting at 'child', which must
+    // have both children. No branch: the comparison is added as 0 or 1.
+    size_t moreExtremeChild(const TYPE *heap, size_t child) const {
+        return child + static_cast<size_t>(this->compare(heap[child], heap[child + 1]));
+    }
 
-    virtual void fixUp(size_t index) {
-        if(index == 0 || !this->compare(data[(index - 1)/2], data[index])) {
+    // Moves the element at index up until its parent is at least as
+    // extreme. The element is held aside and parents are moved down into
+    // the hole, so each level costs one move instead of a swap.
+    void fixUp(size_t index) {
+        TYPE val = std::move(data[index]);
+        while(index > 0) {
+            size_t parent = (index - 1)/2;
+            if(!this->compare(data[parent], val)) break;
+            data[index] = std::move(data[parent]);
+            index = parent;
+        }
+        data[index] = std::move(val);
+    }
+
+    // Moves the element at index down until both children are no more
+    // extreme than it, carrying a hole the same way fixUp() does.
+    void fixDown(size_t index) {
+        if constexpr(BRANCHLESS) {
+            fixDownBranchless(index);
             return;
         }
-        else {
-            std::swap(data[(index - 1)/2], data[index]);
-            fixUp((index - 1)/2);
+        TYPE val = std::move(data[index]);
+        size_t child = (2*index) + 1;
+        while(child < data.size()) {
+            // pick the more extreme child, if the right one exists
+            if(child + 1 < data.size() && this->compare(data[child], data[child + 1])) {
+                child++;
+            }
+            if(!this->compare(val, data[child])) break;
+            data[index] = std::move(data[child]);
+            index = child;
+            child = (2*index) + 1;
         }
+        data[index] = std::move(val);
     }
 
-    virtual void fixDown(size_t index) {
-        // if you're at a leaf node
-        if(index >= (data.size()/2)) {
-            return;
+    // Treats data[index] as a hole and fills it from the more extreme child
+    // at every level without comparing against any value being inserted.
+    // Returns the leaf position the hole ends up at.
+    size_t fixDownToLeaf(size_t index) {
+        if constexpr(BRANCHLESS) {
+            return fixDownToLeafBranchless(index);
         }
-        size_t largestIndex = index;
-        // check if the left child is bigger than the current node, update index if so
-        if(this->compare(data[index], data[(2*index) + 1])) {
-            largestIndex = (2*index) + 1;
+        size_t child = (2*index) + 1;
+        while(child + 1 < data.size()) {
+            if(this->compare(data[child], data[child + 1])) {
+                child++;
+            }
+            data[index] = std::move(data[child]);
+            index = child;
+            child = (2*index) + 1;
         }
-        // make sure right child exists, then do the same as above with current largest
-        if(((2*index) + 2) < data.size() && this->compare(data[largestIndex], data[(2*index) + 2])) {
-            largestIndex = (2*index) + 2;
+        // a lone left child at the bottom of the heap
+        if(child < data.size()) {
+            data[index] = std::move(data[child]);
+            index = child;
         }
-        // if a larger node was found, swap and fixDown next node, otherwise return
-        if(largestIndex == index) return;
-        else {
-            std::swap(data[index], data[largestIndex]);
-            fixDown(largestIndex);
+        return index;
+    }
+
+    // fixDown() for BRANCHLESS keys. Only the stop test branches; the last
+    // parent with a lone left child is handled after the loop, so the loop
+    // needs no check for a right child.
+    void fixDownBranchless(size_t index) {
+        TYPE *heap = data.data();
+        size_t size = data.size();
+        TYPE val = heap[index];
+        size_t child = (2*index) + 1;
+        while(child + 1 < size) {
+            child = moreExtremeChild(heap, child);
+            if(!this->compare(val, heap[child])) break;
+            heap[index] = heap[child];
+            index = child;
+            child = (2*index) + 1;
+        }
+        if(child + 1 == size && this->compare(val, heap[child])) {
+            heap[index] = heap[child];
+            index = child;
         }
+        heap[index] = val;
+    }
+
+    // fixDownToLeaf() for BRANCHLESS keys, unrolled to two levels per
+    // iteration while both levels are complete below the hole. Each level
+    // is a compare, an add and a move, with no branch but the loop's.
+    size_t fixDownToLeafBranchless(size_t index) {
+        TYPE *heap = data.data();
+        size_t size = data.size();
+        // the right child of either child of 'index' is at most 4*index + 6
+        while((4*index) + 6 < size) {
+            size_t child = moreExtremeChild(heap, (2*index) + 1);
+            heap[index] = heap[child];
+            size_t grandchild = moreExtremeChild(heap, (2*child) + 1);
+            heap[child] = heap[grandchild];
+            index = grandchild;
+        }
+        size_t child = (2*index) + 1;
+        while(child + 1 < size) {
+            child = moreExtremeChild(heap, child);
+            heap[index] = heap[child];
+            index = child;
+            child = (2*index) + 1;
+        }
+        if(child < size) {
+            heap[index] = heap[child];
+            index = child;
+        }
+        return index;
     }
 }; // BinaryPQ
 
 
+namespace pmr {
+    // BinaryPQ drawing its storage from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using BinaryPQ = ::BinaryPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
 #endif // BINARYPQ_H
@@ -0,0 +1,429 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef BITMAPPQ_H
+#define BITMAPPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A priority queue for elements whose priorities are a small range of
+// integer levels, 0 to levels() - 1, the higher level the more extreme.
+// Every level is a FIFO bucket, so elements of the same level pop in the
+// order they were pushed. Which levels are nonempty is kept in three tiers
+// of 64-bit words, each bit of a word in one tier saying whether a word in
+// the tier below has any bit set, so the highest nonempty level is found
+// with one count of leading zeros per tier. Push, pop and top are O(1),
+// whatever the number of elements.
+//
+// The level of an element comes from the comparator. An integral TYPE under
+// std::less or std::greater (typed or transparent) is its own level, or
+// levels() - 1 less it; any other comparator must have a member
+//     std::size_t level(const TYPE &val) const;
+// agreeing with its operator(): compare(a, b) exactly when level(a) is
+// less than level(b). push() throws std::out_of_range for an element whose
+// level is not below levels().
+//
+// Each level holds only the index of its newest element, whose 'next' is
+// the oldest, a circular list through the item pool. Items live in a pool
+// linked by 32-bit indices, as in SoftHeapPQ, using Allocator rebound to
+// its types.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class BitmapPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Index = std::uint32_t;
+    using Word = std::uint64_t;
+    static constexpr Index NIL = std::numeric_limits<Index>::max();
+    static constexpr std::size_t WORD_BITS = 64;
+
+    static constexpr bool LESS = std::is_same<COMP_FUNCTOR, std::less<TYPE>>::value
+        || std::is_same<COMP_FUNCTOR, std::less<>>::value;
+    static constexpr bool GREATER = std::is_same<COMP_FUNCTOR, std::greater<TYPE>>::value
+        || std::is_same<COMP_FUNCTOR, std::greater<>>::value;
+
+    template<typename C, typename = void>
+    struct HasLevel : std::false_type {};
+    template<typename C>
+    struct HasLevel<C, std::void_t<decltype(std::declval<const C&>().level(std::declval<const TYPE&>()))>>
+        : std::true_type {};
+
+    static_assert(HasLevel<COMP_FUNCTOR>::value || (std::is_integral<TYPE>::value && (LESS || GREATER)),
+                  "BitmapPQ needs integral keys under std::less or std::greater, "
+                  "or a comparator with a level() member");
+
+    // An element in its level's circular list; a free item is linked into
+    // the free list through 'next' as well.
+    struct Item {
+        TYPE elt;
+        Index next;
+    };
+
+    template<typename T>
+    using Vector = std::vector<T, ReboundAllocator<Allocator, T>>;
+
+public:
+    using allocator_type = Allocator;
+
+    static constexpr std::size_t DEFAULT_LEVELS = 65536;
+    static constexpr std::size_t MAX_LEVELS = WORD_BITS * WORD_BITS * WORD_BITS;
+
+    // Description: Construct an empty PQ of DEFAULT_LEVELS levels with an
+    //              optional comparison functor.
+    // Runtime: O(DEFAULT_LEVELS)
+    explicit BitmapPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                      const Allocator &alloc = Allocator()) :
+        BitmapPQ{ DEFAULT_LEVELS, comp, alloc } {
+    } // BitmapPQ()
+
+
+    // Description: Construct an empty PQ of DEFAULT_LEVELS levels that
+    //              allocates with 'alloc'.
+    // Runtime: O(DEFAULT_LEVELS)
+    explicit BitmapPQ(const Allocator &alloc) :
+        BitmapPQ{ DEFAULT_LEVELS, COMP_FUNCTOR(), alloc } {
+    } // BitmapPQ()
+
+
+    // Description: Construct an empty PQ of 'levels' levels, 0 < levels <=
+    //              MAX_LEVELS. Throws std::invalid_argument for any other
+    //              number.
+    // Runtime: O(levels)
+    explicit BitmapPQ(std::size_t levels, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                      const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, items(alloc), newest(alloc), tier0(alloc), tier1(alloc), tier2{ 0 },
+        freeItems{ NIL }, count{ 0 }, best{ 0 }, levelCount{ levels } {
+        if(levels == 0 || levels > MAX_LEVELS) {
+            throw std::invalid_argument("BitmapPQ needs 0 < levels <= MAX_LEVELS");
+        }
+        newest.resize(levels, NIL);
+        tier0.resize((levels + WORD_BITS - 1) / WORD_BITS, 0);
+        tier1.resize((tier0.size() + WORD_BITS - 1) / WORD_BITS, 0);
+    } // BitmapPQ()
+
+
+    // Description: Construct a PQ of DEFAULT_LEVELS levels out of an
+    //              iterator range with an optional comparison functor.
+    // Runtime: O(n + DEFAULT_LEVELS) where n is number of elements in range.
+    template<typename InputIterator>
+    BitmapPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             const Allocator &alloc = Allocator()) :
+        BitmapPQ{ start, end, DEFAULT_LEVELS, comp, alloc } {
+    } // BitmapPQ()
+
+
+    // Description: Construct a PQ of 'levels' levels out of an iterator
+    //              range.
+    // Runtime: O(n + levels) where n is number of elements in range.
+    template<typename InputIterator>
+    BitmapPQ(InputIterator start, InputIterator end, std::size_t levels,
+             COMP_FUNCTOR comp = COMP_FUNCTOR(), const Allocator &alloc = Allocator()) :
+        BitmapPQ{ levels, comp, alloc } {
+        while(start != end) {
+            push(*start);
+            start++;
+        }
+    } // BitmapPQ()
+
+
+    // Description: Destructor doesn't need any code, the pool releases every
+    //              item.
+    virtual ~BitmapPQ() {
+    } // ~BitmapPQ()
+
+
+    // Description: Assumes that all elements inside the PQ are out of order
+    //              and 'rebuilds' it, moving every element to its level as
+    //              of now. Elements that share a level keep their relative
+    //              order if they shared one before. Throws std::out_of_range,
+    //              leaving the PQ unchanged, if an element's level is no
+    //              longer below levels().
+    // Runtime: O(n + levels)
+    virtual void updatePriorities() {
+        Vector<Index> order(items.get_allocator());
+        order.reserve(count);
+        forEachItem([&order](Index item) { order.push_back(item); });
+        Vector<std::size_t> targets(items.get_allocator());
+        targets.reserve(count);
+        for(Index item : order) {
+            targets.push_back(levelOf(items[item].elt));
+        }
+        std::fill(newest.begin(), newest.end(), NIL);
+        std::fill(tier0.begin(), tier0.end(), 0);
+        std::fill(tier1.begin(), tier1.end(), 0);
+        tier2 = 0;
+        best = 0;
+        for(std::size_t i = 0; i < order.size(); ++i) {
+            link(order[i], targets[i]);
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the back of its level's bucket.
+    //              Throws std::out_of_range if its level is not below
+    //              levels().
+    // Runtime: O(1), amortized over growing the item pool.
+    virtual void push(const TYPE &val) {
+        std::size_t level = levelOf(val);
+        Index item;
+        if(freeItems != NIL) {
+            item = freeItems;
+            freeItems = items[item].next;
+            items[item].elt = val;
+        }
+        else {
+            if(items.size() == NIL) {
+                throw std::length_error("BitmapPQ holds at most 2^32 - 1 elements");
+            }
+            item = static_cast<Index>(items.size());
+            items.push_back(Item{ val, NIL });
+        }
+        link(item, level);
+        count++;
+    } // push()
+
+
+    // Description: Remove the oldest element of the highest nonempty level.
+    //              If that empties the level, the next one down is found
+    //              through the bitmaps.
+    // Runtime: O(1)
+    virtual void pop() {
+        Index last = newest[best];
+        Index first = items[last].next;
+        if(first == last) {
+            newest[best] = NIL;
+            clearBit(best);
+        }
+        else {
+            items[last].next = items[first].next;
+        }
+        items[first].next = freeItems;
+        freeItems = first;
+        count--;
+        if(count > 0) {
+            best = highestLevel();
+        }
+    } // pop()
+
+
+    // Description: Return the oldest element of the highest nonempty level.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return items[items[newest[best]].next].elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: The number of priority levels, given at construction.
+    // Runtime: O(1)
+    std::size_t levels() const {
+        return levelCount;
+    } // levels()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order.
+    // Runtime: O(k)
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            *out++ = std::move(items[items[newest[best]].next].elt);
+            BitmapPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: O(n)
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed. Each nonempty level's list
+    //              is relinked without its matches, in the same order, and
+    //              a level left empty has its bits cleared.
+    // Runtime: O(n + levels() / 64)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        std::size_t removed = 0;
+        for(std::size_t word0 = tier0.size(); word0-- > 0;) {
+            for(Word bits = tier0[word0]; bits != 0; bits &= ~(Word{ 1 } << highestBit(bits))) {
+                std::size_t level = word0 * WORD_BITS + highestBit(bits);
+                Index last = newest[level];
+                Index item = items[last].next;
+                Index keptFirst = NIL;
+                Index keptLast = NIL;
+                for(bool done = false; !done; ) {
+                    done = item == last;
+                    Index next = items[item].next;
+                    if(pred(static_cast<const TYPE&>(items[item].elt))) {
+                        items[item].next = freeItems;
+                        freeItems = item;
+                        removed++;
+                    }
+                    else {
+                        (keptLast == NIL ? keptFirst : items[keptLast].next) = item;
+                        keptLast = item;
+                    }
+                    item = next;
+                }
+                if(keptLast == NIL) {
+                    newest[level] = NIL;
+                    clearBit(level);
+                }
+                else {
+                    items[keptLast].next = keptFirst;
+                    newest[level] = keptLast;
+                }
+            }
+        }
+        count -= removed;
+        if(count > 0) {
+            best = highestLevel();
+        }
+        return removed;
+    } // remove_if()
+
+
+    // Description: The allocator the item pool and bitmaps use.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(items.get_allocator());
+    } // get_allocator()
+
+
+private:
+    static std::size_t highestBit(Word word) {
+        return WORD_BITS - 1 - static_cast<std::size_t>(__builtin_clzll(word));
+    }
+
+    std::size_t levelOf(const TYPE &val) const {
+        if constexpr(HasLevel<COMP_FUNCTOR>::value) {
+            std::size_t level = this->compare.level(val);
+            if(level >= levelCount) {
+                throw std::out_of_range("BitmapPQ element level out of range");
+            }
+            return level;
+        }
+        else {
+            if constexpr(std::is_signed<TYPE>::value) {
+                if(val < 0) {
+                    throw std::out_of_range("BitmapPQ element level out of range");
+                }
+            }
+            if(static_cast<std::make_unsigned_t<TYPE>>(val) >= levelCount) {
+                throw std::out_of_range("BitmapPQ element level out of range");
+            }
+            std::size_t level = static_cast<std::size_t>(val);
+            return LESS ? level : levelCount - 1 - level;
+        }
+    }
+
+    // The highest level with its bit set; there must be one.
+    std::size_t highestLevel() const {
+        std::size_t word1 = highestBit(tier2);
+        std::size_t word0 = word1 * WORD_BITS + highestBit(tier1[word1]);
+        return word0 * WORD_BITS + highestBit(tier0[word0]);
+    }
+
+    // Adds 'item' to the back of 'level', whose bucket may be empty.
+    void link(Index item, std::size_t level) {
+        Index last = newest[level];
+        if(last == NIL) {
+            items[item].next = item;
+            std::size_t word0 = level / WORD_BITS;
+            std::size_t word1 = word0 / WORD_BITS;
+            tier0[word0] |= Word{ 1 } << (level % WORD_BITS);
+            tier1[word1] |= Word{ 1 } << (word0 % WORD_BITS);
+            tier2 |= Word{ 1 } << word1;
+        }
+        else {
+            items[item].next = items[last].next;
+            items[last].next = item;
+        }
+        newest[level] = item;
+        if(count == 0 || level > best) {
+            best = level;
+        }
+    }
+
+    // Clears the bit of 'level', and of its words that become empty.
+    void clearBit(std::size_t level) {
+        std::size_t word0 = level / WORD_BITS;
+        std::size_t word1 = word0 / WORD_BITS;
+        tier0[word0] &= ~(Word{ 1 } << (level % WORD_BITS));
+        if(tier0[word0] == 0) {
+            tier1[word1] &= ~(Word{ 1 } << (word0 % WORD_BITS));
+            if(tier1[word1] == 0) {
+                tier2 &= ~(Word{ 1 } << word1);
+            }
+        }
+    }
+
+    // Calls visit(item) for every item held, highest level first and
+    // oldest first within a level.
+    template<typename Visit>
+    void forEachItem(Visit visit) const {
+        for(std::size_t word0 = tier0.size(); word0-- > 0;) {
+            for(Word bits = tier0[word0]; bits != 0; bits &= ~(Word{ 1 } << highestBit(bits))) {
+                Index last = newest[word0 * WORD_BITS + highestBit(bits)];
+                Index item = last;
+                do {
+                    item = items[item].next;
+                    visit(item);
+                } while(item != last);
+            }
+        }
+    }
+
+    Vector<Item> items;
+    // The newest item of each level, or NIL.
+    Vector<Index> newest;
+    // Bit l of tier0 is set when level l is nonempty; bit w of tier1 when
+    // tier0 word w is nonzero; bit w of tier2 when tier1 word w is.
+    Vector<Word> tier0;
+    Vector<Word> tier1;
+    Word tier2;
+    Index freeItems;
+    std::size_t count;
+    // The highest nonempty level, while count > 0.
+    std::size_t best;
+    std::size_t levelCount;
+}; // BitmapPQ
+
+
+namespace pmr {
+    // BitmapPQ drawing its pool and bitmaps from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using BitmapPQ = ::BitmapPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // BITMAPPQ_H
@@ -0,0 +1,545 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef BOUNDEDPAIRINGPQ_H
+#define BOUNDEDPAIRINGPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// A pairing heap variant for latency-sensitive callers: the same Node and
+// addNode()/updateElt()/erase() interface as PairingPQ, with a worst-case
+// instead of an amortized bound on pop().
+//
+// After n pushes PairingPQ's root can have n children, and the next pop()
+// pairs all of them in one O(n) pause. Here the pairing is done during the
+// pushes instead. The heap is a forest whose roots are kept in a table by
+// rank (number of children), at most two per rank, and a root arriving at a
+// full rank is linked with one already there and carried to the next rank,
+// as in a binary counter. top() is a cached pointer to the best root. A node
+// whose priority passes its parent's is cut out with Fibonacci-heap
+// cascading cuts, so a tree of rank k always holds at least F(k+2) nodes and
+// no rank exceeds R = log_phi(n) < 1.45 log2(n) + 1.
+//
+// Worst-case work per operation, counted in links and comparisons:
+//   push(), addNode()     at most R + 1 links, O(1) amortized
+//   top()                 O(1)
+//   pop()                 at most 3R + 2 links and 2(R + 1) comparisons
+//   updateElt(), erase()  as pop() for every cascading cut; cascades are
+//                         O(1) amortized but only bounded by the node's depth
+// maxRank() reports R for the current heap. Only push() allocates: the
+// root table lives inside the heap, and pop() moves no element.
+//
+// Nodes, and the node stack used to copy a heap, come from Allocator rebound
+// to those types.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class BoundedPairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Each node within the heap
+    class Node {
+        public:
+            explicit Node(const TYPE &val)
+                : elt{ val }, parent{ nullptr }, child{ nullptr }, left{ nullptr },
+                  right{ nullptr }, rank{ 0 }, marked{ false }
+            {}
+
+            // Description: Allows access to the element at that Node's
+            //              position.
+            // Runtime: O(1)
+            const TYPE &getElt() const { return elt; }
+            const TYPE &operator*() const { return elt; }
+
+            friend BoundedPairingPQ;
+
+        private:
+            TYPE elt;
+            // nullptr exactly when the node is a root.
+            Node *parent;
+            Node *child;
+            // Siblings, in a doubly-linked child list; nullptr at its ends.
+            Node *left;
+            Node *right;
+            // The number of children.
+            std::uint32_t rank;
+            // Set when a non-root node loses a child; a second loss cuts it.
+            bool marked;
+    }; // Node
+
+    // No tree can reach this rank: it would need F(RANKS + 2) > 2^64 nodes.
+    static constexpr std::size_t RANKS = 96;
+
+private:
+    using NodeAlloc = ReboundAllocator<Allocator, Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+    using NodeList = std::vector<Node*, ReboundAllocator<Allocator, Node*>>;
+
+public:
+    // Description: Construct an empty heap with an optional comparison
+    //              functor.
+    // Runtime: O(1)
+    explicit BoundedPairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                              const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, slots{}, best{ nullptr }, used{ 0 }, count{ 0 }, nodeAlloc{ alloc } {
+    } // BoundedPairingPQ()
+
+
+    // Description: Construct an empty heap that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit BoundedPairingPQ(const Allocator &alloc) :
+        BoundedPairingPQ{ COMP_FUNCTOR(), alloc } {
+    } // BoundedPairingPQ()
+
+
+    // Description: Construct a heap out of an iterator range with an
+    //              optional comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    BoundedPairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                     const Allocator &alloc = Allocator()) :
+        BoundedPairingPQ{ comp, alloc } {
+        while(start != end) {
+            addNode(*start);
+            start++;
+        }
+    } // BoundedPairingPQ()
+
+
+    // Description: Copy constructor.
+    // Runtime: O(n)
+    BoundedPairingPQ(const BoundedPairingPQ &other) :
+        BoundedPairingPQ{ other, NodeTraits::select_on_container_copy_construction(other.nodeAlloc) } {
+    } // BoundedPairingPQ()
+
+
+    // Description: Copy constructor that allocates with 'alloc'.
+    // Runtime: O(n)
+    BoundedPairingPQ(const BoundedPairingPQ &other, const Allocator &alloc) :
+        BoundedPairingPQ{ other.compare, alloc } {
+        NodeList stack(nodeAlloc);
+        for(std::size_t k = 0; k < other.used; ++k) {
+            for(Node* root : other.slots[k]) {
+                if(root != nullptr) { stack.push_back(root); }
+            }
+        }
+        while(!stack.empty()) {
+            Node* current = stack.back(); stack.pop_back();
+            for(Node* child = current->child; child != nullptr; child = child->right) {
+                stack.push_back(child);
+            }
+            addNode(current->elt);
+        }
+    } // BoundedPairingPQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    BoundedPairingPQ &operator=(const BoundedPairingPQ &rhs) {
+        // built with this heap's allocator, so the nodes can be swapped in
+        BoundedPairingPQ temp(rhs, get_allocator());
+
+        std::swap(slots, temp.slots);
+        std::swap(best, temp.best);
+        std::swap(used, temp.used);
+        std::swap(count, temp.count);
+
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor
+    // Runtime: O(n)
+    virtual ~BoundedPairingPQ() {
+        Node* list = collect();
+        while(list != nullptr) {
+            Node* next = list->right;
+            destroyNode(list);
+            list = next;
+        }
+    } // ~BoundedPairingPQ()
+
+
+    // Description: Assumes that all elements inside the heap are out of
+    //              order and rebuilds it from the same nodes, as if each
+    //              had just been pushed.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        Node* list = collect();
+        while(list != nullptr) {
+            Node* next = list->right;
+            list->parent = list->child = list->left = list->right = nullptr;
+            list->rank = 0;
+            list->marked = false;
+            addRoot(list);
+            list = next;
+        }
+        findBest();
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the heap.
+    // Runtime: O(log(n)), O(1) amortized
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the heap. The root's children join the root table,
+    //              carrying like pushes, and the table is scanned for the
+    //              new top.
+    // Runtime: O(log(n)) worst case
+    virtual void pop() {
+        Node* old = best;
+        removeRoot(old, old->rank);
+        promoteChildren(old);
+        destroyNode(old);
+        count--;
+        findBest();
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return best->elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order.
+    // Runtime: O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            *out++ = std::move(best->elt);
+            BoundedPairingPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: Updates the priority of an element already in the heap by
+    //              replacing the element refered to by the Node with
+    //              new_value. A node that passes its parent is cut out and
+    //              joins the root table.
+    //
+    // PRECONDITION: The new priority, given by 'new_value' must be more
+    //               extreme (as defined by comp) than the old priority.
+    //
+    // Runtime: O(log(n)) per cascading cut, O(log(n)) amortized
+    void updateElt(Node* node, const TYPE &new_value) {
+        if(node == nullptr) { return; }
+        node->elt = new_value;
+        if(node->parent == nullptr) {
+            if(this->compare(best->elt, new_value)) { best = node; }
+        }
+        else if(this->compare(node->parent->elt, new_value)) {
+            cut(node);
+            settle(node);
+        }
+    } // updateElt()
+
+
+    // Description: Removes the element refered to by 'node' from the heap
+    //              and deletes the node. Its children join the root table.
+    // Runtime: O(log(n)) per cascading cut, O(log(n)) amortized
+    void erase(Node* node) {
+        bool wasTop = node == best;
+        if(node->parent == nullptr) {
+            removeRoot(node, node->rank);
+        }
+        else {
+            cut(node);
+        }
+        promoteChildren(node);
+        destroyNode(node);
+        count--;
+        if(wasTop) { findBest(); }
+    } // erase()
+
+
+    // Description: Removes every element for which 'pred' returns true,
+    //              deleting its node, and returns how many were removed.
+    //              As in updatePriorities(), the kept nodes are filed again
+    //              as if each had just been pushed, and their handles stay
+    //              valid.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        Node* list = collect();
+        std::size_t removed = 0;
+        while(list != nullptr) {
+            Node* next = list->right;
+            if(pred(static_cast<const TYPE&>(list->elt))) {
+                destroyNode(list);
+                removed++;
+            }
+            else {
+                list->parent = list->child = list->left = list->right = nullptr;
+                list->rank = 0;
+                list->marked = false;
+                addRoot(list);
+            }
+            list = next;
+        }
+        findBest();
+        count -= removed;
+        return removed;
+    } // remove_if()
+
+
+    // Description: Add a new element to the heap. Returns a Node*
+    //              corresponding to the newly added element, which stays
+    //              valid until the element is popped or erased.
+    // Runtime: O(log(n)), O(1) amortized
+    Node* addNode(const TYPE &val) {
+        Node* node = makeNode(val);
+        settle(node);
+        count++;
+        return node;
+    } // addNode()
+
+
+    // Description: The highest rank of any tree, R in the bounds above.
+    // Runtime: O(log(n))
+    std::size_t maxRank() const {
+        for(std::size_t k = used; k > 0; --k) {
+            if(slots[k - 1][0] != nullptr) { return k - 1; }
+        }
+        return 0;
+    } // maxRank()
+
+
+    // Description: The allocator the heap was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(nodeAlloc);
+    } // get_allocator()
+
+
+private:
+    Node* makeNode(const TYPE &val) {
+        Node* node = NodeTraits::allocate(nodeAlloc, 1);
+        try {
+            NodeTraits::construct(nodeAlloc, node, val);
+        }
+        catch(...) {
+            NodeTraits::deallocate(nodeAlloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroyNode(Node* node) {
+        NodeTraits::destroy(nodeAlloc, node);
+        NodeTraits::deallocate(nodeAlloc, node, 1);
+    }
+
+    // Makes the less extreme of two roots of equal rank the first child of
+    // the other, and returns the other.
+    Node* link(Node* a, Node* b) {
+        if(this->compare(a->elt, b->elt)) {
+            std::swap(a, b);
+        }
+        b->parent = a;
+        b->left = nullptr;
+        b->right = a->child;
+        b->marked = false;
+        if(a->child != nullptr) {
+            a->child->left = b;
+        }
+        a->child = b;
+        a->rank++;
+        // a tie can bury the cached top under an equal root
+        if(best == b) { best = a; }
+        return a;
+    }
+
+    // Files a detached tree under its rank, linking and carrying while the
+    // rank already holds two roots. Returns the root it ends up under.
+    Node* addRoot(Node* node) {
+        while(slots[node->rank][1] != nullptr) {
+            Node* other = slots[node->rank][1];
+            slots[node->rank][1] = nullptr;
+            node = link(node, other);
+        }
+        std::array<Node*, 2> &slot = slots[node->rank];
+        (slot[0] == nullptr ? slot[0] : slot[1]) = node;
+        used = std::max(used, std::size_t{ node->rank } + 1);
+        return node;
+    }
+
+    // addRoot(), keeping the cached top current.
+    void settle(Node* node) {
+        Node* root = addRoot(node);
+        if(best == nullptr || this->compare(best->elt, root->elt)) {
+            best = root;
+        }
+    }
+
+    // Takes a root out of the table, where it is filed under 'rank'.
+    void removeRoot(Node* root, std::size_t rank) {
+        std::array<Node*, 2> &slot = slots[rank];
+        if(slot[0] == root) { slot[0] = slot[1]; }
+        slot[1] = nullptr;
+    }
+
+    // Detaches each of node's children and files it as a root.
+    void promoteChildren(Node* node) {
+        Node* child = node->child;
+        while(child != nullptr) {
+            Node* next = child->right;
+            child->parent = child->left = child->right = nullptr;
+            child->marked = false;
+            addRoot(child);
+            child = next;
+        }
+        node->child = nullptr;
+        node->rank = 0;
+    }
+
+    // Scans the table for the top, trimming 'used' on the way.
+    void findBest() {
+        best = nullptr;
+        std::size_t top = 0;
+        for(std::size_t k = 0; k < used; ++k) {
+            for(Node* root : slots[k]) {
+                if(root == nullptr) { continue; }
+                top = k + 1;
+                if(best == nullptr || this->compare(best->elt, root->elt)) {
+                    best = root;
+                }
+            }
+        }
+        used = top;
+    }
+
+    // Unlinks a non-root node from its parent's child list and returns the
+    // parent, whose rank drops by one.
+    Node* unlink(Node* node) {
+        Node* parent = node->parent;
+        if(node->left != nullptr) {
+            node->left->right = node->right;
+        }
+        else {
+            parent->child = node->right;
+        }
+        if(node->right != nullptr) {
+            node->right->left = node->left;
+        }
+        node->parent = node->left = node->right = nullptr;
+        node->marked = false;
+        parent->rank--;
+        return parent;
+    }
+
+    // Cuts a non-root node out, leaving it detached for the caller. A marked
+    // ancestor losing its second child is cut too, and filed as a root once
+    // the root that lost a child, if any, has moved down a rank; otherwise
+    // the first unmarked ancestor is marked.
+    void cut(Node* node) {
+        Node* parent = unlink(node);
+        Node* cascaded = nullptr;
+        while(parent->parent != nullptr && parent->marked) {
+            Node* grand = unlink(parent);
+            parent->right = cascaded;
+            cascaded = parent;
+            parent = grand;
+        }
+        if(parent->parent == nullptr) {
+            removeRoot(parent, std::size_t{ parent->rank } + 1);
+            settle(parent);
+        }
+        else {
+            parent->marked = true;
+        }
+        while(cascaded != nullptr) {
+            Node* next = cascaded->right;
+            cascaded->right = nullptr;
+            settle(cascaded);
+            cascaded = next;
+        }
+    }
+
+    // Empties the heap, threading every node onto one list through 'right'.
+    // The nodes' other links are left stale.
+    Node* collect() {
+        Node* pending = nullptr;
+        for(std::size_t k = 0; k < used; ++k) {
+            for(Node* &root : slots[k]) {
+                if(root == nullptr) { continue; }
+                root->right = pending;
+                pending = root;
+                root = nullptr;
+            }
+        }
+        Node* list = nullptr;
+        while(pending != nullptr) {
+            Node* node = pending;
+            pending = node->right;
+            Node* child = node->child;
+            while(child != nullptr) {
+                Node* next = child->right;
+                child->right = pending;
+                pending = child;
+                child = next;
+            }
+            node->right = list;
+            list = node;
+        }
+        best = nullptr;
+        used = 0;
+        return list;
+    }
+
+    // Roots by rank, at most two per rank, filled from index 0.
+    std::array<std::array<Node*, 2>, RANKS> slots;
+    Node* best;
+    // One past the highest rank that may hold a root.
+    std::size_t used;
+    std::size_t count;
+    NodeAlloc nodeAlloc;
+}; // BoundedPairingPQ
+
+
+namespace pmr {
+    // BoundedPairingPQ drawing its nodes from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using BoundedPairingPQ = ::BoundedPairingPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // BOUNDEDPAIRINGPQ_H
@@ -0,0 +1,423 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef COMPACTPAIRINGPQ_H
+#define COMPACTPAIRINGPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// A pairing heap with the same structure as PairingPQ, whose nodes live in
+// one pool and link to each other by 32-bit indices instead of pointers. An
+// int node takes 16 bytes here against 32 bytes plus a separate allocation
+// in PairingPQ; nodes freed by pop() are reused by later pushes.
+//
+// Handles returned by addNode() are pool indices, so they survive the pool
+// growing and copying the PQ (a handle is valid for the copy as well), and
+// are used with getElt() and updateElt(). At most 2^32 - 1 elements can be
+// held at once. The pool and the scratch stack of updatePriorities() use
+// Allocator rebound to their types.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class CompactPairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Index = std::uint32_t;
+    static constexpr Index NIL = std::numeric_limits<Index>::max();
+
+    // Leftmost-child/right-sibling links. 'prev' is the parent for a first
+    // child and the left sibling otherwise, NIL only for the root; a free
+    // node is linked into the free list through 'sibling'.
+    struct Node {
+        TYPE elt;
+        Index child;
+        Index sibling;
+        Index prev;
+    };
+
+    template<typename T>
+    using Vector = std::vector<T, ReboundAllocator<Allocator, T>>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Refers to an element from addNode() until it is popped.
+    class Handle {
+        public:
+            Handle() : index{ NIL } {}
+
+            bool operator==(const Handle &other) const { return index == other.index; }
+            bool operator!=(const Handle &other) const { return index != other.index; }
+
+        private:
+            friend class CompactPairingPQ;
+            explicit Handle(Index i) : index{ i } {}
+
+            Index index;
+    }; // Handle
+
+
+    // Description: Construct an empty pairing heap with an optional
+    //              comparison functor.
+    // Runtime: O(1)
+    explicit CompactPairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                              const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, pool(alloc), root{ NIL }, freeList{ NIL }, count{ 0 } {
+    } // CompactPairingPQ()
+
+
+    // Description: Construct an empty pairing heap that allocates with
+    //              'alloc'.
+    // Runtime: O(1)
+    explicit CompactPairingPQ(const Allocator &alloc) :
+        CompactPairingPQ{ COMP_FUNCTOR(), alloc } {
+    } // CompactPairingPQ()
+
+
+    // Description: Construct a pairing heap out of an iterator range with an
+    //              optional comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    CompactPairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                     const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, pool(alloc), root{ NIL }, freeList{ NIL }, count{ 0 } {
+        while(start != end) {
+            addNode(*start);
+            start++;
+        }
+    } // CompactPairingPQ()
+
+
+    // Description: Destructor doesn't need any code, the pool releases every
+    //              node.
+    virtual ~CompactPairingPQ() {
+    } // ~CompactPairingPQ()
+
+
+    // Description: Assumes that all elements inside the pairing heap are out
+    //              of order and 'rebuilds' it. Nodes keep their indices, so
+    //              every handle stays valid.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        if(root == NIL) { return; }
+        Vector<Index> stack(pool.get_allocator());
+        stack.push_back(root);
+        root = NIL;
+        while(!stack.empty()) {
+            Index current = stack.back(); stack.pop_back();
+            Node &node = pool[current];
+            if(node.child != NIL) { stack.push_back(node.child); }
+            if(node.sibling != NIL) { stack.push_back(node.sibling); }
+            node.child = NIL; node.sibling = NIL; node.prev = NIL;
+            root = root == NIL ? current : meld(root, current);
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the pairing heap.
+    // Runtime: Amortized O(1)
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the pairing heap. The root's slot goes onto the free
+    //              list.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        Index old = root;
+        root = mergePairs(pool[old].child);
+        release(old);
+        count--;
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the pairing heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return pool[root].elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the pairing heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+
+    // Description: Return true if the pairing heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order.
+    // Runtime: Amortized O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            *out++ = std::move(pool[root].elt);
+            CompactPairingPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: Amortized O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: Add a new element to the pairing heap, returning a handle
+    //              to it.
+    // Runtime: Amortized O(1)
+    Handle addNode(const TYPE &val) {
+        Index added = acquire(val);
+        root = root == NIL ? added : meld(root, added);
+        count++;
+        return Handle{ added };
+    } // addNode()
+
+
+    // Description: The element a handle refers to.
+    // Runtime: O(1)
+    const TYPE &getElt(Handle handle) const {
+        return pool[handle.index].elt;
+    } // getElt()
+
+
+    // Description: Updates the priority of the element refered to by
+    //              'handle' to new_value, cutting its node out of its
+    //              sibling list and melding it with the root.
+    //
+    // PRECONDITION: The new priority, given by 'new_value' must be more
+    //               extreme (as defined by comp) than the old priority.
+    //
+    // Runtime: O(1)
+    void updateElt(Handle handle, const TYPE &new_value) {
+        Index index = handle.index;
+        pool[index].elt = new_value;
+        Index prev = pool[index].prev;
+        // nothing to do for the root, or for a first child whose parent is
+        // still at least as extreme
+        if(prev == NIL || (pool[prev].child == index && !this->compare(pool[prev].elt, new_value))) {
+            return;
+        }
+        cut(index);
+        root = meld(root, index);
+    } // updateElt()
+
+
+    // Description: Removes the element refered to by 'handle' from the
+    //              pairing heap, as PairingPQ::erase() does.
+    // Runtime: Amortized O(log(n))
+    void erase(Handle handle) {
+        Index index = handle.index;
+        if(index == root) {
+            CompactPairingPQ::pop();
+            return;
+        }
+        cut(index);
+        Index rest = mergePairs(pool[index].child);
+        release(index);
+        if(rest != NIL) {
+            root = meld(root, rest);
+        }
+        count--;
+    } // erase()
+
+
+    // Description: Removes every element for which 'pred' returns true and
+    //              returns how many were removed, as PairingPQ::remove_if()
+    //              does. The removed slots go onto the free list, and
+    //              handles to kept elements stay valid.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        if(root == NIL) { return 0; }
+        // subtrees cut loose and not yet filtered, and kept nodes whose
+        // children are still to be filtered
+        Vector<Index> loose(pool.get_allocator());
+        Vector<Index> kept(pool.get_allocator());
+        Index survivors = NIL;
+        std::size_t removed = 0;
+        loose.push_back(root);
+        while(!loose.empty()) {
+            Index index = loose.back(); loose.pop_back();
+            if(pred(static_cast<const TYPE&>(pool[index].elt))) {
+                loosen(index, loose);
+                removed++;
+                continue;
+            }
+            pool[index].sibling = survivors;
+            survivors = index;
+            kept.push_back(index);
+            while(!kept.empty()) {
+                Index parent = kept.back(); kept.pop_back();
+                for(Index child = pool[parent].child; child != NIL; ) {
+                    Index next = pool[child].sibling;
+                    if(pred(static_cast<const TYPE&>(pool[child].elt))) {
+                        cut(child);
+                        loosen(child, loose);
+                        removed++;
+                    }
+                    else {
+                        kept.push_back(child);
+                    }
+                    child = next;
+                }
+            }
+        }
+        root = mergePairs(survivors);
+        count -= removed;
+        return removed;
+    } // remove_if()
+
+
+    // Description: Bytes of pool storage per element slot.
+    // Runtime: O(1)
+    static constexpr std::size_t nodeBytes() {
+        return sizeof(Node);
+    } // nodeBytes()
+
+
+    // Description: The allocator the pairing heap was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(pool.get_allocator());
+    } // get_allocator()
+
+
+private:
+    Index acquire(const TYPE &val) {
+        if(freeList != NIL) {
+            Index index = freeList;
+            freeList = pool[index].sibling;
+            pool[index] = Node{ val, NIL, NIL, NIL };
+            return index;
+        }
+        if(pool.size() >= NIL) {
+            throw std::length_error("CompactPairingPQ holds at most 2^32 - 1 elements");
+        }
+        pool.push_back(Node{ val, NIL, NIL, NIL });
+        return static_cast<Index>(pool.size() - 1);
+    }
+
+    void release(Index index) {
+        pool[index].sibling = freeList;
+        freeList = index;
+    }
+
+    // Frees a detached node, adding each of its children to 'loose' as a
+    // subtree of its own.
+    void loosen(Index index, Vector<Index> &loose) {
+        Index child = pool[index].child;
+        while(child != NIL) {
+            Index next = pool[child].sibling;
+            pool[child].sibling = NIL;
+            pool[child].prev = NIL;
+            loose.push_back(child);
+            child = next;
+        }
+        release(index);
+    }
+
+    // Two-pass pairing of a sibling list, done in place as in PairingPQ.
+    Index mergePairs(Index first) {
+        Index pairs = NIL;
+        while(first != NIL) {
+            Index a = first;
+            Index b = pool[a].sibling;
+            pool[a].prev = NIL;
+            if(b == NIL) {
+                pool[a].sibling = pairs;
+                pairs = a;
+                break;
+            }
+            first = pool[b].sibling;
+            pool[a].sibling = NIL;
+            pool[b].sibling = NIL;
+            pool[b].prev = NIL;
+            Index melded = meld(a, b);
+            pool[melded].sibling = pairs;
+            pairs = melded;
+        }
+
+        if(pairs == NIL) { return NIL; }
+        Index result = pairs;
+        pairs = pool[pairs].sibling;
+        pool[result].sibling = NIL;
+        while(pairs != NIL) {
+            Index next = pool[pairs].sibling;
+            pool[pairs].sibling = NIL;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        return result;
+    }
+
+    // Unlinks a non-root node, together with its subtree, from its parent's
+    // child list.
+    void cut(Index index) {
+        Node &node = pool[index];
+        Node &prev = pool[node.prev];
+        if(prev.child == index) {
+            prev.child = node.sibling;
+        }
+        else {
+            prev.sibling = node.sibling;
+        }
+        if(node.sibling != NIL) {
+            pool[node.sibling].prev = node.prev;
+        }
+        node.sibling = NIL;
+        node.prev = NIL;
+    }
+
+    // Melds two roots, returning the new root.
+    Index meld(Index a, Index b) {
+        if(this->compare(pool[a].elt, pool[b].elt)) {
+            std::swap(a, b);
+        }
+        Node &winner = pool[a];
+        Node &loser = pool[b];
+        loser.sibling = winner.child;
+        if(winner.child != NIL) {
+            pool[winner.child].prev = b;
+        }
+        loser.prev = a;
+        winner.child = b;
+        return a;
+    }
+
+    Vector<Node> pool;
+    Index root;
+    Index freeList;
+    std::size_t count;
+}; // CompactPairingPQ
+
+
+namespace pmr {
+    // CompactPairingPQ drawing its pool from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using CompactPairingPQ =
+        ::CompactPairingPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // COMPACTPAIRINGPQ_H
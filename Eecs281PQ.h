@@ -5,6 +5,7 @@
 
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <vector>
 
 // A simple interface that implements a generic priority queue.
@@ -41,6 +42,55 @@ public:
     //              implement this appropriately.
     virtual void updatePriorities() = 0;
 
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order, and return the advanced
+    //              iterator. This generic version goes through top() and
+    //              pop(); each derived PQ hides it with one suited to its
+    //              structure, which is used whenever the call is made
+    //              through the derived type.
+    // Runtime: k calls to top() and pop()
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(; k > 0 && !empty(); --k) {
+            *out++ = top();
+            pop();
+        }
+        return out;
+    }
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order, and return the advanced iterator.
+    // Runtime: size() calls to top() and pop()
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(size(), out);
+    }
+
+    // Description: Remove every element for which 'pred' returns true, and
+    //              return how many were removed. This generic version pops
+    //              every element and pushes back the ones it keeps; each
+    //              derived PQ hides it with one pass over its storage and a
+    //              single restructure.
+    // Runtime: size() calls to top() and pop(), and a push() per element
+    //          kept
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        std::vector<TYPE> kept;
+        std::size_t removed = 0;
+        for(; !empty(); pop()) {
+            if(pred(top())) {
+                ++removed;
+            }
+            else {
+                kept.push_back(top());
+            }
+        }
+        for(const TYPE &val : kept) {
+            push(val);
+        }
+        return removed;
+    }
+
 protected:
     Eecs281PQ() {}
     explicit Eecs281PQ(const COMP_FUNCTOR &comp) : compare{ comp } {}
@@ -56,4 +106,11 @@ protected:
 }; // Eecs281PQ
 
 
+// Every PQ takes an Allocator of its elements as its last template
+// parameter and uses it, rebound with this, for everything else it stores:
+// nodes, handle tables, and scratch containers.
+template<typename Allocator, typename T>
+using ReboundAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+
 #endif
@@ -0,0 +1,314 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef INDEXEDBINARYPQ_H
+#define INDEXEDBINARYPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// A binary heap that tracks the position of every element, so addNode()
+// can hand out handles that updateElt() and erase() use later. Each heap
+// entry carries the id of its handle, and 'position' maps ids back to heap
+// indices; every move in a sift updates both. Ids of popped or erased
+// elements are reused by later pushes. Both vectors use Allocator rebound
+// to their element types.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class IndexedBinaryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    struct Entry {
+        TYPE elt;
+        std::size_t id;
+    };
+
+    template<typename T>
+    using Vector = std::vector<T, ReboundAllocator<Allocator, T>>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Refers to an element from addNode() until it is popped or erased.
+    class Handle {
+        public:
+            Handle() : id{ NONE } {}
+
+            bool operator==(const Handle &other) const { return id == other.id; }
+            bool operator!=(const Handle &other) const { return id != other.id; }
+
+        private:
+            friend class IndexedBinaryPQ;
+            explicit Handle(std::size_t i) : id{ i } {}
+
+            std::size_t id;
+    }; // Handle
+
+
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit IndexedBinaryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                             const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data(alloc), position(alloc), freeIds{ NONE } {
+    } // IndexedBinaryPQ()
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit IndexedBinaryPQ(const Allocator &alloc) :
+        IndexedBinaryPQ{ COMP_FUNCTOR(), alloc } {
+    } // IndexedBinaryPQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    IndexedBinaryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                    const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data(alloc), position(alloc), freeIds{ NONE } {
+        while(start != end) {
+            std::size_t id = acquireId();
+            position[id] = data.size();
+            data.push_back(Entry{ *start, id });
+            start++;
+        }
+        updatePriorities();
+    } // IndexedBinaryPQ()
+
+
+    // Description: Destructor doesn't need any code, the vectors will be
+    //              destroyed automatically.
+    virtual ~IndexedBinaryPQ() {
+    } // ~IndexedBinaryPQ()
+
+
+    // Description: Assumes that all elements inside the heap are out of
+    //              order and 'rebuilds' the heap. Handles stay valid.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        for(std::size_t i = data.size()/2; i > 0; i--) {
+            fixDown(i - 1);
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: O(log(n))
+    virtual void pop() {
+        removeAt(0);
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return data.front().elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return data.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return data.empty();
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order.
+    // Runtime: O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, data.size()); k > 0; --k) {
+            *out++ = std::move(data.front().elt);
+            removeAt(0);
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(data.size(), out);
+    } // drain()
+
+
+    // Description: Add a new element to the PQ, returning a handle to it.
+    // Runtime: O(log(n))
+    Handle addNode(const TYPE &val) {
+        std::size_t id = acquireId();
+        position[id] = data.size();
+        data.push_back(Entry{ val, id });
+        fixUp(data.size() - 1);
+        return Handle{ id };
+    } // addNode()
+
+
+    // Description: The element a handle refers to.
+    // Runtime: O(1)
+    const TYPE &getElt(Handle handle) const {
+        return data[position[handle.id]].elt;
+    } // getElt()
+
+
+    // Description: Replaces the element refered to by 'handle' with
+    //              new_value, which may be more or less extreme than the
+    //              old one, and restores the heap.
+    // Runtime: O(log(n))
+    void updateElt(Handle handle, const TYPE &new_value) {
+        std::size_t index = position[handle.id];
+        data[index].elt = new_value;
+        fixUp(index);
+        fixDown(position[handle.id]);
+    } // updateElt()
+
+
+    // Description: Removes the element refered to by 'handle' from the PQ.
+    //              The last element takes its place and is sifted up or
+    //              down from there.
+    // Runtime: O(log(n))
+    void erase(Handle handle) {
+        removeAt(position[handle.id]);
+    } // erase()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed. Survivors are compacted in
+    //              place with their positions updated, the removed ids are
+    //              freed, and the heap is rebuilt once. Handles to the
+    //              survivors stay valid.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        std::size_t kept = 0;
+        for(std::size_t i = 0; i < data.size(); ++i) {
+            if(pred(static_cast<const TYPE&>(data[i].elt))) {
+                releaseId(data[i].id);
+            }
+            else if(kept++ != i) {
+                place(kept - 1, std::move(data[i]));
+            }
+        }
+        std::size_t removed = data.size() - kept;
+        if(removed > 0) {
+            data.erase(data.begin() + static_cast<std::ptrdiff_t>(kept), data.end());
+            IndexedBinaryPQ::updatePriorities();
+        }
+        return removed;
+    } // remove_if()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(data.get_allocator());
+    } // get_allocator()
+
+
+private:
+    static constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+
+    Vector<Entry> data;
+    // Heap index of each live id; a free id holds the next free id.
+    Vector<std::size_t> position;
+    std::size_t freeIds;
+
+    std::size_t acquireId() {
+        if(freeIds != NONE) {
+            std::size_t id = freeIds;
+            freeIds = position[id];
+            return id;
+        }
+        position.push_back(0);
+        return position.size() - 1;
+    }
+
+    void releaseId(std::size_t id) {
+        position[id] = freeIds;
+        freeIds = id;
+    }
+
+    // Removes data[index], filling it with the last element.
+    void removeAt(std::size_t index) {
+        releaseId(data[index].id);
+        if(index + 1 == data.size()) {
+            data.pop_back();
+            return;
+        }
+        std::size_t moved = data.back().id;
+        place(index, std::move(data.back()));
+        data.pop_back();
+        fixUp(index);
+        fixDown(position[moved]);
+    }
+
+    // Moves 'entry' into data[to], recording its new position.
+    void place(std::size_t to, Entry &&entry) {
+        position[entry.id] = to;
+        data[to] = std::move(entry);
+    }
+
+    // Moves the element at index up until its parent is at least as
+    // extreme, carrying a hole as BinaryPQ does.
+    void fixUp(std::size_t index) {
+        Entry val = std::move(data[index]);
+        while(index > 0) {
+            std::size_t parent = (index - 1)/2;
+            if(!this->compare(data[parent].elt, val.elt)) break;
+            place(index, std::move(data[parent]));
+            index = parent;
+        }
+        place(index, std::move(val));
+    }
+
+    // Moves the element at index down until both children are no more
+    // extreme than it.
+    void fixDown(std::size_t index) {
+        Entry val = std::move(data[index]);
+        std::size_t child = (2*index) + 1;
+        while(child < data.size()) {
+            if(child + 1 < data.size() && this->compare(data[child].elt, data[child + 1].elt)) {
+                child++;
+            }
+            if(!this->compare(val.elt, data[child].elt)) break;
+            place(index, std::move(data[child]));
+            index = child;
+            child = (2*index) + 1;
+        }
+        place(index, std::move(val));
+    }
+}; // IndexedBinaryPQ
+
+
+namespace pmr {
+    // IndexedBinaryPQ drawing its storage from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using IndexedBinaryPQ =
+        ::IndexedBinaryPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // INDEXEDBINARYPQ_H
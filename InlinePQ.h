@@ -0,0 +1,287 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef INLINEPQ_H
+#define INLINEPQ_H
+
+#include "Eecs281PQ.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+// A std::pmr::memory_resource that hands out its own inline buffer of
+// BYTES bytes before going to 'upstream'.
+//
+// Blocks are carved off the front of the buffer in order. A block freed
+// from the end of what has been carved is given back; a block of the same
+// size as the first one handed out goes on a free list for the next request
+// of that size, which is how a PQ's nodes are recycled; any other block is
+// only reclaimed once every block in the buffer is free. A request that
+// does not fit goes upstream.
+template<std::size_t BYTES>
+class InlineResource : public std::pmr::memory_resource {
+public:
+    explicit InlineResource(std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) :
+        upstream{ upstream }, used{ 0 }, live{ 0 }, slotSize{ 0 }, freeList{ nullptr } {
+    }
+
+    // The buffer can't follow a copy; PQs copy their elements instead.
+    InlineResource(const InlineResource &) = delete;
+    InlineResource &operator=(const InlineResource &) = delete;
+
+    // Description: Return true if 'p' is in the inline buffer.
+    // Runtime: O(1)
+    bool owns(const void *p) const {
+        auto address = reinterpret_cast<std::uintptr_t>(p);
+        auto start = reinterpret_cast<std::uintptr_t>(buffer);
+        return address >= start && address < start + BYTES;
+    } // owns()
+
+    // Description: The resource requests that don't fit go to.
+    // Runtime: O(1)
+    std::pmr::memory_resource *upstream_resource() const {
+        return upstream;
+    } // upstream_resource()
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if(bytes == slotSize && freeList != nullptr) {
+            unsigned char *block = freeList;
+            std::memcpy(&freeList, block, sizeof(freeList));
+            live++;
+            return block;
+        }
+        std::size_t offset = (used + alignment - 1) / alignment * alignment;
+        if(alignment <= alignof(std::max_align_t) && bytes <= BYTES && offset <= BYTES - bytes) {
+            used = offset + bytes;
+            live++;
+            if(slotSize == 0) {
+                slotSize = bytes;
+            }
+            return buffer + offset;
+        }
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        if(!owns(p)) {
+            upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        unsigned char *block = static_cast<unsigned char*>(p);
+        if(--live == 0) {
+            used = 0;
+            freeList = nullptr;
+        }
+        else if(block + bytes == buffer + used) {
+            used = static_cast<std::size_t>(block - buffer);
+        }
+        else if(bytes == slotSize && bytes >= sizeof(freeList)) {
+            std::memcpy(block, &freeList, sizeof(freeList));
+            freeList = block;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+
+    alignas(std::max_align_t) unsigned char buffer[BYTES == 0 ? 1 : BYTES];
+    std::pmr::memory_resource *upstream;
+    // Bytes carved off the front of the buffer.
+    std::size_t used;
+    // Blocks handed out from the buffer and not yet freed.
+    std::size_t live;
+    // The size of the first block handed out, recycled through 'freeList'.
+    std::size_t slotSize;
+    unsigned char *freeList;
+}; // InlineResource
+
+
+// Any of the PQ implementations, e.g. InlinePQ<BinaryPQ, int>, holding
+// room for its first N elements inside the PQ object itself, so a queue
+// that never holds more than N elements never allocates. Past N the
+// underlying PQ's storage moves on its own to an upstream resource, by
+// default the default memory resource as of construction.
+//
+// The underlying PQ allocates through a std::pmr::polymorphic_allocator
+// over an InlineResource. PQs with a reserve() (BinaryPQ, SortedPQ,
+// UnorderedPQ, UnorderedFastPQ) reserve N elements, one block in the
+// buffer; PairingPQ takes its nodes from it one at a time, so the buffer
+// is sized for N of a PQ's public Node type where it has one. Other PQs
+// still use the buffer, but may spill before N, as their allocations don't
+// follow either pattern.
+//
+// Copies get a buffer of their own; moves copy.
+template<template<typename...> typename PQ, typename TYPE,
+         typename COMP_FUNCTOR = std::less<TYPE>, std::size_t N = 16>
+class InlinePQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Impl = PQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+
+    // Bytes the underlying PQ allocates per element: a Node if it has one,
+    // otherwise the element itself.
+    template<typename P, typename = void>
+    struct ElementBytes : std::integral_constant<std::size_t, sizeof(TYPE)> {};
+    template<typename P>
+    struct ElementBytes<P, std::void_t<typename P::Node>>
+        : std::integral_constant<std::size_t, sizeof(typename P::Node)> {};
+
+    template<typename P, typename = void>
+    struct HasReserve : std::false_type {};
+    template<typename P>
+    struct HasReserve<P, std::void_t<decltype(std::declval<P&>().reserve(std::size_t{}))>>
+        : std::true_type {};
+
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<TYPE>;
+    using Resource = InlineResource<N * ElementBytes<Impl>::value>;
+
+    static constexpr std::size_t INLINE_CAPACITY = N;
+
+
+    // Description: Construct an empty PQ with an optional comparison functor
+    //              and the resource to use past N elements.
+    // Runtime: O(1)
+    explicit InlinePQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                      std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) :
+        BaseClass{ comp }, resource{ upstream }, impl{ comp, allocator_type{ &resource } } {
+        reserveInline();
+    } // InlinePQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor and upstream resource.
+    // Runtime: That of the underlying PQ's pushes.
+    template<typename InputIterator>
+    InlinePQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             std::pmr::memory_resource *upstream = std::pmr::get_default_resource()) :
+        InlinePQ{ comp, upstream } {
+        while(start != end) {
+            impl.push(*start);
+            start++;
+        }
+    } // InlinePQ()
+
+
+    // Description: Copy constructor. The copy has a buffer of its own.
+    // Runtime: O(n)
+    InlinePQ(const InlinePQ &other) :
+        InlinePQ{ other.compare, other.resource.upstream_resource() } {
+        impl = other.impl;
+    } // InlinePQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    InlinePQ &operator=(const InlinePQ &rhs) {
+        impl = rhs.impl;
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor doesn't need any code, 'impl' gives back its
+    //              storage before 'resource' goes away.
+    virtual ~InlinePQ() {
+    } // ~InlinePQ()
+
+
+    // Description: Assumes that all elements inside the PQ are out of order
+    //              and 'rebuilds' it.
+    // Runtime: That of the underlying PQ.
+    virtual void updatePriorities() {
+        impl.updatePriorities();
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: That of the underlying PQ.
+    virtual void push(const TYPE &val) {
+        impl.push(val);
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: That of the underlying PQ.
+    virtual void pop() {
+        impl.pop();
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: That of the underlying PQ.
+    virtual const TYPE &top() const {
+        return impl.top();
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return impl.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return impl.empty();
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order, with the underlying PQ's pop_k().
+    // Runtime: That of the underlying PQ.
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        return impl.pop_k(k, out);
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order, with the underlying PQ's drain().
+    // Runtime: That of the underlying PQ.
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return impl.drain(out);
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true with
+    //              the underlying PQ's remove_if(), returning how many.
+    // Runtime: That of the underlying PQ.
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        return impl.remove_if(pred);
+    } // remove_if()
+
+
+    // Description: The allocator the underlying PQ uses, over the inline
+    //              buffer.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return impl.get_allocator();
+    } // get_allocator()
+
+
+private:
+    void reserveInline() {
+        if constexpr(HasReserve<Impl>::value) {
+            impl.reserve(N);
+        }
+    }
+
+    // Declared first so it outlives 'impl'.
+    Resource resource;
+    Impl impl;
+}; // InlinePQ
+
+
+#endif // INLINEPQ_H
@@ -0,0 +1,391 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef LOSERTREEMERGE_H
+#define LOSERTREEMERGE_H
+
+#include "Eecs281PQ.h"
+#include <cerrno>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+// A k-way merge of sorted runs through a tournament tree of losers (Knuth,
+// TAOCP vol. 3, 5.4.1).
+//
+// Runs are sorted in priority order, most extreme first as defined by
+// COMP_FUNCTOR, the way a PQ would pop them: descending for std::less,
+// ascending for std::greater. The merge yields their elements in the same
+// order, taking the element from the lower-numbered run on ties, so it is
+// stable.
+//
+// Each internal node of the tree holds the run that lost the match played
+// there, and the overall winner sits above the root. Taking the winner's
+// element and advancing its run replays only the matches on that run's path
+// to the root, one comparison each against the stored loser: about log2(k)
+// comparisons per element, where a binary heap of run heads needs a pop and
+// a push, and no element or run is ever moved. Each match is resolved with
+// selects rather than a branch, as its outcome is unpredictable; an
+// exhausted run loses every match.
+//
+// Run is any type with
+//     using value_type = ...;
+//     bool empty() const;
+//     const value_type &front() const;
+//     void pop_front();
+// such as IteratorRun over a sorted range or BufferedRun over a file
+// descriptor. The runs are owned by the merge; the tree is allocated from
+// Allocator rebound to its index and key types.
+template<typename Run, typename COMP_FUNCTOR = std::less<typename Run::value_type>,
+         typename Allocator = std::allocator<Run>>
+class LoserTreeMerge {
+public:
+    using value_type = typename Run::value_type;
+    using allocator_type = Allocator;
+
+private:
+    using Runs = std::vector<Run, ReboundAllocator<Allocator, Run>>;
+
+    // Each run's front is kept beside the tree, so a match reads both keys
+    // from one array instead of going through the runs. Small trivially
+    // copyable keys are copied there; others are pointed to, which is safe
+    // as only the winner's run is ever advanced.
+    static constexpr bool COPY_KEYS = std::is_trivially_copyable<value_type>::value
+        && std::is_default_constructible<value_type>::value && sizeof(value_type) <= 2*sizeof(void*);
+    using Key = std::conditional_t<COPY_KEYS, value_type, const value_type*>;
+
+    template<typename T>
+    using Vector = std::vector<T, ReboundAllocator<Allocator, T>>;
+
+public:
+    // Streams the merged elements: dereferencing gives the current winner,
+    // incrementing pops it. Equal to end() once the merge is empty.
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = typename Run::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        iterator() : merge{ nullptr } {}
+
+        reference operator*() const { return merge->top(); }
+        pointer operator->() const { return &merge->top(); }
+
+        iterator &operator++() {
+            merge->pop();
+            return *this;
+        }
+
+        // Post-increment can't hand back the popped element by iterator, so
+        // like std::istream_iterator it returns a copy of it instead.
+        value_type operator++(int) {
+            value_type current = merge->top();
+            merge->pop();
+            return current;
+        }
+
+        friend bool operator==(const iterator &a, const iterator &b) {
+            return a.atEnd() == b.atEnd();
+        }
+
+        friend bool operator!=(const iterator &a, const iterator &b) {
+            return !(a == b);
+        }
+
+    private:
+        friend LoserTreeMerge;
+
+        explicit iterator(LoserTreeMerge *merge) : merge{ merge } {}
+
+        bool atEnd() const { return merge == nullptr || merge->empty(); }
+
+        LoserTreeMerge *merge;
+    }; // iterator
+
+
+    // Description: Merge the runs in [start, end), which are moved in, with
+    //              an optional comparison functor.
+    // Runtime: O(k) comparisons, k the number of runs.
+    template<typename RunIterator>
+    LoserTreeMerge(RunIterator start, RunIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                   const Allocator &alloc = Allocator()) :
+        compare{ comp }, runs(std::make_move_iterator(start), std::make_move_iterator(end), alloc),
+        losers(alloc), keys(alloc), live(alloc) {
+        build();
+    } // LoserTreeMerge()
+
+
+    // Iterators point into the merge.
+    LoserTreeMerge(const LoserTreeMerge &) = delete;
+    LoserTreeMerge &operator=(const LoserTreeMerge &) = delete;
+
+
+    // Description: Return true once every run is exhausted.
+    // Runtime: O(1)
+    bool empty() const {
+        return !live[losers[0]];
+    } // empty()
+
+
+    // Description: Return the most extreme (defined by 'compare') front of
+    //              all the runs. The reference is good until the next pop().
+    // Runtime: O(1)
+    const value_type &top() const {
+        return keyOf(losers[0]);
+    } // top()
+
+
+    // Description: Take the element top() returned from its run.
+    // Runtime: O(log(k)) comparisons, plus the run's pop_front().
+    void pop() {
+        std::size_t winner = losers[0];
+        runs[winner].pop_front();
+        refresh(winner);
+        for(std::size_t node = (runs.size() + winner) / 2; node > 0; node /= 2) {
+            std::size_t challenger = losers[node];
+            // both stored unconditionally, so the outcome is a select
+            std::size_t swap = (challenger ^ winner) & (0 - static_cast<std::size_t>(beats(challenger, winner)));
+            losers[node] = challenger ^ swap;
+            winner ^= swap;
+        }
+        losers[0] = winner;
+    } // pop()
+
+
+    // Description: Pop up to k elements, writing them to 'out' in priority
+    //              order.
+    // Runtime: O(k log(runs))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(; k > 0 && !empty(); --k) {
+            *out++ = top();
+            pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every remaining element, writing them to 'out' in
+    //              priority order.
+    // Runtime: O(n log(runs))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        while(!empty()) {
+            *out++ = top();
+            pop();
+        }
+        return out;
+    } // drain()
+
+
+    // Description: Iterators streaming the rest of the merge; see iterator.
+    // Runtime: O(1)
+    iterator begin() {
+        return iterator{ this };
+    } // begin()
+
+    iterator end() {
+        return iterator{};
+    } // end()
+
+
+    // Description: The number of runs being merged.
+    // Runtime: O(1)
+    std::size_t runCount() const {
+        return runs.size();
+    } // runCount()
+
+
+    // Description: The allocator the merge was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(runs.get_allocator());
+    } // get_allocator()
+
+
+private:
+    // Whether run 'a' wins its match against run 'b'. A live run beats an
+    // exhausted one; between live runs the more extreme front wins, and on a
+    // tie the lower-numbered run, with one comparison either way.
+    bool beats(std::size_t a, std::size_t b) const {
+        if constexpr(!COPY_KEYS) {
+            if(!live[a]) return false;
+            if(!live[b]) return true;
+        }
+        // the lower-numbered run wins unless it is less extreme, written so
+        // there is nothing to branch on
+        bool aLower = a < b;
+        std::size_t lower = aLower ? a : b;
+        std::size_t higher = aLower ? b : a;
+        bool keyWins = aLower == !compare(keyOf(lower), keyOf(higher));
+        if constexpr(COPY_KEYS) {
+            // an exhausted run's stale copy is compared, then ignored
+            return (live[a] != 0) & ((live[b] == 0) | keyWins);
+        }
+        else {
+            return keyWins;
+        }
+    }
+
+    const value_type &keyOf(std::size_t run) const {
+        if constexpr(COPY_KEYS) {
+            return keys[run];
+        }
+        else {
+            return *keys[run];
+        }
+    }
+
+    // Reloads a run's key after it was advanced.
+    void refresh(std::size_t index) {
+        const Run &run = runs[index];
+        live[index] = !run.empty();
+        if(live[index]) {
+            if constexpr(COPY_KEYS) {
+                keys[index] = run.front();
+            }
+            else {
+                keys[index] = &run.front();
+            }
+        }
+    }
+
+    // Plays every match bottom up. Run i is leaf k + i and node n's children
+    // are 2n and 2n + 1, so nodes 1..k-1 are the matches for any k; 'losers'
+    // keeps each match's loser and losers[0] the winner.
+    void build() {
+        std::size_t k = runs.size();
+        // one live-less slot stands in for the winner of no runs
+        losers.assign(k == 0 ? 1 : k, 0);
+        keys.assign(k == 0 ? 1 : k, Key());
+        live.assign(k == 0 ? 1 : k, false);
+        for(std::size_t i = 0; i < k; ++i) {
+            refresh(i);
+        }
+        if(k == 0) return;
+        Vector<std::size_t> winners(2*k, 0, losers.get_allocator());
+        for(std::size_t i = 0; i < k; ++i) {
+            winners[k + i] = i;
+        }
+        for(std::size_t node = k - 1; node > 0; --node) {
+            std::size_t left = winners[2*node];
+            std::size_t right = winners[2*node + 1];
+            bool leftWins = beats(left, right);
+            winners[node] = leftWins ? left : right;
+            losers[node] = leftWins ? right : left;
+        }
+        losers[0] = winners[1];
+    }
+
+    COMP_FUNCTOR compare;
+    Runs runs;
+    Vector<std::size_t> losers;
+    Vector<Key> keys;
+    Vector<unsigned char> live;
+}; // LoserTreeMerge
+
+
+// A run over a sorted iterator range [first, last), which must stay valid
+// while it is merged.
+template<typename Iterator>
+class IteratorRun {
+public:
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+
+    IteratorRun(Iterator first, Iterator last) : first{ first }, last{ last } {}
+
+    bool empty() const { return first == last; }
+    const value_type &front() const { return *first; }
+    void pop_front() { ++first; }
+
+private:
+    Iterator first;
+    Iterator last;
+}; // IteratorRun
+
+
+// A run read from a file descriptor, a file, pipe or socket, holding records
+// of a trivially copyable TYPE in native byte order, already sorted. Records
+// are read a buffer at a time; a refill waits only until at least one whole
+// record has arrived, so a slow socket does not hold the merge back until
+// the buffer fills. The descriptor is not closed.
+//
+// A read error throws std::system_error, and end of input in the middle of
+// a record throws std::runtime_error.
+template<typename TYPE, typename Allocator = std::allocator<TYPE>>
+class BufferedRun {
+    static_assert(std::is_trivially_copyable<TYPE>::value,
+                  "BufferedRun reads records as raw bytes");
+
+public:
+    using value_type = TYPE;
+
+    // Records per buffer unless given.
+    static constexpr std::size_t DEFAULT_RECORDS = (std::size_t{ 64 } << 10) / sizeof(TYPE);
+
+    explicit BufferedRun(int fd, std::size_t records = DEFAULT_RECORDS,
+                         const Allocator &alloc = Allocator()) :
+        fd{ fd }, buffer(records == 0 ? 1 : records, TYPE(), alloc), head{ 0 }, tail{ 0 }, eof{ false } {
+        fill();
+    }
+
+    bool empty() const { return head == tail; }
+    const TYPE &front() const { return buffer[head]; }
+
+    void pop_front() {
+        if(++head == tail) {
+            fill();
+        }
+    }
+
+private:
+    void fill() {
+        head = 0;
+        tail = 0;
+        if(eof) return;
+        char *bytes = reinterpret_cast<char*>(buffer.data());
+        std::size_t capacity = buffer.size() * sizeof(TYPE);
+        std::size_t got = 0;
+        while(got < sizeof(TYPE) || got % sizeof(TYPE) != 0) {
+            ssize_t n = ::read(fd, bytes + got, capacity - got);
+            if(n < 0) {
+                if(errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "BufferedRun read");
+            }
+            if(n == 0) {
+                eof = true;
+                if(got % sizeof(TYPE) != 0) {
+                    throw std::runtime_error("BufferedRun: input ends inside a record");
+                }
+                break;
+            }
+            got += static_cast<std::size_t>(n);
+        }
+        tail = got / sizeof(TYPE);
+    }
+
+    int fd;
+    std::vector<TYPE, Allocator> buffer;
+    std::size_t head;
+    std::size_t tail;
+    bool eof;
+}; // BufferedRun
+
+
+namespace pmr {
+    // LoserTreeMerge drawing its runs and tree from a
+    // std::pmr::memory_resource.
+    template<typename Run, typename COMP_FUNCTOR = std::less<typename Run::value_type>>
+    using LoserTreeMerge = ::LoserTreeMerge<Run, COMP_FUNCTOR, std::pmr::polymorphic_allocator<Run>>;
+} // namespace pmr
+
+
+#endif // LOSERTREEMERGE_H
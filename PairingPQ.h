@@ -4,22 +4,36 @@
 #define PAIRINGPQ_H
 
 #include "Eecs281PQ.h"
+#include <algorithm>
 #include <deque>
+#include <memory_resource>
 #include <utility>
 
 // A specialized version of the priority queue ADT implemented as a pairing
 // heap.
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+//
+// Nodes are kept in leftmost-child/right-sibling form. Each node has a single
+// back pointer, 'prev', to its parent if it is the first child and to its
+// left sibling otherwise, so a node can be cut out of its sibling list in
+// O(1). CompactPairingPQ stores the same structure with 32-bit indices into
+// a pool.
+//
+// Nodes, and the queues used to walk them, come from Allocator rebound to
+// those types.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
 class PairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
+    using allocator_type = Allocator;
+
     // Each node within the pairing heap
     class Node {
         public:
             explicit Node(const TYPE &val)
-                : elt{ val }, child{ nullptr }, sibling{ nullptr }, parent{ nullptr }
+                : elt{ val }, child{ nullptr }, sibling{ nullptr }, prev{ nullptr }
             {}
 
             // Description: Allows access to the element at that Node's
@@ -40,15 +54,31 @@ public:
             TYPE elt;
             Node *child;
             Node *sibling;
-            Node *parent;
+            // The parent for a first child, otherwise the left sibling;
+            // nullptr only for the root.
+            Node *prev;
     }; // Node
 
+private:
+    using NodeAlloc = ReboundAllocator<Allocator, Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+    using NodeQueue = std::deque<Node*, ReboundAllocator<Allocator, Node*>>;
 
+public:
     // Description: Construct an empty pairing heap with an optional
     //              comparison functor.
     // Runtime: O(1)
-    explicit PairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp }, root{ nullptr }, count{ 0 } {
+    explicit PairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                       const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, root{ nullptr }, count{ 0 }, nodeAlloc{ alloc } {
+    } // PairingPQ()
+
+
+    // Description: Construct an empty pairing heap that allocates with
+    //              'alloc'.
+    // Runtime: O(1)
+    explicit PairingPQ(const Allocator &alloc) :
+        PairingPQ{ COMP_FUNCTOR(), alloc } {
     } // PairingPQ()
 
 
@@ -56,8 +86,9 @@ public:
     //              optional comparison functor.
     // Runtime: O(n) where n is number of elements in range.
     template<typename InputIterator>
-    PairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp }, root{ nullptr }, count{ 0 } {
+    PairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+              const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, root{ nullptr }, count{ 0 }, nodeAlloc{ alloc } {
         while(start != end) {
             addNode(*start);
             start++;
@@ -68,8 +99,16 @@ public:
     // Description: Copy constructor.
     // Runtime: O(n)
     PairingPQ(const PairingPQ &other) :
-        BaseClass{ other.compare }, root{ nullptr }, count{ 0 } {
-        std::deque<Node*> queue;
+        PairingPQ{ other, NodeTraits::select_on_container_copy_construction(other.nodeAlloc) } {
+    } // PairingPQ()
+
+
+    // Description: Copy constructor that allocates with 'alloc'.
+    // Runtime: O(n)
+    PairingPQ(const PairingPQ &other, const Allocator &alloc) :
+        BaseClass{ other.compare }, root{ nullptr }, count{ 0 }, nodeAlloc{ alloc } {
+        if(other.root == nullptr) { return; }
+        NodeQueue queue(nodeAlloc);
         queue.push_back(other.root);
         while(!queue.empty()) {
             Node* current = queue.front(); queue.pop_front();
@@ -83,7 +122,8 @@ public:
     // Description: Copy assignment operator.
     // Runtime: O(n)
     PairingPQ &operator=(const PairingPQ &rhs) {
-        PairingPQ temp(rhs);
+        // built with this heap's allocator, so the nodes can be swapped in
+        PairingPQ temp(rhs, get_allocator());
 
         std::swap(count, temp.count);
         std::swap(root, temp.root);
@@ -96,13 +136,13 @@ public:
     // Runtime: O(n)
     ~PairingPQ() {
         if(root == nullptr) { return; }
-        std::deque<Node*> queue;
+        NodeQueue queue(nodeAlloc);
         queue.push_back(root);
         while(!queue.empty()) {
             Node* current = queue.front(); queue.pop_front();
             if(current->child != nullptr) { queue.push_back(current->child); }
             if(current->sibling != nullptr) { queue.push_back(current->sibling); }
-            delete current;
+            destroyNode(current);
         }
     } // ~PairingPQ()
 
@@ -114,7 +154,7 @@ public:
     // Runtime: O(n)
     virtual void updatePriorities() {
         if(root == nullptr) { return; }
-        std::deque<Node*> queue;
+        NodeQueue queue(nodeAlloc);
         queue.push_back(root);
         root = nullptr;
         Node* current;
@@ -122,7 +162,7 @@ public:
             current = queue.front(); queue.pop_front();
             if(current->child != nullptr) { queue.push_back(current->child); }
             if(current->sibling != nullptr) { queue.push_back(current->sibling); }
-            current->child = nullptr; current->sibling = nullptr; current->parent = nullptr;
+            current->child = nullptr; current->sibling = nullptr; current->prev = nullptr;
             meldThis(root, current);
         }
     } // updatePriorities()
@@ -144,41 +184,13 @@ public:
     //       an element when the pairing heap is empty. Though you are
     //       welcome to if you are familiar with them, you do not need to use
     //       exceptions in this project.
+    // Note: The root's children are re-paired in place by mergePairs(), so
+    //       pop() does not allocate.
     // Runtime: Amortized O(log(n))
     virtual void pop() {
         Node* child = root->child;
-
-        // if there was only one node in the tree
-        if(child == nullptr) {
-            delete root;
-            root = nullptr;
-            count = 0;
-            return;
-        }
-
-        delete root;
-
-        Node* temp = child;
-        std::deque<Node*> queue;
-
-        // push all children to a queue, separating them
-        while(child != nullptr) {
-            queue.push_back(child);
-            child = child->sibling;
-            temp->sibling = nullptr;
-            temp->parent = nullptr;
-            temp = child;
-        }
-
-        Node* root1; Node* root2;
-
-        while(queue.size() > 1) {
-            root1 = queue.front(); queue.pop_front();
-            root2 = queue.front(); queue.pop_front();
-            queue.push_back(meld(root1, root2));
-        }
-
-        this->root = queue.front();
+        destroyNode(root);
+        root = mergePairs(child);
         count--;
     } // pop()
 
@@ -207,52 +219,121 @@ public:
     } // empty()
 
 
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order. Each root is moved out and its
+    //              children are re-paired in place, in one loop with no
+    //              virtual call or temporary container per element.
+    // Runtime: Amortized O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            *out++ = std::move(root->elt);
+            PairingPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: Amortized O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
     // Description: Updates the priority of an element already in the pairing
     //              heap by replacing the element refered to by the Node with
-    //              new_value. Must maintain pairing heap invariants.
+    //              new_value. Must maintain pairing heap invariants. Unless
+    //              it is the root, the node is cut out of its sibling list
+    //              through its back pointer and melded with the root.
     //
     // PRECONDITION: The new priority, given by 'new_value' must be more
     //               extreme (as defined by comp) than the old priority.
     //
-    // Runtime: As discussed in reading material.
+    // Runtime: O(1)
     void updateElt(Node* node, const TYPE &new_value) {
         if(node == nullptr) { return; }
         node->elt = new_value;
-        Node* parentNode = node->parent;
-        // check if the node being updated is the root, or if it's parent value is still
-        // more extreme or equal. In either case, nothing else needs to be done
-        if(parentNode == nullptr || !this->compare(parentNode->elt, new_value)) {
+        // nothing to do for the root, or for a first child whose parent is
+        // still at least as extreme
+        if(node->prev == nullptr
+           || (node->prev->child == node && !this->compare(node->prev->elt, new_value))) {
             return;
         }
+        cut(node);
+        root = meld(root, node);
+    } // updateElt()
 
-        // if the node is the leftmost child, but has a sibling
-        if(parentNode->child == node && node->sibling != nullptr) {
-            parentNode->child = node->sibling;
-            node->sibling = nullptr;
-            node->parent = nullptr;
-            meldThis(root, node);
-        }
 
-        // if the node is an only child
-        else if(parentNode->child == node && node->sibling == nullptr) {
-            parentNode->child = nullptr;
-            node->parent = nullptr;
-            meldThis(root, node);
+    // Description: Removes the element refered to by 'node' from the pairing
+    //              heap and deletes the node. The node is cut out with its
+    //              subtree, its children are paired as in pop(), and the
+    //              result is melded back with the root.
+    // Runtime: Amortized O(log(n))
+    void erase(Node* node) {
+        if(node == root) {
+            PairingPQ::pop();
+            return;
         }
+        cut(node);
+        Node* rest = mergePairs(node->child);
+        destroyNode(node);
+        if(rest != nullptr) {
+            root = meld(root, rest);
+        }
+        count--;
+    } // erase()
 
-        // if the node is somewhere else
-        else {
-            Node* child = parentNode->child;
-            while(child->sibling != node) {
-                child = child->sibling;
+
+    // Description: Removes every element for which 'pred' returns true,
+    //              deleting its node, and returns how many were removed.
+    //              A matching node is cut out of its kept ancestor's child
+    //              list and its children are filtered as subtrees of their
+    //              own; the kept subtree roots are then paired once, as in
+    //              pop(). Nodes of kept elements stay valid.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        if(root == nullptr) { return 0; }
+        // subtrees cut loose and not yet filtered, and kept nodes whose
+        // children are still to be filtered
+        NodeQueue loose(nodeAlloc);
+        NodeQueue kept(nodeAlloc);
+        Node* survivors = nullptr;
+        std::size_t removed = 0;
+        loose.push_back(root);
+        while(!loose.empty()) {
+            Node* node = loose.back(); loose.pop_back();
+            if(pred(static_cast<const TYPE&>(node->elt))) {
+                loosen(node, loose);
+                removed++;
+                continue;
+            }
+            node->sibling = survivors;
+            survivors = node;
+            kept.push_back(node);
+            while(!kept.empty()) {
+                Node* parent = kept.back(); kept.pop_back();
+                for(Node* child = parent->child; child != nullptr; ) {
+                    Node* next = child->sibling;
+                    if(pred(static_cast<const TYPE&>(child->elt))) {
+                        cut(child);
+                        loosen(child, loose);
+                        removed++;
+                    }
+                    else {
+                        kept.push_back(child);
+                    }
+                    child = next;
+                }
             }
-            child->sibling = node->sibling;
-            node->sibling = nullptr;
-            node->parent = nullptr;
-            meldThis(root, node);
         }
-
-    } // updateElt()
+        root = mergePairs(survivors);
+        count -= removed;
+        return removed;
+    } // remove_if()
 
 
     // Description: Add a new element to the pairing heap. Returns a Node*
@@ -263,7 +344,7 @@ public:
     //       when you implement updateElt() and updatePriorities().
     // Runtime: O(1)
     Node* addNode(const TYPE &val) {
-        Node *newNode = new Node(val);
+        Node *newNode = makeNode(val);
         // if the current pq is empty
         if(root == nullptr) {
             root = newNode;
@@ -278,24 +359,113 @@ public:
     } // addNode()
 
 
+    // Description: The allocator the pairing heap was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(nodeAlloc);
+    } // get_allocator()
+
+
 private:
+    Node* makeNode(const TYPE &val) {
+        Node* node = NodeTraits::allocate(nodeAlloc, 1);
+        try {
+            NodeTraits::construct(nodeAlloc, node, val);
+        }
+        catch(...) {
+            NodeTraits::deallocate(nodeAlloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroyNode(Node* node) {
+        NodeTraits::destroy(nodeAlloc, node);
+        NodeTraits::deallocate(nodeAlloc, node, 1);
+    }
+
+    // Two-pass pairing of a sibling list, done in place: the first pass melds
+    // neighbours left to right and threads the results onto a stack through
+    // their sibling pointers, the second melds the stack back into one tree.
+    // Returns the new root, or nullptr for an empty list.
+    Node* mergePairs(Node* first) {
+        Node* pairs = nullptr;
+        while(first != nullptr) {
+            Node* a = first;
+            Node* b = a->sibling;
+            a->prev = nullptr;
+            if(b == nullptr) {
+                a->sibling = pairs;
+                pairs = a;
+                break;
+            }
+            first = b->sibling;
+            a->sibling = nullptr;
+            b->sibling = nullptr;
+            b->prev = nullptr;
+            Node* melded = meld(a, b);
+            melded->sibling = pairs;
+            pairs = melded;
+        }
+
+        if(pairs == nullptr) { return nullptr; }
+        Node* result = pairs;
+        pairs = pairs->sibling;
+        result->sibling = nullptr;
+        while(pairs != nullptr) {
+            Node* next = pairs->sibling;
+            pairs->sibling = nullptr;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        return result;
+    }
 
-    // returns a new root node which melded the two inputs
+    // Unlinks a non-root node, together with its subtree, from its parent's
+    // child list.
+    void cut(Node* node) {
+        if(node->prev->child == node) {
+            node->prev->child = node->sibling;
+        }
+        else {
+            node->prev->sibling = node->sibling;
+        }
+        if(node->sibling != nullptr) {
+            node->sibling->prev = node->prev;
+        }
+        node->sibling = nullptr;
+        node->prev = nullptr;
+    }
+
+    // Deletes a detached node, adding each of its children to 'loose' as a
+    // subtree of its own.
+    void loosen(Node* node, NodeQueue &loose) {
+        Node* child = node->child;
+        while(child != nullptr) {
+            Node* next = child->sibling;
+            child->sibling = nullptr;
+            child->prev = nullptr;
+            loose.push_back(child);
+            child = next;
+        }
+        destroyNode(node);
+    }
+
+    // returns a new root node which melded the two inputs; both must be
+    // roots (no prev or sibling)
     Node* meld(Node* pq1Root, Node* pq2Root) {
         // if the most extreme element of pq1 is less extreme than that of pq2
         if(this->compare(pq1Root->elt, pq2Root->elt)) {
-            pq1Root->sibling = pq2Root->child;
-            pq1Root->parent = pq2Root;
-            pq2Root->child = pq1Root;
-            return pq2Root;
+            std::swap(pq1Root, pq2Root);
         }
-        // if the most extreme element of pq1 is equal to or more extreme than that of pq2
-        else {
-            pq2Root->sibling = pq1Root->child;
-            pq2Root->parent = pq1Root;
-            pq1Root->child = pq2Root;
-            return pq1Root;
+        // pq1 is now equal to or more extreme than pq2, which becomes its
+        // first child
+        pq2Root->sibling = pq1Root->child;
+        if(pq1Root->child != nullptr) {
+            pq1Root->child->prev = pq2Root;
         }
+        pq2Root->prev = pq1Root;
+        pq1Root->child = pq2Root;
         return pq1Root;
     }
 
@@ -303,25 +473,20 @@ private:
     void meldThis(Node* pq1Root, Node* pq2Root) {
         if(pq1Root == nullptr) { root = pq2Root; return; }
         else if(pq2Root == nullptr) { root = pq1Root; return; }
-        // if the most extreme element of pq1 is less extreme than that of pq2
-        if(this->compare(pq1Root->elt, pq2Root->elt)) {
-            pq1Root->sibling = pq2Root->child;
-            pq1Root->parent = pq2Root;
-            pq2Root->child = pq1Root;
-            root = pq2Root;
-        }
-        // if the most extreme element of pq1 is equal to or more extreme than that of pq2
-        else {
-            pq2Root->sibling = pq1Root->child;
-            pq2Root->parent = pq1Root;
-            pq1Root->child = pq2Root;
-            root = pq1Root;
-        }
+        root = meld(pq1Root, pq2Root);
     }
 
     Node* root;
     size_t count;
+    NodeAlloc nodeAlloc;
 };
 
 
+namespace pmr {
+    // PairingPQ drawing its nodes from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using PairingPQ = ::PairingPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
 #endif // PAIRINGPQ_H
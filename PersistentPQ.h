@@ -0,0 +1,391 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PERSISTENTPQ_H
+#define PERSISTENTPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// A persistent priority queue: a leftist heap whose nodes are never changed
+// once built and are shared, reference counted, between every copy that
+// reaches them. Copying is O(1), so a copy is a snapshot: push() and pop()
+// on one version build new nodes along its right spine, O(log(n)) of them,
+// and point at the rest of the old structure, which no other version sees
+// change. pushed() and popped() return the new version and leave this one
+// as it was.
+//
+// A node's rank is the length of its right spine, and its left child's rank
+// is never less than its right child's, so the right spine of an n-element
+// heap has at most log2(n + 1) nodes. Melding two heaps walks only their
+// right spines.
+//
+// Nodes come from std::allocate_shared with Allocator rebound to them. A
+// version's new nodes come from its own allocator; the nodes it shares are
+// given back through the allocator that built them, once the last version
+// holding them lets go.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class PersistentPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    struct Node;
+    using NodePtr = std::shared_ptr<Node>;
+
+    // Changed only while it is being torn down, once no version holds it.
+    struct Node {
+        Node(const TYPE &val, NodePtr left, NodePtr right, std::uint32_t rank)
+            : elt{ val }, left{ std::move(left) }, right{ std::move(right) }, rank{ rank }
+        {}
+
+        TYPE elt;
+        NodePtr left;
+        NodePtr right;
+        std::uint32_t rank;
+    };
+
+    using NodeAlloc = ReboundAllocator<Allocator, Node>;
+
+    template<typename T>
+    using Vector = std::vector<T, ReboundAllocator<Allocator, T>>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Description: Construct an empty persistent PQ with an optional
+    //              comparison functor.
+    // Runtime: O(1)
+    explicit PersistentPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                          const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, root{}, count{ 0 }, nodeAlloc{ alloc } {
+    } // PersistentPQ()
+
+
+    // Description: Construct an empty persistent PQ that allocates with
+    //              'alloc'.
+    // Runtime: O(1)
+    explicit PersistentPQ(const Allocator &alloc) :
+        PersistentPQ{ COMP_FUNCTOR(), alloc } {
+    } // PersistentPQ()
+
+
+    // Description: Construct a persistent PQ out of an iterator range with an
+    //              optional comparison functor, melding the elements in
+    //              pairs, then the pairs in pairs, and so on.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    PersistentPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                 const Allocator &alloc = Allocator()) :
+        PersistentPQ{ comp, alloc } {
+        Vector<NodePtr> heaps(nodeAlloc);
+        while(start != end) {
+            heaps.push_back(makeNode(*start, nullptr, nullptr));
+            start++;
+        }
+        count = heaps.size();
+        root = meldAll(heaps);
+    } // PersistentPQ()
+
+
+    // Description: Copy constructor. The copy shares every node with 'other'.
+    // Runtime: O(1)
+    PersistentPQ(const PersistentPQ &other) :
+        BaseClass{ other.compare }, root{ other.root }, count{ other.count },
+        nodeAlloc{ std::allocator_traits<NodeAlloc>::select_on_container_copy_construction(other.nodeAlloc) } {
+    } // PersistentPQ()
+
+
+    // Description: Copy constructor whose new nodes come from 'alloc'.
+    // Runtime: O(1)
+    PersistentPQ(const PersistentPQ &other, const Allocator &alloc) :
+        BaseClass{ other.compare }, root{ other.root }, count{ other.count }, nodeAlloc{ alloc } {
+    } // PersistentPQ()
+
+
+    // Description: Copy assignment operator. This version lets go of its own
+    //              nodes and shares those of 'rhs'.
+    // Runtime: O(1), plus O(n) for the nodes no other version holds.
+    PersistentPQ &operator=(const PersistentPQ &rhs) {
+        NodePtr old = std::move(root);
+        root = rhs.root;
+        count = rhs.count;
+        this->compare = rhs.compare;
+        release(std::move(old));
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor. Nodes no other version holds are torn down
+    //              without recursion, as the left spine can be O(n) long.
+    // Runtime: O(n) for the nodes no other version holds.
+    virtual ~PersistentPQ() {
+        release(std::move(root));
+    } // ~PersistentPQ()
+
+
+    // Description: Assumes that all elements inside the PQ are out of order
+    //              and 'rebuilds' it from new nodes. Other versions keep the
+    //              old nodes, and need rebuilding of their own.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        Vector<NodePtr> heaps(nodeAlloc);
+        heaps.reserve(count);
+        Vector<const Node*> stack(nodeAlloc);
+        if(root) {
+            stack.push_back(root.get());
+        }
+        while(!stack.empty()) {
+            const Node *node = stack.back();
+            stack.pop_back();
+            heaps.push_back(makeNode(node->elt, nullptr, nullptr));
+            if(node->left) { stack.push_back(node->left.get()); }
+            if(node->right) { stack.push_back(node->right.get()); }
+        }
+        NodePtr old = std::move(root);
+        root = meldAll(heaps);
+        release(std::move(old));
+    } // updatePriorities()
+
+
+    // Description: Add a new element to this version of the PQ.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val) {
+        root = meld(root, makeNode(val, nullptr, nullptr));
+        count++;
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from this version of the PQ by melding the root's
+    //              children.
+    // Runtime: O(log(n))
+    virtual void pop() {
+        NodePtr old = std::move(root);
+        root = meld(old->left, old->right);
+        count--;
+        release(std::move(old));
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return root->elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: Return a new version holding this one's elements and
+    //              'val'. This version is unchanged.
+    // Runtime: O(log(n))
+    PersistentPQ pushed(const TYPE &val) const {
+        PersistentPQ next{ *this };
+        next.push(val);
+        return next;
+    } // pushed()
+
+
+    // Description: Return a new version without this one's most extreme
+    //              element. This version is unchanged.
+    // Runtime: O(log(n))
+    PersistentPQ popped() const {
+        PersistentPQ next{ *this };
+        next.pop();
+        return next;
+    } // popped()
+
+
+    // Description: Return true if 'other' is this version or an unchanged
+    //              copy of it, which costs no memory of its own.
+    // Runtime: O(1)
+    bool sharesAllWith(const PersistentPQ &other) const {
+        return root == other.root;
+    } // sharesAllWith()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order. Elements are copied, as other
+    //              versions may still hold them.
+    // Runtime: O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            *out++ = root->elt;
+            PersistentPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true from
+    //              this version, and return how many were removed. Subtrees
+    //              that lose nothing stay shared; every kept element above
+    //              a removed one gets a new node of its own, and the pieces
+    //              are melded in rounds of pairs. Other versions are
+    //              unchanged.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        if(!root) { return 0; }
+        // a post-order walk: each node is expanded when first seen and
+        // finished when seen again, after its subtrees
+        Vector<std::pair<const Node*, bool>> stack(nodeAlloc);
+        // for each finished subtree, whether it lost nothing
+        Vector<bool> whole(nodeAlloc);
+        Vector<NodePtr> heaps(nodeAlloc);
+        std::size_t removed = 0;
+        stack.emplace_back(root.get(), false);
+        while(!stack.empty()) {
+            const Node *node = stack.back().first;
+            if(!stack.back().second) {
+                stack.back().second = true;
+                if(node->right) { stack.emplace_back(node->right.get(), false); }
+                if(node->left) { stack.emplace_back(node->left.get(), false); }
+                continue;
+            }
+            stack.pop_back();
+            // the left subtree is finished first, so the right is on top
+            bool rightWhole = true;
+            if(node->right) { rightWhole = whole.back(); whole.pop_back(); }
+            bool leftWhole = true;
+            if(node->left) { leftWhole = whole.back(); whole.pop_back(); }
+            bool keep = !pred(node->elt);
+            if(keep && leftWhole && rightWhole) {
+                whole.push_back(true);
+                continue;
+            }
+            if(node->left && leftWhole) { heaps.push_back(node->left); }
+            if(node->right && rightWhole) { heaps.push_back(node->right); }
+            if(keep) {
+                heaps.push_back(makeNode(node->elt, nullptr, nullptr));
+            }
+            else {
+                removed++;
+            }
+            whole.push_back(false);
+        }
+        if(removed == 0) { return 0; }
+        NodePtr old = std::move(root);
+        root = meldAll(heaps);
+        count -= removed;
+        release(std::move(old));
+        return removed;
+    } // remove_if()
+
+
+    // Description: The allocator this version's new nodes come from.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(nodeAlloc);
+    } // get_allocator()
+
+
+private:
+    static std::uint32_t rankOf(const NodePtr &node) {
+        return node ? node->rank : 0;
+    }
+
+    NodePtr makeNode(const TYPE &val, NodePtr left, NodePtr right) const {
+        // the child of higher rank goes left
+        if(rankOf(left) < rankOf(right)) {
+            std::swap(left, right);
+        }
+        std::uint32_t rank = rankOf(right) + 1;
+        return std::allocate_shared<Node>(nodeAlloc, val, std::move(left), std::move(right), rank);
+    }
+
+    // Builds new nodes along the right spines of 'a' and 'b' only; their
+    // left subtrees are shared. The recursion is as deep as those spines,
+    // O(log(n)).
+    NodePtr meld(const NodePtr &a, const NodePtr &b) const {
+        if(!a) { return b; }
+        if(!b) { return a; }
+        if(this->compare(a->elt, b->elt)) {
+            return makeNode(b->elt, b->left, meld(b->right, a));
+        }
+        return makeNode(a->elt, a->left, meld(a->right, b));
+    }
+
+    // Melds 'heaps' in rounds of pairs, O(n) in all.
+    NodePtr meldAll(Vector<NodePtr> &heaps) const {
+        if(heaps.empty()) {
+            return nullptr;
+        }
+        while(heaps.size() > 1) {
+            std::size_t half = 0;
+            for(std::size_t i = 0; i + 1 < heaps.size(); i += 2) {
+                heaps[half++] = meld(heaps[i], heaps[i + 1]);
+            }
+            if(heaps.size() % 2 == 1) {
+                heaps[half++] = std::move(heaps.back());
+            }
+            heaps.resize(half);
+        }
+        return std::move(heaps.front());
+    }
+
+    // Lets go of 'node', tearing down the nodes no other version holds by
+    // rotating each one's left child up until it has none, so freeing it
+    // never frees a chain of nodes recursively. A node held elsewhere is
+    // only let go of, which frees nothing.
+    static void release(NodePtr node) {
+        while(node) {
+            if(node.use_count() != 1) {
+                node.reset();
+            }
+            else if(node->left && node->left.use_count() == 1) {
+                NodePtr left = std::move(node->left);
+                node->left = std::move(left->right);
+                left->right = std::move(node);
+                node = std::move(left);
+            }
+            else {
+                node->left.reset();
+                NodePtr right = std::move(node->right);
+                node = std::move(right);
+            }
+        }
+    }
+
+    NodePtr root;
+    std::size_t count;
+    NodeAlloc nodeAlloc;
+}; // PersistentPQ
+
+
+namespace pmr {
+    // PersistentPQ drawing its nodes from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using PersistentPQ = ::PersistentPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // PERSISTENTPQ_H
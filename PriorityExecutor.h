@@ -0,0 +1,246 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PRIORITYEXECUTOR_H
+#define PRIORITYEXECUTOR_H
+
+#include "BinaryPQ.h"
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A thread pool that runs submitted tasks in priority order, larger
+// priorities first and first-in first-out among equal priorities within a
+// queue.
+//
+// Every worker owns a queue, a PQ<Job*, JobComp> behind its own mutex, so
+// submitters and workers only contend when they touch the same queue. Each
+// queue also publishes the priority of its top job in an atomic. A worker
+// looking for work scans those and takes from whichever queue holds the
+// highest priority job (its own on ties), so a high priority task submitted
+// to a busy worker's queue is stolen by the next free worker instead of
+// waiting behind that worker's current task. Tasks are not preempted.
+//
+// Tasks submitted from outside the pool are dealt round-robin to the
+// queues; tasks submitted by a running task go to that worker's own queue.
+//
+// PQ is any of the Eecs281PQ implementations taking <TYPE, COMP_FUNCTOR>,
+// e.g. PriorityExecutor<PairingPQ>.
+template<template<typename...> typename PQ = BinaryPQ>
+class PriorityExecutor {
+public:
+    using Priority = int;
+
+    // Description: Start 'workers' threads (at least one).
+    // Runtime: O(workers)
+    explicit PriorityExecutor(std::size_t workers = std::thread::hardware_concurrency()) :
+        queues{}, threads{}, nextQueue{ 0 }, pending{ 0 }, sleepers{ 0 }, stopping{ false } {
+        if(workers == 0) {
+            workers = 1;
+        }
+        for(std::size_t i = 0; i < workers; ++i) {
+            queues.emplace_back(new WorkerQueue);
+        }
+        for(std::size_t i = 0; i < workers; ++i) {
+            threads.emplace_back(&PriorityExecutor::work, this, i);
+        }
+    } // PriorityExecutor()
+
+
+    PriorityExecutor(const PriorityExecutor &) = delete;
+    PriorityExecutor &operator=(const PriorityExecutor &) = delete;
+
+
+    // Description: Runs every task already submitted, then joins the
+    //              workers. Submitting from another thread while the pool
+    //              is being destroyed is not allowed; tasks may still
+    //              submit follow-up tasks, which are also run.
+    // Runtime: O(workers) plus the remaining tasks.
+    ~PriorityExecutor() {
+        {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stopping = true;
+        }
+        wakeup.notify_all();
+        for(std::thread &thread : threads) {
+            thread.join();
+        }
+    } // ~PriorityExecutor()
+
+
+    // Description: Queue 'task' to run with the given priority. The
+    //              returned future holds its result, or the exception it
+    //              threw.
+    // Runtime: O(log(n)) for the backing PQ's push, n the queue's size.
+    template<typename F>
+    auto submit(Priority priority, F &&task)
+        -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        TaskJob<Result> *job = new TaskJob<Result>(priority, std::forward<F>(task));
+        std::future<Result> result = job->task.get_future();
+
+        std::size_t index = current.owner == this
+            ? current.index
+            : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+        // Counted before it is visible so a worker that sees the queue
+        // non-empty never sees pending at zero.
+        pending.fetch_add(1);
+        WorkerQueue &queue = *queues[index];
+        {
+            std::lock_guard<std::mutex> guard(queue.lock);
+            job->sequence = queue.sequence++;
+            queue.jobs.push(job);
+            queue.best.store(queue.jobs.top()->priority, std::memory_order_release);
+        }
+
+        // Pairs with the sleepers increment in work(): either this sees the
+        // sleeper, or the sleeper sees pending above zero.
+        if(sleepers.load() > 0) {
+            { std::lock_guard<std::mutex> guard(sleepLock); }
+            wakeup.notify_one();
+        }
+        return result;
+    } // submit()
+
+
+    // Description: Number of worker threads.
+    // Runtime: O(1)
+    std::size_t workers() const {
+        return threads.size();
+    } // workers()
+
+
+private:
+    // A queued task, type-erased so one PQ holds tasks of any result type.
+    struct Job {
+        explicit Job(Priority p) : priority{ p }, sequence{ 0 } {}
+        virtual ~Job() {}
+        virtual void run() = 0;
+
+        Priority priority;
+        // Submission order within the queue, breaks priority ties.
+        std::uint64_t sequence;
+    };
+
+    template<typename Result>
+    struct TaskJob : Job {
+        template<typename F>
+        TaskJob(Priority p, F &&f) : Job{ p }, task{ std::forward<F>(f) } {}
+        void run() override { task(); }
+
+        std::packaged_task<Result()> task;
+    };
+
+    // a is less extreme than b when it has a lower priority, or the same
+    // priority and was submitted later.
+    struct JobComp {
+        bool operator()(const Job *a, const Job *b) const {
+            if(a->priority != b->priority) {
+                return a->priority < b->priority;
+            }
+            return a->sequence > b->sequence;
+        }
+    };
+
+    static constexpr long long EMPTY = LLONG_MIN;
+
+    // Kept on its own cache lines so workers polling 'best' do not slow
+    // down each other's pushes.
+    struct alignas(64) WorkerQueue {
+        ~WorkerQueue() {
+            while(!jobs.empty()) {
+                delete jobs.top();
+                jobs.pop();
+            }
+        }
+
+        std::mutex lock;
+        PQ<Job*, JobComp> jobs;
+        std::uint64_t sequence = 0;
+        // Priority of jobs.top(), or EMPTY. Written under 'lock'.
+        std::atomic<long long> best{ EMPTY };
+    };
+
+    // Which pool and queue the calling thread works for, if any.
+    struct WorkerSlot {
+        const PriorityExecutor *owner = nullptr;
+        std::size_t index = 0;
+    };
+
+    void work(std::size_t self) {
+        current.owner = this;
+        current.index = self;
+        for(;;) {
+            if(Job *job = take(self)) {
+                job->run();
+                delete job;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(sleepLock);
+            sleepers.fetch_add(1);
+            wakeup.wait(guard, [this]() { return stopping || pending.load() > 0; });
+            sleepers.fetch_sub(1);
+            if(stopping && pending.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    // Pops the highest priority job across all queues, preferring the
+    // worker's own queue on ties. Returns nullptr when every queue is empty.
+    Job* take(std::size_t self) {
+        for(;;) {
+            std::size_t victim = self;
+            long long best = queues[self]->best.load(std::memory_order_acquire);
+            for(std::size_t i = 0; i < queues.size(); ++i) {
+                long long priority = queues[i]->best.load(std::memory_order_acquire);
+                if(priority > best) {
+                    best = priority;
+                    victim = i;
+                }
+            }
+            if(best == EMPTY) {
+                return nullptr;
+            }
+
+            WorkerQueue &queue = *queues[victim];
+            std::lock_guard<std::mutex> guard(queue.lock);
+            // another worker got there first; 'best' is already updated
+            if(queue.jobs.empty()) {
+                continue;
+            }
+            Job *job = queue.jobs.top();
+            queue.jobs.pop();
+            queue.best.store(queue.jobs.empty() ? EMPTY : queue.jobs.top()->priority,
+                             std::memory_order_release);
+            pending.fetch_sub(1);
+            return job;
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> nextQueue;
+
+    // Jobs submitted and not yet taken.
+    std::atomic<std::size_t> pending;
+    std::atomic<std::size_t> sleepers;
+    std::mutex sleepLock;
+    std::condition_variable wakeup;
+    bool stopping;
+
+    static inline thread_local WorkerSlot current;
+}; // PriorityExecutor
+
+
+#endif // PRIORITYEXECUTOR_H
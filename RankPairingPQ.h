@@ -0,0 +1,468 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef RANKPAIRINGPQ_H
+#define RANKPAIRINGPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// A specialized version of the priority queue ADT implemented as a type-1
+// rank-pairing heap (Haeupler, Sen and Tarjan).
+//
+// The heap is a list of half-trees. A half-tree root has only a left
+// subtree, and every node is at least as extreme as everything in its own
+// left subtree. Roots are only linked when their ranks are equal, and
+// updateElt() cuts the node out and repairs ranks up a path, which gives
+// O(1) amortized priority increases (PairingPQ has no such bound).
+//
+// Nodes and the node lists used to walk the heap come from Allocator
+// rebound to those types.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class RankPairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Each node within the rank-pairing heap
+    class Node {
+        public:
+            explicit Node(const TYPE &val)
+                : elt{ val }, left{ nullptr }, right{ nullptr }, parent{ nullptr }, rank{ 0 }
+            {}
+
+            // Description: Allows access to the element at that Node's
+            //              position.
+            // Runtime: O(1)
+            const TYPE &getElt() const { return elt; }
+            const TYPE &operator*() const { return elt; }
+
+            friend RankPairingPQ;
+
+        private:
+            TYPE elt;
+            Node *left;
+            // On a half-tree root this links to the next root in the list,
+            // otherwise it is the node's right child.
+            Node *right;
+            // nullptr exactly when the node is a half-tree root.
+            Node *parent;
+            int rank;
+    }; // Node
+
+private:
+    using NodeAlloc = ReboundAllocator<Allocator, Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+    using NodeList = std::vector<Node*, ReboundAllocator<Allocator, Node*>>;
+
+public:
+    // Description: Construct an empty heap with an optional comparison
+    //              functor.
+    // Runtime: O(1)
+    explicit RankPairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                           const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, first{ nullptr }, best{ nullptr }, count{ 0 },
+        buckets(alloc), nodeAlloc{ alloc } {
+    } // RankPairingPQ()
+
+
+    // Description: Construct an empty heap that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit RankPairingPQ(const Allocator &alloc) :
+        RankPairingPQ{ COMP_FUNCTOR(), alloc } {
+    } // RankPairingPQ()
+
+
+    // Description: Construct a heap out of an iterator range with an
+    //              optional comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    RankPairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                  const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, first{ nullptr }, best{ nullptr }, count{ 0 },
+        buckets(alloc), nodeAlloc{ alloc } {
+        while(start != end) {
+            addNode(*start);
+            start++;
+        }
+    } // RankPairingPQ()
+
+
+    // Description: Copy constructor.
+    // Runtime: O(n)
+    RankPairingPQ(const RankPairingPQ &other) :
+        RankPairingPQ{ other, NodeTraits::select_on_container_copy_construction(other.nodeAlloc) } {
+    } // RankPairingPQ()
+
+
+    // Description: Copy constructor that allocates with 'alloc'.
+    // Runtime: O(n)
+    RankPairingPQ(const RankPairingPQ &other, const Allocator &alloc) :
+        BaseClass{ other.compare }, first{ nullptr }, best{ nullptr }, count{ 0 },
+        buckets(alloc), nodeAlloc{ alloc } {
+        for(Node *node : other.allNodes()) {
+            addNode(node->elt);
+        }
+    } // RankPairingPQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    RankPairingPQ &operator=(const RankPairingPQ &rhs) {
+        // built with this heap's allocator, so the nodes can be swapped in
+        RankPairingPQ temp(rhs, get_allocator());
+
+        std::swap(first, temp.first);
+        std::swap(best, temp.best);
+        std::swap(count, temp.count);
+
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor
+    // Runtime: O(n)
+    virtual ~RankPairingPQ() {
+        for(Node *node : allNodes()) {
+            destroyNode(node);
+        }
+    } // ~RankPairingPQ()
+
+
+    // Description: Assumes that all elements inside the heap are out of
+    //              order and 'rebuilds' it. Every node becomes a rank 0
+    //              root, so no node is deleted or moved and existing
+    //              handles stay valid; the next pop() links them back up.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        NodeList nodes = allNodes();
+        first = nullptr;
+        best = nullptr;
+        for(Node *node : nodes) {
+            node->left = nullptr;
+            node->parent = nullptr;
+            node->rank = 0;
+            addRoot(node);
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the heap.
+    // Runtime: O(1)
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the heap. The removed root's left spine is split
+    //              into half-trees and all roots get one pass of
+    //              equal-rank linking.
+    // Note: We will not run tests on your code that would require it to pop
+    //       an element when the heap is empty.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        Node *old = best;
+        Node *result = nullptr;
+        Node *next = nullptr;
+
+        for(Node *root = first; root != nullptr; root = next) {
+            next = root->right;
+            if(root != old) {
+                root->right = nullptr;
+                linkByRank(root, result);
+            }
+        }
+
+        // every node on the right spine of the old left child is a new root
+        for(Node *node = old->left; node != nullptr; node = next) {
+            next = node->right;
+            node->right = nullptr;
+            node->parent = nullptr;
+            node->rank = rootRank(node);
+            linkByRank(node, result);
+        }
+
+        for(Node *&bucket : buckets) {
+            if(bucket != nullptr) {
+                bucket->right = result;
+                result = bucket;
+                bucket = nullptr;
+            }
+        }
+
+        destroyNode(old);
+        count--;
+
+        first = result;
+        best = first;
+        for(Node *root = first; root != nullptr; root = root->right) {
+            if(this->compare(best->elt, root->elt)) {
+                best = root;
+            }
+        }
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return best->elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+    // Description: Return true if the heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order, without a virtual call per
+    //              element.
+    // Runtime: Amortized O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            *out++ = std::move(best->elt);
+            RankPairingPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: Amortized O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: Updates the priority of an element already in the heap
+    //              by replacing the element refered to by the Node with
+    //              new_value. The node is cut out together with its left
+    //              subtree and becomes a root; its right subtree takes its
+    //              old place, and ranks are lowered up the path until one
+    //              does not change.
+    //
+    // PRECONDITION: The new priority, given by 'new_value' must be more
+    //               extreme (as defined by comp) than the old priority.
+    //
+    // Runtime: Amortized O(1)
+    void updateElt(Node* node, const TYPE &new_value) {
+        if(node == nullptr) { return; }
+        node->elt = new_value;
+
+        // a root only has to be checked against the current best
+        if(node->parent == nullptr) {
+            if(this->compare(best->elt, node->elt)) {
+                best = node;
+            }
+            return;
+        }
+
+        Node *parentNode = node->parent;
+        Node *replacement = node->right;
+        if(parentNode->left == node) {
+            parentNode->left = replacement;
+        }
+        else {
+            parentNode->right = replacement;
+        }
+        if(replacement != nullptr) {
+            replacement->parent = parentNode;
+        }
+
+        node->right = nullptr;
+        node->parent = nullptr;
+        node->rank = rootRank(node);
+        addRoot(node);
+
+        repairRanks(parentNode);
+    } // updateElt()
+
+
+    // Description: Removes every element for which 'pred' returns true,
+    //              deleting its node, and returns how many were removed.
+    //              As in updatePriorities(), every kept node becomes a rank
+    //              0 root, and its handle stays valid; the next pop() links
+    //              them back up.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        NodeList nodes = allNodes();
+        first = nullptr;
+        best = nullptr;
+        std::size_t removed = 0;
+        for(Node *node : nodes) {
+            if(pred(static_cast<const TYPE&>(node->elt))) {
+                destroyNode(node);
+                removed++;
+                continue;
+            }
+            node->left = nullptr;
+            node->parent = nullptr;
+            node->rank = 0;
+            addRoot(node);
+        }
+        count -= removed;
+        return removed;
+    } // remove_if()
+
+
+    // Description: Add a new element to the heap. Returns a Node*
+    //              corresponding to the newly added element, which stays
+    //              valid until that element is popped.
+    // Runtime: O(1)
+    Node* addNode(const TYPE &val) {
+        Node *newNode = makeNode(val);
+        addRoot(newNode);
+        count++;
+        return newNode;
+    } // addNode()
+
+
+    // Description: The allocator the heap was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(nodeAlloc);
+    } // get_allocator()
+
+
+private:
+    Node* makeNode(const TYPE &val) {
+        Node* node = NodeTraits::allocate(nodeAlloc, 1);
+        try {
+            NodeTraits::construct(nodeAlloc, node, val);
+        }
+        catch(...) {
+            NodeTraits::deallocate(nodeAlloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroyNode(Node* node) {
+        NodeTraits::destroy(nodeAlloc, node);
+        NodeTraits::deallocate(nodeAlloc, node, 1);
+    }
+
+    // Puts a detached node at the front of the root list.
+    void addRoot(Node *node) {
+        node->right = first;
+        first = node;
+        if(best == nullptr || this->compare(best->elt, node->elt)) {
+            best = node;
+        }
+    }
+
+    // The rank a half-tree root must have: one more than its left child.
+    static int rootRank(const Node *node) {
+        return node->left == nullptr ? 0 : node->left->rank + 1;
+    }
+
+    // Makes the less extreme of two equal-rank roots the left child of the
+    // other and returns the winner.
+    Node* link(Node *pq1Root, Node *pq2Root) {
+        if(this->compare(pq1Root->elt, pq2Root->elt)) {
+            std::swap(pq1Root, pq2Root);
+        }
+        pq2Root->right = pq1Root->left;
+        if(pq2Root->right != nullptr) {
+            pq2Root->right->parent = pq2Root;
+        }
+        pq1Root->left = pq2Root;
+        pq2Root->parent = pq1Root;
+        pq1Root->rank++;
+        return pq1Root;
+    }
+
+    // One-pass linking: a root either waits in the bucket for its rank, or
+    // is linked with the root already waiting there and the result goes
+    // straight to the output list.
+    void linkByRank(Node *root, Node *&result) {
+        size_t rank = static_cast<size_t>(root->rank);
+        if(rank >= buckets.size()) {
+            buckets.resize(rank + 1, nullptr);
+        }
+        if(buckets[rank] == nullptr) {
+            buckets[rank] = root;
+            return;
+        }
+        Node *winner = link(root, buckets[rank]);
+        buckets[rank] = nullptr;
+        winner->right = result;
+        result = winner;
+    }
+
+    // Walks up from a node that lost a child and applies the type-1 rank
+    // rule, stopping as soon as a rank does not go down.
+    void repairRanks(Node *node) {
+        while(node->parent != nullptr) {
+            int leftRank = node->left == nullptr ? -1 : node->left->rank;
+            int rightRank = node->right == nullptr ? -1 : node->right->rank;
+            int rank = leftRank == rightRank ? leftRank + 1 : std::max(leftRank, rightRank);
+            if(rank >= node->rank) {
+                return;
+            }
+            node->rank = rank;
+            node = node->parent;
+        }
+        node->rank = rootRank(node);
+    }
+
+    // Every node currently in the heap, in no particular order.
+    NodeList allNodes() const {
+        NodeList nodes(buckets.get_allocator());
+        nodes.reserve(count);
+        for(Node *root = first; root != nullptr; root = root->right) {
+            nodes.push_back(root);
+        }
+        size_t roots = nodes.size();
+        for(size_t i = 0; i < roots; ++i) {
+            if(nodes[i]->left != nullptr) {
+                nodes.push_back(nodes[i]->left);
+            }
+        }
+        for(size_t i = roots; i < nodes.size(); ++i) {
+            if(nodes[i]->left != nullptr) { nodes.push_back(nodes[i]->left); }
+            if(nodes[i]->right != nullptr) { nodes.push_back(nodes[i]->right); }
+        }
+        return nodes;
+    }
+
+    Node *first;
+    Node *best;
+    size_t count;
+
+    // Scratch space for pop(), indexed by rank and left all nullptr between
+    // calls so it can be reused without clearing.
+    NodeList buckets;
+    NodeAlloc nodeAlloc;
+}; // RankPairingPQ
+
+
+namespace pmr {
+    // RankPairingPQ drawing its nodes from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using RankPairingPQ =
+        ::RankPairingPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // RANKPAIRINGPQ_H
@@ -0,0 +1,497 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef RECORDINGPQ_H
+#define RECORDINGPQ_H
+
+#include "Eecs281PQ.h"
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <iterator>
+#include <memory_resource>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Operation traces for the PQs: RecordingPQ logs every push, pop, top,
+// updatePriorities, addNode, updateElt and remove_if call made on a PQ to a
+// compact binary trace, readTrace() loads one back, and replayTrace() runs it
+// against any PQ and counts the top() results that differ from the ones
+// recorded. bench/replayTrace times a trace against every PQ here.
+//
+// Trace format: the 4 bytes "PQTR", a version byte, sizeof(TYPE) and a
+// signedness byte, then one opcode byte per operation. push, addNode and top
+// are followed by the value as a zigzag varint of its difference from the
+// previous value in the trace; updateElt by the handle (the index of the
+// addNode call that created it) as a varint and then the value. A predicate
+// cannot be written down, so remove_if is recorded by what it removed: the
+// count as a varint, then each removed value. Ties and long runs of nearby
+// keys therefore take one or two bytes per operation. Version 1 traces,
+// written before remove_if was recorded, are read the same way.
+//
+// Only integral TYPEs can be recorded.
+
+enum class TraceOp : unsigned char {
+    Push, Pop, Top, UpdatePriorities, AddNode, UpdateElt,
+    // Decoded as a RemoveIf event whose 'handle' is the count, followed by
+    // that many Removed events holding the values.
+    RemoveIf, Removed
+};
+
+template<typename TYPE>
+struct TraceEvent {
+    TraceOp op;
+    TYPE value;
+    std::uint64_t handle;
+};
+
+
+// Encodes operations into a buffer and writes it to 'out' in large chunks.
+template<typename TYPE>
+class TraceWriter {
+    static_assert(std::is_integral<TYPE>::value, "only integral keys can be traced");
+
+public:
+    static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+    static constexpr char VERSION = 2;
+
+    explicit TraceWriter(std::ostream &out) : out{ out }, previous{ 0 } {
+        buffer.reserve(BUFFER_SIZE);
+        const char header[] = { 'P', 'Q', 'T', 'R', VERSION, static_cast<char>(sizeof(TYPE)),
+                                static_cast<char>(std::is_signed<TYPE>::value) };
+        out.write(header, sizeof(header));
+    }
+
+    TraceWriter(const TraceWriter &) = delete;
+    TraceWriter &operator=(const TraceWriter &) = delete;
+
+    ~TraceWriter() {
+        flush();
+    }
+
+    void record(TraceOp op) {
+        buffer.push_back(static_cast<unsigned char>(op));
+        if(buffer.size() >= BUFFER_SIZE - 32) {
+            flush();
+        }
+    }
+
+    void record(TraceOp op, const TYPE &value) {
+        buffer.push_back(static_cast<unsigned char>(op));
+        writeValue(value);
+        if(buffer.size() >= BUFFER_SIZE - 32) {
+            flush();
+        }
+    }
+
+    void record(TraceOp op, std::uint64_t handle, const TYPE &value) {
+        buffer.push_back(static_cast<unsigned char>(op));
+        writeVarint(handle);
+        writeValue(value);
+        if(buffer.size() >= BUFFER_SIZE - 32) {
+            flush();
+        }
+    }
+
+    void record(TraceOp op, const std::vector<TYPE> &values) {
+        buffer.push_back(static_cast<unsigned char>(op));
+        writeVarint(values.size());
+        for(const TYPE &value : values) {
+            writeValue(value);
+            if(buffer.size() >= BUFFER_SIZE - 32) {
+                flush();
+            }
+        }
+        if(buffer.size() >= BUFFER_SIZE - 32) {
+            flush();
+        }
+    }
+
+    void flush() {
+        out.write(reinterpret_cast<const char*>(buffer.data()),
+                  static_cast<std::streamsize>(buffer.size()));
+        out.flush();
+        buffer.clear();
+    }
+
+private:
+    void writeVarint(std::uint64_t bits) {
+        while(bits >= 0x80) {
+            buffer.push_back(static_cast<unsigned char>(bits | 0x80));
+            bits >>= 7;
+        }
+        buffer.push_back(static_cast<unsigned char>(bits));
+    }
+
+    // The difference is taken modulo 2^64 and read as signed, which is
+    // exact for every integral TYPE.
+    void writeValue(const TYPE &value) {
+        std::uint64_t current = static_cast<std::uint64_t>(value);
+        std::uint64_t delta = current - previous;
+        previous = current;
+        std::uint64_t sign = (delta >> 63) != 0 ? ~std::uint64_t{ 0 } : 0;
+        writeVarint((delta << 1) ^ sign);
+    }
+
+    std::ostream &out;
+    std::vector<unsigned char> buffer;
+    std::uint64_t previous;
+}; // TraceWriter
+
+
+// Description: Reads a whole trace written by a TraceWriter<TYPE>. Throws
+//              std::runtime_error if the header does not match TYPE or the
+//              trace is cut off in the middle of an operation.
+// Runtime: O(length of the trace)
+template<typename TYPE>
+std::vector<TraceEvent<TYPE>> readTrace(std::istream &in) {
+    std::vector<char> bytes{ std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+    if(bytes.size() < 7 || bytes[0] != 'P' || bytes[1] != 'Q' || bytes[2] != 'T'
+       || bytes[3] != 'R' || bytes[4] < 1 || bytes[4] > TraceWriter<TYPE>::VERSION) {
+        throw std::runtime_error("not a PQ trace");
+    }
+    if(static_cast<std::size_t>(bytes[5]) != sizeof(TYPE)
+       || (bytes[6] != 0) != std::is_signed<TYPE>::value) {
+        throw std::runtime_error("trace was recorded with a different key type");
+    }
+
+    std::size_t pos = 7;
+    auto readVarint = [&bytes, &pos]() {
+        std::uint64_t bits = 0;
+        for(unsigned shift = 0; ; shift += 7) {
+            if(pos == bytes.size() || shift > 63) {
+                throw std::runtime_error("truncated PQ trace");
+            }
+            unsigned char byte = static_cast<unsigned char>(bytes[pos++]);
+            bits |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if((byte & 0x80) == 0) {
+                return bits;
+            }
+        }
+    };
+    std::uint64_t previous = 0;
+    auto readValue = [&readVarint, &previous]() {
+        std::uint64_t zigzag = readVarint();
+        std::uint64_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        previous += delta;
+        return static_cast<TYPE>(previous);
+    };
+
+    std::vector<TraceEvent<TYPE>> events;
+    while(pos < bytes.size()) {
+        TraceEvent<TYPE> event{ static_cast<TraceOp>(bytes[pos++]), TYPE(), 0 };
+        switch(event.op) {
+        case TraceOp::Pop:
+        case TraceOp::UpdatePriorities:
+            break;
+        case TraceOp::Push:
+        case TraceOp::Top:
+        case TraceOp::AddNode:
+            event.value = readValue();
+            break;
+        case TraceOp::UpdateElt:
+            event.handle = readVarint();
+            event.value = readValue();
+            break;
+        case TraceOp::RemoveIf:
+            event.handle = readVarint();
+            events.push_back(event);
+            for(std::uint64_t i = 0; i < event.handle; i++) {
+                events.push_back(TraceEvent<TYPE>{ TraceOp::Removed, readValue(), 0 });
+            }
+            continue;
+        default:
+            throw std::runtime_error("unknown operation in PQ trace");
+        }
+        events.push_back(event);
+    }
+    return events;
+} // readTrace()
+
+
+// Description: True if the trace calls updateElt(), which only the PQs with
+//              handles (PairingPQ, CompactPairingPQ, RankPairingPQ) can
+//              replay.
+template<typename TYPE>
+bool traceNeedsHandles(const std::vector<TraceEvent<TYPE>> &events) {
+    for(const TraceEvent<TYPE> &event : events) {
+        if(event.op == TraceOp::UpdateElt) {
+            return true;
+        }
+    }
+    return false;
+} // traceNeedsHandles()
+
+
+// The handle type for PQs with addNode(), void for the rest; only used in
+// decltype.
+template<typename TYPE, typename PQ>
+auto handleType(PQ &pq) -> decltype(pq.addNode(std::declval<const TYPE&>()));
+template<typename TYPE>
+void handleType(...);
+
+
+// Description: Runs every event of the trace against 'pq', which should
+//              start out empty, and returns how many top() calls returned
+//              something other than what was recorded, plus the remove_if()
+//              calls that removed a different number of elements.
+//              addNode() is replayed as push() on PQs without handles, and
+//              remove_if() removes the recorded values, which among equal
+//              values need not be the same handles.
+// Runtime: That of the operations in the trace.
+template<typename PQ, typename TYPE>
+std::size_t replayTrace(const std::vector<TraceEvent<TYPE>> &events, PQ &pq) {
+    using Handle = decltype(handleType<TYPE>(pq));
+    constexpr bool HANDLES = !std::is_void<Handle>::value;
+    std::vector<std::conditional_t<HANDLES, Handle, char>> handles;
+    std::size_t mismatches = 0;
+
+    for(std::size_t i = 0; i < events.size(); i++) {
+        const TraceEvent<TYPE> &event = events[i];
+        switch(event.op) {
+        case TraceOp::Push:
+            pq.push(event.value);
+            break;
+        case TraceOp::Pop:
+            pq.pop();
+            break;
+        case TraceOp::Top:
+            if(pq.top() != event.value) {
+                mismatches++;
+            }
+            break;
+        case TraceOp::UpdatePriorities:
+            pq.updatePriorities();
+            break;
+        case TraceOp::AddNode:
+            if constexpr(HANDLES) {
+                handles.push_back(pq.addNode(event.value));
+            }
+            else {
+                pq.push(event.value);
+            }
+            break;
+        case TraceOp::UpdateElt:
+            if constexpr(HANDLES) {
+                pq.updateElt(handles[event.handle], event.value);
+            }
+            else {
+                throw std::runtime_error("updateElt needs a PQ with handles");
+            }
+            break;
+        case TraceOp::RemoveIf: {
+            std::unordered_map<TYPE, std::uint64_t> remaining;
+            for(std::uint64_t k = 0; k < event.handle; k++) {
+                remaining[events[++i].value]++;
+            }
+            std::size_t removed = pq.remove_if([&remaining](const TYPE &val) {
+                auto found = remaining.find(val);
+                if(found == remaining.end() || found->second == 0) {
+                    return false;
+                }
+                found->second--;
+                return true;
+            });
+            if(removed != event.handle) {
+                mismatches++;
+            }
+            break;
+        }
+        case TraceOp::Removed:
+            break;
+        }
+    }
+    return mismatches;
+} // replayTrace()
+
+
+// A PQ<TYPE, COMP_FUNCTOR> that appends every operation made on it to a
+// trace written to 'trace'. The trace is buffered and only complete once
+// the RecordingPQ is destroyed or flush() is called.
+//
+// The underlying PQ and the handle table allocate with Allocator; the trace
+// buffer does not, as it is not part of the queue.
+template<template<typename...> typename PQ, typename TYPE,
+         typename COMP_FUNCTOR = std::less<TYPE>, typename Allocator = std::allocator<TYPE>>
+class RecordingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Impl = PQ<TYPE, COMP_FUNCTOR, Allocator>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Description: Construct an empty PQ recording to 'trace', with an
+    //              optional comparison functor.
+    // Runtime: O(1)
+    explicit RecordingPQ(std::ostream &trace, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                         const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, impl{ comp, alloc }, writer{ trace }, handles(HandleAlloc(alloc)) {
+    } // RecordingPQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor. The elements are recorded as pushes.
+    // Runtime: That of the underlying PQ's range constructor.
+    template<typename InputIterator>
+    RecordingPQ(std::ostream &trace, InputIterator start, InputIterator end,
+                COMP_FUNCTOR comp = COMP_FUNCTOR(), const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, impl{ start, end, comp, alloc }, writer{ trace },
+        handles(HandleAlloc(alloc)) {
+        while(start != end) {
+            writer.record(TraceOp::Push, *start);
+            start++;
+        }
+    } // RecordingPQ()
+
+
+    RecordingPQ(const RecordingPQ &) = delete;
+    RecordingPQ &operator=(const RecordingPQ &) = delete;
+
+
+    // Description: Destructor, flushes the rest of the trace.
+    virtual ~RecordingPQ() {
+    } // ~RecordingPQ()
+
+
+    // Description: Records the call, then has the underlying PQ restore its
+    //              invariant.
+    // Runtime: That of the underlying PQ.
+    virtual void updatePriorities() {
+        writer.record(TraceOp::UpdatePriorities);
+        impl.updatePriorities();
+    } // updatePriorities()
+
+
+    // Description: Records the value, then adds it to the underlying PQ.
+    // Runtime: That of the underlying PQ, plus amortized O(1).
+    virtual void push(const TYPE &val) {
+        writer.record(TraceOp::Push, val);
+        impl.push(val);
+    } // push()
+
+
+    // Description: Records the call, then removes the most extreme element
+    //              from the underlying PQ, forgetting its handle if it was
+    //              added with addNode().
+    // Runtime: That of the underlying PQ, plus amortized O(1).
+    virtual void pop() {
+        writer.record(TraceOp::Pop);
+        if(!handles.empty()) {
+            handles.erase(&impl.top());
+        }
+        impl.pop();
+    } // pop()
+
+
+    // Description: Return the most extreme element of the underlying PQ,
+    //              recording the value returned so a replay can check it.
+    // Runtime: That of the underlying PQ, plus amortized O(1).
+    virtual const TYPE &top() const {
+        const TYPE &result = impl.top();
+        writer.record(TraceOp::Top, result);
+        return result;
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ. Not recorded.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return impl.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty. Not recorded.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return impl.empty();
+    } // empty()
+
+
+    // Description: addNode() of the underlying PQ, for PQs with handles.
+    //              The handle is numbered in the trace by the order of
+    //              addNode() calls.
+    // Runtime: That of the underlying PQ, plus amortized O(1).
+    template<typename P = Impl>
+    typename P::Node* addNode(const TYPE &val) {
+        writer.record(TraceOp::AddNode, val);
+        typename P::Node *node = impl.addNode(val);
+        handles[&node->getElt()] = nextHandle++;
+        return node;
+    } // addNode()
+
+
+    // Description: updateElt() of the underlying PQ, for PQs with handles.
+    //              Throws std::out_of_range for a node that is not in the
+    //              PQ.
+    // Runtime: That of the underlying PQ, plus amortized O(1).
+    template<typename P = Impl>
+    void updateElt(typename P::Node *node, const TYPE &new_value) {
+        writer.record(TraceOp::UpdateElt, handles.at(&node->getElt()), new_value);
+        impl.updateElt(node, new_value);
+    } // updateElt()
+
+
+    // Description: remove_if() of the underlying PQ, recorded as the values
+    //              it removed. Returns how many were removed.
+    // Runtime: That of the underlying PQ, plus O(1) per removed element.
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        std::vector<TYPE> removed;
+        std::size_t count = impl.remove_if([this, &pred, &removed](const TYPE &val) {
+            if(!pred(val)) {
+                return false;
+            }
+            removed.push_back(val);
+            if(!handles.empty()) {
+                handles.erase(&val);
+            }
+            return true;
+        });
+        writer.record(TraceOp::RemoveIf, removed);
+        return count;
+    } // remove_if()
+
+
+    // Description: Writes out everything recorded so far.
+    // Runtime: O(size of the buffered trace)
+    void flush() {
+        writer.flush();
+    } // flush()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return impl.get_allocator();
+    } // get_allocator()
+
+
+private:
+    using HandleAlloc = ReboundAllocator<Allocator, std::pair<const void* const, std::uint64_t>>;
+
+    Impl impl;
+    mutable TraceWriter<TYPE> writer;
+    // Trace number of each live handle, keyed by the address of its element
+    // inside the node, which is what top() and remove_if()'s predicate see.
+    // The entry goes when its node leaves the PQ.
+    std::unordered_map<const void*, std::uint64_t, std::hash<const void*>,
+                       std::equal_to<const void*>, HandleAlloc> handles;
+    std::uint64_t nextHandle = 0;
+}; // RecordingPQ
+
+
+namespace pmr {
+    // RecordingPQ drawing its storage from a std::pmr::memory_resource.
+    template<template<typename...> typename PQ, typename TYPE,
+             typename COMP_FUNCTOR = std::less<TYPE>>
+    using RecordingPQ =
+        ::RecordingPQ<PQ, TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // RECORDINGPQ_H
@@ -0,0 +1,518 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SEQUENCEHEAPPQ_H
+#define SEQUENCEHEAPPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <iterator>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// A specialized version of the priority queue ADT implemented as a sequence
+// heap (Sanders, "Fast Priority Queues for Cached Memory").
+//
+// New elements go into a small binary insertion heap. When it fills up it
+// is sorted into a run and handed to group 0. Each group holds up to ARITY
+// sorted runs plus a group buffer of its most extreme elements; a full group
+// merges all of its runs into one and passes it to the next group. Pops are
+// served from a deletion buffer that is refilled by merging the group
+// buffers. Apart from the insertion heap, which stays cache resident, every
+// access walks a sorted run front to back, so very large queues pay for
+// sequential transfers instead of a cache miss per heap level.
+//
+// Invariants:
+//   - every element of the deletion buffer is at least as extreme as every
+//     element of every group, and
+//   - every element of a group's buffer is at least as extreme as every
+//     element of that group's runs.
+// The insertion heap is unconstrained, so top() compares its front with the
+// deletion buffer's front.
+//
+// Every run, buffer and scratch vector uses Allocator, rebound where it
+// holds something other than elements.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class SequenceHeapPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Items = std::vector<TYPE, Allocator>;
+
+    template<typename T>
+    using Vector = std::vector<T, ReboundAllocator<Allocator, T>>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Elements held by the insertion heap, and the size of each group buffer
+    // and of the deletion buffer.
+    static constexpr size_t BUFFER_SIZE = 256;
+    // Runs per group before the group is merged into the next one.
+    static constexpr size_t ARITY = 64;
+
+
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: O(1)
+    explicit SequenceHeapPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                            const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, insertHeap(alloc), deleteBuffer(alloc), groups(alloc), count{ 0 } {
+    } // SequenceHeapPQ()
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit SequenceHeapPQ(const Allocator &alloc) :
+        SequenceHeapPQ{ COMP_FUNCTOR(), alloc } {
+    } // SequenceHeapPQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: O(n log(n)) where n is number of elements in range.
+    template<typename InputIterator>
+    SequenceHeapPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                   const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, insertHeap(alloc), deleteBuffer(alloc), groups(alloc), count{ 0 } {
+        Items elements(start, end, alloc);
+        rebuild(elements);
+    } // SequenceHeapPQ()
+
+
+    // Description: Destructor doesn't need any code, every buffer and run is
+    //              a vector.
+    virtual ~SequenceHeapPQ() {
+    } // ~SequenceHeapPQ()
+
+
+    // Description: Assumes that all elements are out of order and rebuilds
+    //              the PQ as a single sorted run.
+    // Runtime: O(n log(n))
+    virtual void updatePriorities() {
+        Items elements(allocator());
+        elements.reserve(count);
+        std::move(insertHeap.begin(), insertHeap.end(), std::back_inserter(elements));
+        deleteBuffer.moveTo(elements);
+        for(Group &group : groups) {
+            group.buffer.moveTo(elements);
+            for(Run &run : group.runs) {
+                run.moveTo(elements);
+            }
+        }
+        insertHeap.clear();
+        deleteBuffer = Run(allocator());
+        groups.clear();
+        rebuild(elements);
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: Amortized O(log(n))
+    virtual void push(const TYPE &val) {
+        if(insertHeap.size() == BUFFER_SIZE) {
+            flushInsertHeap();
+        }
+        insertHeap.push_back(val);
+        std::push_heap(insertHeap.begin(), insertHeap.end(), this->compare);
+        count++;
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Note: We will not run tests on your code that would require it to pop
+    //       an element when the PQ is empty.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        if(fromInsertHeap()) {
+            std::pop_heap(insertHeap.begin(), insertHeap.end(), this->compare);
+            insertHeap.pop_back();
+        }
+        else {
+            deleteBuffer.head++;
+            if(deleteBuffer.empty()) {
+                refillDeleteBuffer();
+            }
+        }
+        count--;
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return fromInsertHeap() ? insertHeap.front() : deleteBuffer.front();
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order. Elements are moved straight
+    //              out of the deletion buffer or insertion heap.
+    // Runtime: Amortized O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            if(fromInsertHeap()) {
+                std::pop_heap(insertHeap.begin(), insertHeap.end(), this->compare);
+                *out++ = std::move(insertHeap.back());
+                insertHeap.pop_back();
+            }
+            else {
+                *out++ = std::move(deleteBuffer.items[deleteBuffer.head++]);
+                if(deleteBuffer.empty()) {
+                    refillDeleteBuffer();
+                }
+            }
+            count--;
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order. The runs are already sorted, so this merges them
+    //              rather than sorting everything again.
+    // Runtime: Amortized O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed. Each run and buffer is
+    //              filtered in place, which keeps it sorted and keeps both
+    //              invariants; only the insertion heap is re-heapified, and
+    //              an emptied deletion buffer is refilled.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        insertHeap.erase(std::remove_if(insertHeap.begin(), insertHeap.end(), pred), insertHeap.end());
+        std::make_heap(insertHeap.begin(), insertHeap.end(), this->compare);
+        size_t kept = insertHeap.size();
+        deleteBuffer.removeIf(pred);
+        kept += deleteBuffer.size();
+        for(Group &group : groups) {
+            group.buffer.removeIf(pred);
+            kept += group.buffer.size();
+            for(Run &run : group.runs) {
+                run.removeIf(pred);
+                kept += run.size();
+            }
+            group.runs.erase(std::remove_if(group.runs.begin(), group.runs.end(),
+                                            [](const Run &run) { return run.empty(); }),
+                             group.runs.end());
+        }
+        size_t removed = count - kept;
+        count = kept;
+        if(deleteBuffer.empty()) {
+            refillDeleteBuffer();
+        }
+        return removed;
+    } // remove_if()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator();
+    } // get_allocator()
+
+
+private:
+    // A sorted sequence, most extreme element first, consumed from the front
+    // by advancing 'head' so reads stay sequential. Runs and groups are
+    // allocator-aware, so the vectors holding them pass the allocator on
+    // when they copy or move them (a scoped allocator such as
+    // polymorphic_allocator does).
+    struct Run {
+        using allocator_type = Allocator;
+
+        explicit Run(const Allocator &alloc) : items(alloc) {}
+        Run(const Run &other, const Allocator &alloc) :
+            items(other.items, alloc), head{ other.head } {}
+        Run(Run &&other, const Allocator &alloc) :
+            items(std::move(other.items), alloc), head{ other.head } {}
+        Run(const Run &) = default;
+        Run(Run &&) = default;
+        Run &operator=(const Run &) = default;
+        Run &operator=(Run &&) = default;
+
+        Items items;
+        size_t head = 0;
+
+        size_t size() const { return items.size() - head; }
+        bool empty() const { return head == items.size(); }
+        const TYPE &front() const { return items[head]; }
+
+        // Drops the consumed prefix so more elements can be appended.
+        void compact() {
+            items.erase(items.begin(), items.begin() + static_cast<std::ptrdiff_t>(head));
+            head = 0;
+        }
+
+        // Drops the unconsumed elements matching 'pred', keeping the order.
+        template<typename Predicate>
+        void removeIf(Predicate &pred) {
+            items.erase(std::remove_if(items.begin() + static_cast<std::ptrdiff_t>(head), items.end(), pred),
+                        items.end());
+        }
+
+        void moveTo(Items &out) {
+            std::move(items.begin() + static_cast<std::ptrdiff_t>(head), items.end(),
+                      std::back_inserter(out));
+            items.clear();
+            head = 0;
+        }
+    }; // Run
+
+    struct Group {
+        using allocator_type = Allocator;
+
+        explicit Group(const Allocator &alloc) : buffer(alloc), runs(alloc) {}
+        Group(const Group &other, const Allocator &alloc) :
+            buffer(other.buffer, alloc), runs(other.runs, alloc) {}
+        Group(Group &&other, const Allocator &alloc) :
+            buffer(std::move(other.buffer), alloc), runs(std::move(other.runs), alloc) {}
+        Group(const Group &) = default;
+        Group(Group &&) = default;
+        Group &operator=(const Group &) = default;
+        Group &operator=(Group &&) = default;
+
+        Run buffer;
+        Vector<Run> runs;
+    }; // Group
+
+    using Sources = Vector<Run*>;
+
+    Allocator allocator() const {
+        return insertHeap.get_allocator();
+    }
+
+    // True when top() is in the insertion heap rather than the deletion
+    // buffer. The deletion buffer is never left empty while a group still
+    // has elements, so an empty buffer means the groups are empty too.
+    bool fromInsertHeap() const {
+        if(deleteBuffer.empty()) return true;
+        if(insertHeap.empty()) return false;
+        return !this->compare(insertHeap.front(), deleteBuffer.front());
+    }
+
+    // Orders a run: the more extreme element goes first.
+    bool before(const TYPE &a, const TYPE &b) const {
+        return this->compare(b, a);
+    }
+
+    // Merges up to 'limit' of the most extreme elements out of 'sources'
+    // onto the end of 'out', consuming them from the runs.
+    void mergeInto(Sources &sources, Items &out, size_t limit) {
+        // Binary heap of the non-empty sources keyed on their fronts, with
+        // the most extreme front on top. After taking an element only the
+        // top source's key changes, so one sift down replaces a pop and push.
+        auto lessExtreme = [this](const Run *a, const Run *b) {
+            return this->compare(a->front(), b->front());
+        };
+        sources.erase(std::remove_if(sources.begin(), sources.end(),
+                                     [](const Run *run) { return run->empty(); }),
+                      sources.end());
+        std::make_heap(sources.begin(), sources.end(), lessExtreme);
+        while(limit > 0 && !sources.empty()) {
+            Run *run = sources.front();
+            out.push_back(std::move(run->items[run->head++]));
+            limit--;
+            if(run->empty()) {
+                // the last source takes the emptied one's place at the top
+                run = sources.back();
+                sources.pop_back();
+                if(sources.empty()) break;
+            }
+            size_t index = 0;
+            size_t child = 1;
+            while(child < sources.size()) {
+                if(child + 1 < sources.size() && lessExtreme(sources[child], sources[child + 1])) {
+                    child++;
+                }
+                if(!lessExtreme(run, sources[child])) break;
+                sources[index] = sources[child];
+                index = child;
+                child = (2*index) + 1;
+            }
+            sources[index] = run;
+        }
+    }
+
+    // Splits a sorted sequence into the first 'length' elements, which
+    // replace 'front', and the rest, which are returned as a run.
+    Run splitOff(Items &&merged, Run &front, size_t length) {
+        Run rest(allocator());
+        front.items.assign(std::make_move_iterator(merged.begin()),
+                           std::make_move_iterator(merged.begin() + static_cast<std::ptrdiff_t>(length)));
+        front.head = 0;
+        rest.items.assign(std::make_move_iterator(merged.begin() + static_cast<std::ptrdiff_t>(length)),
+                          std::make_move_iterator(merged.end()));
+        return rest;
+    }
+
+    // Sorts the full insertion heap into a run and adds it to group 0. The
+    // new run may hold elements more extreme than the deletion buffer or
+    // group 0's buffer, so all three are merged and dealt back out with the
+    // buffers keeping their sizes.
+    void flushInsertHeap() {
+        Run run(allocator());
+        run.items.swap(insertHeap);
+        insertHeap.reserve(BUFFER_SIZE);
+        std::sort(run.items.begin(), run.items.end(),
+                  [this](const TYPE &a, const TYPE &b) { return before(a, b); });
+
+        if(groups.empty()) {
+            groups.push_back(Group(allocator()));
+        }
+        Run &groupBuffer = groups[0].buffer;
+        size_t deleteSize = deleteBuffer.size();
+        size_t groupSize = groupBuffer.size();
+
+        Items merged(allocator());
+        merged.reserve(run.size() + deleteSize + groupSize);
+        Sources sources({ &run, &deleteBuffer, &groupBuffer }, allocator());
+        mergeInto(sources, merged, merged.capacity());
+
+        Run rest = splitOff(std::move(merged), deleteBuffer, deleteSize);
+        rest = splitOff(std::move(rest.items), groupBuffer, groupSize);
+        addRun(0, std::move(rest));
+
+        if(deleteBuffer.empty()) {
+            refillDeleteBuffer();
+        }
+    }
+
+    // Adds a run to group 'level'. A group that already has ARITY runs
+    // first merges them into one run for the next group.
+    void addRun(size_t level, Run &&run) {
+        if(run.empty()) return;
+        if(groups.size() == level) {
+            groups.push_back(Group(allocator()));
+        }
+        if(groups[level].runs.size() == ARITY) {
+            Sources sources(allocator());
+            size_t total = 0;
+            for(Run &old : groups[level].runs) {
+                sources.push_back(&old);
+                total += old.size();
+            }
+            Run merged(allocator());
+            merged.items.reserve(total);
+            mergeInto(sources, merged.items, total);
+            groups[level].runs.clear();
+            promoteRun(level + 1, std::move(merged));
+        }
+        groups[level].runs.push_back(std::move(run));
+    }
+
+    // Moves a run up into group 'level', first merging it with that group's
+    // buffer so the buffer still holds the group's most extreme elements.
+    void promoteRun(size_t level, Run &&run) {
+        if(groups.size() == level) {
+            groups.push_back(Group(allocator()));
+        }
+        Run &groupBuffer = groups[level].buffer;
+        size_t groupSize = groupBuffer.size();
+        if(groupSize != 0) {
+            Items merged(allocator());
+            merged.reserve(run.size() + groupSize);
+            Sources sources({ &run, &groupBuffer }, allocator());
+            mergeInto(sources, merged, merged.capacity());
+            run = splitOff(std::move(merged), groupBuffer, groupSize);
+        }
+        addRun(level, std::move(run));
+    }
+
+    // Tops a group buffer up to BUFFER_SIZE from the group's runs. The new
+    // elements are no more extreme than any already buffered, so they go on
+    // the end.
+    void refillGroupBuffer(Group &group) {
+        if(group.runs.empty()) return;
+        group.buffer.compact();
+        Sources sources(allocator());
+        for(Run &run : group.runs) {
+            sources.push_back(&run);
+        }
+        mergeInto(sources, group.buffer.items, BUFFER_SIZE - group.buffer.size());
+        group.runs.erase(std::remove_if(group.runs.begin(), group.runs.end(),
+                                        [](const Run &run) { return run.empty(); }),
+                         group.runs.end());
+    }
+
+    // Refills the empty deletion buffer with the BUFFER_SIZE most extreme
+    // elements of all groups. Each group buffer is first topped up so that
+    // it either holds BUFFER_SIZE elements or its group has no runs left;
+    // that way nothing still sitting in a run can beat what is taken.
+    void refillDeleteBuffer() {
+        Sources sources(allocator());
+        for(Group &group : groups) {
+            if(group.buffer.size() < BUFFER_SIZE) {
+                refillGroupBuffer(group);
+            }
+            sources.push_back(&group.buffer);
+        }
+        deleteBuffer.items.clear();
+        deleteBuffer.head = 0;
+        mergeInto(sources, deleteBuffer.items, BUFFER_SIZE);
+        while(!groups.empty() && groups.back().buffer.empty() && groups.back().runs.empty()) {
+            groups.pop_back();
+        }
+    }
+
+    // Replaces the (empty) structure with 'elements' as one sorted run in
+    // the group whose runs are about that long.
+    void rebuild(Items &elements) {
+        count = elements.size();
+        insertHeap.reserve(BUFFER_SIZE);
+        if(elements.empty()) return;
+        std::sort(elements.begin(), elements.end(),
+                  [this](const TYPE &a, const TYPE &b) { return before(a, b); });
+        size_t level = 0;
+        for(size_t length = BUFFER_SIZE * ARITY; length < elements.size(); length *= ARITY) {
+            level++;
+        }
+        while(groups.size() <= level) {
+            groups.push_back(Group(allocator()));
+        }
+        Run run(allocator());
+        run.items.swap(elements);
+        groups[level].runs.push_back(std::move(run));
+        refillDeleteBuffer();
+    }
+
+    Items insertHeap;
+    Run deleteBuffer;
+    Vector<Group> groups;
+    size_t count;
+}; // SequenceHeapPQ
+
+
+namespace pmr {
+    // SequenceHeapPQ drawing its runs and buffers from a
+    // std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using SequenceHeapPQ =
+        ::SequenceHeapPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // SEQUENCEHEAPPQ_H
@@ -0,0 +1,739 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SHAREDMEMORYPQ_H
+#define SHAREDMEMORYPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A binary heap kept in a shared memory region, so that several processes
+// on one host can push to and pop from the same PQ directly instead of
+// sending elements to one owner over pipes.
+//
+// The region is a header followed by capacity + 1 slots of TYPE, and it
+// holds no pointers: each process maps it wherever mmap() puts it and finds
+// the slots at a fixed offset from the header. TYPE must therefore be
+// trivially copyable, and pointers inside it mean nothing to another
+// process. The capacity is fixed when the region is made; push() waits for
+// room when the PQ is full.
+//
+// create(name, capacity) makes a POSIX shared memory object of
+// bytesFor(capacity) bytes, attach(name) maps an existing one after checking
+// it was made for the same element size, and unlink(name) removes the
+// name. The constructors instead make an anonymous shared mapping, which is
+// shared with every child fork()ed after it is built. All processes must
+// order elements with the same comparator.
+//
+// One process-shared robust mutex guards the heap, with process-shared
+// condition variables to wait for elements or for room. If a process dies
+// holding the mutex, the next one to lock it repairs the region first. That
+// is possible because every sift carries a hole: the element being placed
+// waits in the last slot, the header records which slot is the hole, and the
+// element count shares one word with a "sift pending" bit so both change in
+// a single store. Writing the waiting element into the hole and rebuilding
+// the heap always leaves the right elements, so an operation the dead
+// process was in has either completed or never happened.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+class SharedMemoryPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(std::is_trivially_copyable<TYPE>::value,
+                  "SharedMemoryPQ copies elements between processes as bytes");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "the shared header needs lock-free 64-bit atomics");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY = std::size_t{ 1 } << 16;
+
+    // Description: The size of the region holding up to 'capacity' elements.
+    // Runtime: O(1)
+    static std::size_t bytesFor(std::size_t capacity) {
+        return SLOTS_OFFSET + (capacity + 1) * sizeof(TYPE);
+    } // bytesFor()
+
+
+    // Description: Create the shared memory object 'name' (a POSIX name such
+    //              as "/jobs"), sized for 'capacity' elements, and map it.
+    //              Throws std::system_error if the name already exists or
+    //              the object cannot be made.
+    // Runtime: O(1)
+    static SharedMemoryPQ create(const std::string &name, std::size_t capacity,
+                                 COMP_FUNCTOR comp = COMP_FUNCTOR()) {
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if(fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        }
+        std::size_t bytes = bytesFor(capacity);
+        void *base = MAP_FAILED;
+        int err = 0;
+        if(ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            err = errno;
+        }
+        else {
+            base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            err = errno;
+        }
+        ::close(fd);
+        if(base == MAP_FAILED) {
+            shm_unlink(name.c_str());
+            throw std::system_error(err, std::generic_category(), "mapping " + name);
+        }
+        SharedMemoryPQ pq{ Mapping{ base, bytes }, comp };
+        try {
+            pq.initialize(capacity);
+        }
+        catch(...) {
+            shm_unlink(name.c_str());
+            throw;
+        }
+        return pq;
+    } // create()
+
+
+    // Description: Map the shared memory object 'name' made by create().
+    //              Throws std::system_error if it cannot be opened, and
+    //              std::runtime_error if it does not hold a SharedMemoryPQ of
+    //              this element size.
+    // Runtime: O(1)
+    static SharedMemoryPQ attach(const std::string &name, COMP_FUNCTOR comp = COMP_FUNCTOR()) {
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if(fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        }
+        struct stat info;
+        if(fstat(fd, &info) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "fstat " + name);
+        }
+        std::size_t bytes = static_cast<std::size_t>(info.st_size);
+        if(bytes < SLOTS_OFFSET) {
+            ::close(fd);
+            throw std::runtime_error(name + " is not a SharedMemoryPQ");
+        }
+        void *base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int err = errno;
+        ::close(fd);
+        if(base == MAP_FAILED) {
+            throw std::system_error(err, std::generic_category(), "mmap " + name);
+        }
+
+        SharedMemoryPQ pq{ Mapping{ base, bytes }, comp };
+        const Header &h = *pq.header;
+        if(h.magic.load(std::memory_order_acquire) != MAGIC || h.version != VERSION) {
+            throw std::runtime_error(name + " is not a SharedMemoryPQ");
+        }
+        if(h.eltSize != sizeof(TYPE) || bytes < bytesFor(h.capacity)) {
+            throw std::runtime_error(name + " holds a different element type");
+        }
+        return pq;
+    } // attach()
+
+
+    // Description: Remove the name of a shared memory object. Processes that
+    //              have it mapped keep using it; it is freed when the last
+    //              one unmaps it. Returns false if there was no such name.
+    // Runtime: O(1)
+    static bool unlink(const std::string &name) {
+        return shm_unlink(name.c_str()) == 0;
+    } // unlink()
+
+
+    // Description: Construct an empty PQ in a new anonymous shared mapping,
+    //              shared with child processes forked after this.
+    // Runtime: O(1)
+    explicit SharedMemoryPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                            std::size_t capacity = DEFAULT_CAPACITY) :
+        SharedMemoryPQ{ mapAnonymous(bytesFor(capacity)), comp } {
+        initialize(capacity);
+    } // SharedMemoryPQ()
+
+
+    // Description: Construct a PQ out of an iterator range in a new
+    //              anonymous shared mapping, with room for at least
+    //              DEFAULT_CAPACITY elements. A single-pass range, such as
+    //              one read through std::istream_iterator, is collected
+    //              into a temporary first, as sizing the region from it
+    //              would consume it.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    SharedMemoryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
+        SharedMemoryPQ{ start, end, comp,
+                        typename std::iterator_traits<InputIterator>::iterator_category() } {
+    } // SharedMemoryPQ()
+
+
+    // Description: Copy constructor. The copy is a new anonymous region of
+    //              the same capacity, not another view of 'other's.
+    // Runtime: O(n)
+    SharedMemoryPQ(const SharedMemoryPQ &other) :
+        SharedMemoryPQ{ other.compare, other.capacity() } {
+        Guard guard{ other };
+        std::uint64_t n = other.count();
+        std::copy(other.slots, other.slots + n, slots);
+        header->state.store(n, std::memory_order_relaxed);
+    } // SharedMemoryPQ()
+
+
+    // Description: Move constructor. 'other' is left without a region and
+    //              may only be destroyed or assigned to.
+    // Runtime: O(1)
+    SharedMemoryPQ(SharedMemoryPQ &&other) noexcept :
+        BaseClass{ other.compare }, header{ other.header }, slots{ other.slots },
+        mappedBytes{ other.mappedBytes } {
+        other.header = nullptr;
+        other.slots = nullptr;
+        other.mappedBytes = 0;
+    } // SharedMemoryPQ()
+
+
+    // Description: Copy assignment; this PQ gets a new region holding a copy.
+    // Runtime: O(n)
+    SharedMemoryPQ &operator=(const SharedMemoryPQ &rhs) {
+        SharedMemoryPQ temp{ rhs };
+        swap(temp);
+        return *this;
+    } // operator=()
+
+
+    SharedMemoryPQ &operator=(SharedMemoryPQ &&rhs) noexcept {
+        swap(rhs);
+        return *this;
+    } // operator=()
+
+
+    // Description: Unmaps the region. A named region keeps its contents
+    //              until it is unlinked and no process has it mapped.
+    virtual ~SharedMemoryPQ() {
+        if(header != nullptr) {
+            munmap(header, mappedBytes);
+        }
+    } // ~SharedMemoryPQ()
+
+
+    // Description: Rebuild the heap from scratch.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        Guard guard{ *this };
+        heapify();
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ, waiting while it is full.
+    // Runtime: O(log(n))
+    virtual void push(const TYPE &val) {
+        Guard guard{ *this };
+        while(count() == header->capacity) {
+            wait(header->notFull);
+        }
+        pushLocked(val);
+        pthread_cond_signal(&header->notEmpty);
+    } // push()
+
+
+    // Description: Add every element of a range under one lock, waiting for
+    //              room whenever the PQ fills, which lets other processes
+    //              pop in between. Producers with several elements ready
+    //              should push them this way.
+    // Runtime: O(k log(n)) for k elements.
+    template<typename InputIterator>
+    void pushRange(InputIterator start, InputIterator end) {
+        Guard guard{ *this };
+        for(; start != end; ++start) {
+            while(count() == header->capacity) {
+                pthread_cond_broadcast(&header->notEmpty);
+                wait(header->notFull);
+            }
+            pushLocked(*start);
+        }
+        pthread_cond_broadcast(&header->notEmpty);
+    } // pushRange()
+
+
+    // Description: Add a new element unless the PQ is full. Returns whether
+    //              it was added.
+    // Runtime: O(log(n))
+    bool tryPush(const TYPE &val) {
+        Guard guard{ *this };
+        if(count() == header->capacity) {
+            return false;
+        }
+        pushLocked(val);
+        pthread_cond_signal(&header->notEmpty);
+        return true;
+    } // tryPush()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ. Does nothing if the PQ is empty, which
+    //              another process may have made it.
+    // Runtime: O(log(n))
+    virtual void pop() {
+        Guard guard{ *this };
+        if(count() == 0) {
+            return;
+        }
+        popLocked();
+        pthread_cond_signal(&header->notFull);
+    } // pop()
+
+
+    // Description: Copy the most extreme element to 'out' and remove it,
+    //              under one lock, unless the PQ is empty. Returns whether
+    //              an element was popped. Unlike top() followed by pop(),
+    //              no other process can pop in between.
+    // Runtime: O(log(n))
+    bool tryPop(TYPE &out) {
+        Guard guard{ *this };
+        if(count() == 0) {
+            return false;
+        }
+        out = slots[0];
+        popLocked();
+        pthread_cond_signal(&header->notFull);
+        return true;
+    } // tryPop()
+
+
+    // Description: Like tryPop(), but waits for an element while the PQ is
+    //              empty and open. Returns false once it is closed and
+    //              empty.
+    // Runtime: O(log(n)) plus the wait.
+    bool waitPop(TYPE &out) {
+        Guard guard{ *this };
+        while(count() == 0 && header->closed == 0) {
+            wait(header->notEmpty);
+        }
+        if(count() == 0) {
+            return false;
+        }
+        out = slots[0];
+        popLocked();
+        pthread_cond_signal(&header->notFull);
+        return true;
+    } // waitPop()
+
+
+    // Description: Like pop_k(), but waits for an element while the PQ is
+    //              empty and open, then pops up to k without waiting for
+    //              more. Returns 'out' unchanged once it is closed and empty.
+    // Runtime: O(k log(n)) plus the wait.
+    template<typename OutputIterator>
+    OutputIterator waitPop_k(std::size_t k, OutputIterator out) {
+        Guard guard{ *this };
+        while(count() == 0 && header->closed == 0) {
+            wait(header->notEmpty);
+        }
+        for(k = std::min<std::size_t>(k, count()); k > 0; --k) {
+            *out++ = slots[0];
+            popLocked();
+        }
+        pthread_cond_broadcast(&header->notFull);
+        return out;
+    } // waitPop_k()
+
+
+    // Description: Mark the PQ closed, for producers to tell consumers no
+    //              more elements are coming, and wake every waitPop().
+    //              Pushing is still allowed.
+    // Runtime: O(1)
+    void close() {
+        Guard guard{ *this };
+        header->closed = 1;
+        pthread_cond_broadcast(&header->notEmpty);
+    } // close()
+
+
+    // Description: Return true once close() has been called on the region.
+    // Runtime: O(1)
+    bool closed() const {
+        Guard guard{ *this };
+        return header->closed != 0;
+    } // closed()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ. The reference is into the shared region, so it
+    //              changes if another process pushes or pops; use tryPop()
+    //              to take the top element safely while others do.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return slots[0];
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count() == 0;
+    } // empty()
+
+
+    // Description: The most elements the region can hold.
+    // Runtime: O(1)
+    std::size_t capacity() const {
+        return header->capacity;
+    } // capacity()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order, under one lock.
+    // Runtime: O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        Guard guard{ *this };
+        for(k = std::min<std::size_t>(k, count()); k > 0; --k) {
+            *out++ = slots[0];
+            popLocked();
+        }
+        pthread_cond_broadcast(&header->notFull);
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order, under one lock.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(std::numeric_limits<std::size_t>::max(), out);
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true, under
+    //              one lock, and return how many were removed. The last
+    //              element takes each removed one's slot through the hole,
+    //              so a process that dies partway leaves a region that
+    //              repair makes whole, then the heap is rebuilt once.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        Guard guard{ *this };
+        std::size_t removed = 0;
+        for(std::uint64_t i = 0; i < count(); ) {
+            if(!pred(static_cast<const TYPE&>(slots[i]))) {
+                i++;
+                continue;
+            }
+            std::uint64_t n = count() - 1;
+            slots[spare()] = slots[n];
+            setHole(i);
+            setState(n | PENDING);
+            fillHole();
+            setState(n);
+            removed++;
+        }
+        if(removed > 0) {
+            heapify();
+            pthread_cond_broadcast(&header->notFull);
+        }
+        return removed;
+    } // remove_if()
+
+
+    void swap(SharedMemoryPQ &other) noexcept {
+        std::swap(this->compare, other.compare);
+        std::swap(header, other.header);
+        std::swap(slots, other.slots);
+        std::swap(mappedBytes, other.mappedBytes);
+    } // swap()
+
+
+private:
+    static constexpr std::uint64_t MAGIC = 0x5150454d48535032ULL;
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint64_t PENDING = std::uint64_t{ 1 } << 63;
+
+    // The start of the region. Slot 'capacity' holds the element being
+    // sifted while PENDING is set in 'state', and 'hole' is the slot it
+    // belongs in until the sift is done.
+    struct Header {
+        std::atomic<std::uint64_t> magic;
+        std::uint32_t version;
+        std::uint32_t eltSize;
+        std::uint64_t capacity;
+        std::atomic<std::uint64_t> state;   // element count | PENDING
+        std::uint64_t hole;
+        std::uint32_t closed;
+        pthread_mutex_t lock;
+        pthread_cond_t notEmpty;
+        pthread_cond_t notFull;
+    };
+
+    static constexpr std::size_t SLOTS_OFFSET =
+        (sizeof(Header) + alignof(TYPE) - 1) / alignof(TYPE) * alignof(TYPE);
+
+    struct Mapping {
+        void *base;
+        std::size_t bytes;
+    };
+
+    // Holds the region's mutex for a scope.
+    class Guard {
+    public:
+        explicit Guard(const SharedMemoryPQ &pq) : pq{ pq } {
+            pq.checkLock(pthread_mutex_lock(&pq.header->lock), "pthread_mutex_lock");
+        }
+
+        Guard(const Guard &) = delete;
+        Guard &operator=(const Guard &) = delete;
+
+        ~Guard() {
+            pthread_mutex_unlock(&pq.header->lock);
+        }
+
+    private:
+        const SharedMemoryPQ &pq;
+    }; // Guard
+
+    // The mapping is shared state, not part of this object, so the members
+    // below that change only the region are const.
+    Header *header;
+    TYPE *slots;
+    std::size_t mappedBytes;
+
+    SharedMemoryPQ(Mapping mapping, COMP_FUNCTOR comp) :
+        BaseClass{ comp }, header{ static_cast<Header*>(mapping.base) },
+        slots{ reinterpret_cast<TYPE*>(static_cast<unsigned char*>(mapping.base) + SLOTS_OFFSET) },
+        mappedBytes{ mapping.bytes } {
+    }
+
+    // Range construction from a multi-pass range, which can be counted
+    // before it is copied.
+    template<typename ForwardIterator>
+    SharedMemoryPQ(ForwardIterator start, ForwardIterator end, COMP_FUNCTOR comp,
+                   std::forward_iterator_tag) :
+        SharedMemoryPQ{ comp, std::max(DEFAULT_CAPACITY,
+                                       static_cast<std::size_t>(std::distance(start, end))) } {
+        std::uint64_t n = 0;
+        for(; start != end; ++start) {
+            slots[n++] = *start;
+        }
+        header->state.store(n, std::memory_order_relaxed);
+        updatePriorities();
+    }
+
+    template<typename InputIterator>
+    SharedMemoryPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp,
+                   std::input_iterator_tag) :
+        SharedMemoryPQ{ std::vector<TYPE>(start, end), comp } {
+    }
+
+    SharedMemoryPQ(const std::vector<TYPE> &elements, COMP_FUNCTOR comp) :
+        SharedMemoryPQ{ elements.begin(), elements.end(), comp, std::forward_iterator_tag() } {
+    }
+
+    static Mapping mapAnonymous(std::size_t bytes) {
+        void *base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if(base == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        return Mapping{ base, bytes };
+    }
+
+    static void check(int err, const char *what) {
+        if(err != 0) {
+            throw std::system_error(err, std::generic_category(), what);
+        }
+    }
+
+    // Sets up the header of a new, zeroed region. The magic number is
+    // written last, so attach() never accepts a half-built header.
+    void initialize(std::size_t capacity) {
+        if(capacity == 0) {
+            throw std::invalid_argument("a SharedMemoryPQ needs a capacity of at least 1");
+        }
+        new (header) Header;
+        header->version = VERSION;
+        header->eltSize = sizeof(TYPE);
+        header->capacity = capacity;
+        header->state.store(0, std::memory_order_relaxed);
+        header->hole = 0;
+        header->closed = 0;
+
+        pthread_mutexattr_t mutexAttr;
+        check(pthread_mutexattr_init(&mutexAttr), "pthread_mutexattr_init");
+        pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+        int err = pthread_mutex_init(&header->lock, &mutexAttr);
+        pthread_mutexattr_destroy(&mutexAttr);
+        check(err, "pthread_mutex_init");
+
+        pthread_condattr_t condAttr;
+        check(pthread_condattr_init(&condAttr), "pthread_condattr_init");
+        pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+        err = pthread_cond_init(&header->notEmpty, &condAttr);
+        if(err == 0) {
+            err = pthread_cond_init(&header->notFull, &condAttr);
+        }
+        pthread_condattr_destroy(&condAttr);
+        check(err, "pthread_cond_init");
+
+        header->magic.store(MAGIC, std::memory_order_release);
+    }
+
+    // Handles the result of taking the mutex, repairing the region if its
+    // last owner died holding it.
+    void checkLock(int err, const char *what) const {
+        if(err == EOWNERDEAD) {
+            recover();
+            pthread_mutex_consistent(&header->lock);
+            return;
+        }
+        check(err, what);
+    }
+
+    void wait(pthread_cond_t &cond) const {
+        checkLock(pthread_cond_wait(&cond, &header->lock), "pthread_cond_wait");
+    }
+
+    std::uint64_t count() const {
+        return header->state.load(std::memory_order_relaxed) & ~PENDING;
+    }
+
+    std::uint64_t spare() const {
+        return header->capacity;
+    }
+
+    // Keeps the compiler from moving region writes across this point, so a
+    // process that dies at any instruction leaves them in program order.
+    static void commit() {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    void setState(std::uint64_t state) const {
+        header->state.store(state, std::memory_order_relaxed);
+        commit();
+    }
+
+    void setHole(std::uint64_t index) const {
+        header->hole = index;
+        commit();
+    }
+
+    // Fills the hole from slot 'index', which becomes the hole. Between the
+    // two writes the element is in both slots, and the hole still names the
+    // old one, so repair overwrites that copy.
+    void moveHole(std::uint64_t index) const {
+        slots[header->hole] = slots[index];
+        commit();
+        setHole(index);
+    }
+
+    void fillHole() const {
+        slots[header->hole] = slots[spare()];
+        commit();
+    }
+
+    // Moves the hole up while the waiting element is more extreme than the
+    // hole's parent.
+    void siftUp() const {
+        while(header->hole > 0) {
+            std::uint64_t parent = (header->hole - 1)/2;
+            if(!this->compare(slots[parent], slots[spare()])) break;
+            moveHole(parent);
+        }
+    }
+
+    // Moves the hole down while a child is more extreme than the waiting
+    // element, within the first n slots.
+    void siftDown(std::uint64_t n) const {
+        std::uint64_t child = (2*header->hole) + 1;
+        while(child < n) {
+            if(child + 1 < n && this->compare(slots[child], slots[child + 1])) {
+                child++;
+            }
+            if(!this->compare(slots[spare()], slots[child])) break;
+            moveHole(child);
+            child = (2*header->hole) + 1;
+        }
+    }
+
+    // Moves the hole to a leaf along the more extreme children, as
+    // BinaryPQ's bottom-up pop does.
+    void siftDownToLeaf(std::uint64_t n) const {
+        std::uint64_t child = (2*header->hole) + 1;
+        while(child < n) {
+            if(child + 1 < n && this->compare(slots[child], slots[child + 1])) {
+                child++;
+            }
+            moveHole(child);
+            child = (2*header->hole) + 1;
+        }
+    }
+
+    void pushLocked(const TYPE &val) const {
+        std::uint64_t n = count();
+        slots[spare()] = val;
+        setHole(n);
+        setState((n + 1) | PENDING);
+        siftUp();
+        fillHole();
+        setState(n + 1);
+    }
+
+    void popLocked() const {
+        std::uint64_t n = count() - 1;
+        slots[spare()] = slots[n];
+        setHole(0);
+        setState(n | PENDING);
+        siftDownToLeaf(n);
+        siftUp();
+        fillHole();
+        setState(n);
+    }
+
+    void heapify() const {
+        std::uint64_t n = count();
+        for(std::uint64_t i = n/2; i > 0; i--) {
+            slots[spare()] = slots[i - 1];
+            setHole(i - 1);
+            setState(n | PENDING);
+            siftDown(n);
+            fillHole();
+            setState(n);
+        }
+    }
+
+    // Puts back the element a dead process was sifting and rebuilds the
+    // heap, which its sift may have left out of order. Repair is itself
+    // repairable if this process dies too.
+    void recover() const {
+        if((header->state.load(std::memory_order_relaxed) & PENDING) != 0) {
+            fillHole();
+            setState(count());
+        }
+        heapify();
+    }
+}; // SharedMemoryPQ
+
+
+#endif // SHAREDMEMORYPQ_H
@@ -0,0 +1,535 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SHIFTPAIRINGPQ_H
+#define SHIFTPAIRINGPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <deque>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+// A pairing heap over arithmetic keys that can add the same delta to every
+// key of a subtree, shiftSubtree(), or of the whole heap, shift_all(), without
+// touching the nodes below.
+//
+// Each node carries a lazy delta, 'lazy', owed to every node in its subtree
+// but itself: a node's key is its 'elt' plus the lazy deltas of all its
+// ancestors. The root's 'elt' is therefore exact, so top() and meld() only
+// ever compare exact keys and any comparator works. Melding moves the loser
+// under the winner and subtracts the winner's lazy delta from it; pop()
+// pushes the root's lazy delta into its children as it pairs them.
+//
+// Finding a node's key means summing the lazy deltas of its ancestors, so
+// Node::getElt(), updateElt(), erase() and shiftSubtree() of a non-root node
+// walk its back pointers, O(d) where d is the number of ancestors and left
+// siblings between it and the root. Keys are added and subtracted as TYPE,
+// so signed keys must stay clear of overflow; unsigned keys wrap and come
+// back exact.
+//
+// Otherwise laid out as PairingPQ: leftmost-child/right-sibling form, each
+// node's 'prev' pointing at its parent if it is the first child and at its
+// left sibling otherwise.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class ShiftPairingPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(std::is_arithmetic<TYPE>::value, "ShiftPairingPQ needs arithmetic keys");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Each node within the pairing heap
+    class Node {
+        public:
+            explicit Node(const TYPE &val)
+                : elt{ val }, lazy{ 0 }, child{ nullptr }, sibling{ nullptr }, prev{ nullptr }
+            {}
+
+            // Description: The key at that Node's position, with every shift
+            //              applied. Returned by value, as the node only holds
+            //              it relative to its ancestors.
+            // Runtime: O(d), d the length of the node's back pointer chain.
+            TYPE getElt() const { return plus(elt, pendingAbove()); }
+            TYPE operator*() const { return getElt(); }
+
+            friend ShiftPairingPQ;
+
+        private:
+            // The sum of the lazy deltas of this node's ancestors.
+            TYPE pendingAbove() const {
+                TYPE sum = 0;
+                for(const Node* current = this; current->prev != nullptr; current = current->prev) {
+                    if(current->prev->child == current) {
+                        sum = plus(sum, current->prev->lazy);
+                    }
+                }
+                return sum;
+            }
+
+            TYPE elt;
+            // Owed to every node below this one.
+            TYPE lazy;
+            Node *child;
+            Node *sibling;
+            // The parent for a first child, otherwise the left sibling;
+            // nullptr only for the root.
+            Node *prev;
+    }; // Node
+
+private:
+    using NodeAlloc = ReboundAllocator<Allocator, Node>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+    // a node and the sum of its ancestors' lazy deltas
+    using NodeQueue = std::deque<std::pair<Node*, TYPE>,
+                                 ReboundAllocator<Allocator, std::pair<Node*, TYPE>>>;
+
+public:
+    // Description: Construct an empty pairing heap with an optional
+    //              comparison functor.
+    // Runtime: O(1)
+    explicit ShiftPairingPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                            const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, root{ nullptr }, count{ 0 }, nodeAlloc{ alloc } {
+    } // ShiftPairingPQ()
+
+
+    // Description: Construct an empty pairing heap that allocates with
+    //              'alloc'.
+    // Runtime: O(1)
+    explicit ShiftPairingPQ(const Allocator &alloc) :
+        ShiftPairingPQ{ COMP_FUNCTOR(), alloc } {
+    } // ShiftPairingPQ()
+
+
+    // Description: Construct a pairing heap out of an iterator range with an
+    //              optional comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    ShiftPairingPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                   const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, root{ nullptr }, count{ 0 }, nodeAlloc{ alloc } {
+        while(start != end) {
+            addNode(*start);
+            start++;
+        }
+    } // ShiftPairingPQ()
+
+
+    // Description: Copy constructor.
+    // Runtime: O(n)
+    ShiftPairingPQ(const ShiftPairingPQ &other) :
+        ShiftPairingPQ{ other, NodeTraits::select_on_container_copy_construction(other.nodeAlloc) } {
+    } // ShiftPairingPQ()
+
+
+    // Description: Copy constructor that allocates with 'alloc'. The copy
+    //              holds every key with its shifts applied.
+    // Runtime: O(n)
+    ShiftPairingPQ(const ShiftPairingPQ &other, const Allocator &alloc) :
+        BaseClass{ other.compare }, root{ nullptr }, count{ 0 }, nodeAlloc{ alloc } {
+        if(other.root == nullptr) { return; }
+        NodeQueue queue(nodeAlloc);
+        queue.emplace_back(other.root, TYPE(0));
+        while(!queue.empty()) {
+            auto [current, pending] = queue.front(); queue.pop_front();
+            if(current->child != nullptr) { queue.emplace_back(current->child, plus(pending, current->lazy)); }
+            if(current->sibling != nullptr) { queue.emplace_back(current->sibling, pending); }
+            addNode(plus(current->elt, pending));
+        }
+    } // ShiftPairingPQ()
+
+
+    // Description: Copy assignment operator.
+    // Runtime: O(n)
+    ShiftPairingPQ &operator=(const ShiftPairingPQ &rhs) {
+        // built with this heap's allocator, so the nodes can be swapped in
+        ShiftPairingPQ temp(rhs, get_allocator());
+
+        std::swap(count, temp.count);
+        std::swap(root, temp.root);
+
+        return *this;
+    } // operator=()
+
+
+    // Description: Destructor
+    // Runtime: O(n)
+    virtual ~ShiftPairingPQ() {
+        if(root == nullptr) { return; }
+        NodeQueue queue(nodeAlloc);
+        queue.emplace_back(root, TYPE(0));
+        while(!queue.empty()) {
+            Node* current = queue.front().first; queue.pop_front();
+            if(current->child != nullptr) { queue.emplace_back(current->child, TYPE(0)); }
+            if(current->sibling != nullptr) { queue.emplace_back(current->sibling, TYPE(0)); }
+            destroyNode(current);
+        }
+    } // ~ShiftPairingPQ()
+
+
+    // Description: Assumes that all elements inside the pairing heap are out
+    //              of order and 'rebuilds' the pairing heap by fixing the
+    //              pairing heap invariant. Every node's lazy delta is pushed
+    //              into its key on the way. Nodes are never moved or freed.
+    // Runtime: O(n)
+    virtual void updatePriorities() {
+        if(root == nullptr) { return; }
+        NodeQueue queue(nodeAlloc);
+        queue.emplace_back(root, TYPE(0));
+        root = nullptr;
+        while(!queue.empty()) {
+            auto [current, pending] = queue.front(); queue.pop_front();
+            if(current->child != nullptr) { queue.emplace_back(current->child, plus(pending, current->lazy)); }
+            if(current->sibling != nullptr) { queue.emplace_back(current->sibling, pending); }
+            current->elt = plus(current->elt, pending);
+            current->lazy = 0;
+            current->child = nullptr; current->sibling = nullptr; current->prev = nullptr;
+            root = root == nullptr ? current : meld(root, current);
+        }
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the pairing heap.
+    // Runtime: O(1)
+    virtual void push(const TYPE &val) {
+        addNode(val);
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the pairing heap. The root's lazy delta is pushed into
+    //              its children as they are re-paired.
+    // Runtime: Amortized O(log(n))
+    virtual void pop() {
+        Node* child = root->child;
+        TYPE pending = root->lazy;
+        destroyNode(root);
+        root = mergePairs(child, pending);
+        count--;
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the pairing heap.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return root->elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the pairing heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+    // Description: Return true if the pairing heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order.
+    // Runtime: Amortized O(k log(n))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            *out++ = root->elt;
+            ShiftPairingPQ::pop();
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: Amortized O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: Add 'delta' to every key in the pairing heap. The order
+    //              is unchanged, so only the root is touched.
+    // Runtime: O(1)
+    void shift_all(const TYPE &delta) {
+        if(root == nullptr) { return; }
+        root->elt = plus(root->elt, delta);
+        root->lazy = plus(root->lazy, delta);
+    } // shift_all()
+
+
+    // Description: Add 'delta' to the key of 'node' and of every node below
+    //              it, in either direction. Unless it is the root, the node is
+    //              cut out with its subtree, the shift is recorded on it, and
+    //              it is melded with the root; what is below is not visited.
+    //              The subtree is whatever earlier melds put below 'node'.
+    // Runtime: O(d), d the length of the node's back pointer chain.
+    void shiftSubtree(Node* node, const TYPE &delta) {
+        if(node == nullptr) { return; }
+        if(node == root) {
+            shift_all(delta);
+            return;
+        }
+        TYPE pending = plus(node->pendingAbove(), delta);
+        cut(node);
+        node->elt = plus(node->elt, pending);
+        node->lazy = plus(node->lazy, pending);
+        root = meld(root, node);
+    } // shiftSubtree()
+
+
+    // Description: Updates the priority of an element already in the pairing
+    //              heap by replacing the element refered to by the Node with
+    //              new_value. Unless it is the root, the node is cut out with
+    //              its subtree, which keeps the lazy deltas it was owed from
+    //              above, and melded with the root.
+    //
+    // PRECONDITION: The new priority, given by 'new_value' must be more
+    //               extreme (as defined by comp) than the old priority.
+    //
+    // Runtime: O(d), d the length of the node's back pointer chain.
+    void updateElt(Node* node, const TYPE &new_value) {
+        if(node == nullptr) { return; }
+        if(node == root) {
+            node->elt = new_value;
+            return;
+        }
+        TYPE pending = node->pendingAbove();
+        cut(node);
+        node->elt = new_value;
+        node->lazy = plus(node->lazy, pending);
+        root = meld(root, node);
+    } // updateElt()
+
+
+    // Description: Removes the element refered to by 'node' from the pairing
+    //              heap and deletes the node. The node is cut out with its
+    //              subtree, its children are paired as in pop(), and the
+    //              result is melded back with the root.
+    // Runtime: Amortized O(log(n)) plus O(d), d the length of the node's
+    //          back pointer chain.
+    void erase(Node* node) {
+        if(node == root) {
+            ShiftPairingPQ::pop();
+            return;
+        }
+        TYPE pending = plus(node->pendingAbove(), node->lazy);
+        cut(node);
+        Node* rest = mergePairs(node->child, pending);
+        destroyNode(node);
+        if(rest != nullptr) {
+            root = meld(root, rest);
+        }
+        count--;
+    } // erase()
+
+
+    // Description: Removes every element for which 'pred' returns true,
+    //              deleting its node, and returns how many were removed.
+    //              'pred' sees each key with its shifts applied. As in
+    //              PairingPQ, matching nodes are cut out, their children are
+    //              settled and filtered as subtrees of their own, and the
+    //              kept subtree roots are paired once.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        if(root == nullptr) { return 0; }
+        // exact subtree roots cut loose and not yet filtered, and kept
+        // nodes with what their children are owed
+        NodeQueue loose(nodeAlloc);
+        NodeQueue kept(nodeAlloc);
+        Node* survivors = nullptr;
+        std::size_t removed = 0;
+        loose.emplace_back(root, TYPE(0));
+        while(!loose.empty()) {
+            Node* node = loose.back().first; loose.pop_back();
+            if(pred(node->elt)) {
+                loosen(node, node->lazy, loose);
+                removed++;
+                continue;
+            }
+            node->sibling = survivors;
+            survivors = node;
+            kept.emplace_back(node, node->lazy);
+            while(!kept.empty()) {
+                auto [parent, owed] = kept.back(); kept.pop_back();
+                for(Node* child = parent->child; child != nullptr; ) {
+                    Node* next = child->sibling;
+                    if(pred(plus(child->elt, owed))) {
+                        cut(child);
+                        loosen(child, plus(owed, child->lazy), loose);
+                        removed++;
+                    }
+                    else {
+                        kept.emplace_back(child, plus(owed, child->lazy));
+                    }
+                    child = next;
+                }
+            }
+        }
+        root = mergePairs(survivors, TYPE(0));
+        count -= removed;
+        return removed;
+    } // remove_if()
+
+
+    // Description: Add a new element to the pairing heap. Returns a Node*
+    //              corresponding to the newly added element, valid until
+    //              the element is popped or erased.
+    // Runtime: O(1)
+    Node* addNode(const TYPE &val) {
+        Node *newNode = makeNode(val);
+        root = root == nullptr ? newNode : meld(root, newNode);
+        count++;
+        return newNode;
+    } // addNode()
+
+
+    // Description: The allocator the pairing heap was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(nodeAlloc);
+    } // get_allocator()
+
+
+private:
+    // Keys and deltas are added as TYPE, so small integral types don't
+    // promote to int and back.
+    static TYPE plus(TYPE a, TYPE b) {
+        return static_cast<TYPE>(a + b);
+    }
+
+    static TYPE minus(TYPE a, TYPE b) {
+        return static_cast<TYPE>(a - b);
+    }
+
+    Node* makeNode(const TYPE &val) {
+        Node* node = NodeTraits::allocate(nodeAlloc, 1);
+        try {
+            NodeTraits::construct(nodeAlloc, node, val);
+        }
+        catch(...) {
+            NodeTraits::deallocate(nodeAlloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroyNode(Node* node) {
+        NodeTraits::destroy(nodeAlloc, node);
+        NodeTraits::deallocate(nodeAlloc, node, 1);
+    }
+
+    // Makes a node owed 'pending' from above exact, as a root.
+    static void settle(Node* node, TYPE pending) {
+        node->elt = plus(node->elt, pending);
+        node->lazy = plus(node->lazy, pending);
+        node->prev = nullptr;
+    }
+
+    // Deletes a detached node whose children are owed 'owed', settling each
+    // child and adding it to 'loose' as a subtree of its own.
+    void loosen(Node* node, TYPE owed, NodeQueue &loose) {
+        Node* child = node->child;
+        while(child != nullptr) {
+            Node* next = child->sibling;
+            child->sibling = nullptr;
+            settle(child, owed);
+            loose.emplace_back(child, TYPE(0));
+            child = next;
+        }
+        destroyNode(node);
+    }
+
+    // Two-pass pairing of a sibling list whose nodes are all owed 'pending',
+    // done in place as in PairingPQ; the first pass settles each node before
+    // melding it. Returns the new root, or nullptr for an empty list.
+    Node* mergePairs(Node* first, TYPE pending) {
+        Node* pairs = nullptr;
+        while(first != nullptr) {
+            Node* a = first;
+            Node* b = a->sibling;
+            settle(a, pending);
+            if(b == nullptr) {
+                a->sibling = pairs;
+                pairs = a;
+                break;
+            }
+            first = b->sibling;
+            a->sibling = nullptr;
+            b->sibling = nullptr;
+            settle(b, pending);
+            Node* melded = meld(a, b);
+            melded->sibling = pairs;
+            pairs = melded;
+        }
+
+        if(pairs == nullptr) { return nullptr; }
+        Node* result = pairs;
+        pairs = pairs->sibling;
+        result->sibling = nullptr;
+        while(pairs != nullptr) {
+            Node* next = pairs->sibling;
+            pairs->sibling = nullptr;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        return result;
+    }
+
+    // Unlinks a non-root node, together with its subtree, from its parent's
+    // child list. The caller settles what the node was owed from above.
+    void cut(Node* node) {
+        if(node->prev->child == node) {
+            node->prev->child = node->sibling;
+        }
+        else {
+            node->prev->sibling = node->sibling;
+        }
+        if(node->sibling != nullptr) {
+            node->sibling->prev = node->prev;
+        }
+        node->sibling = nullptr;
+        node->prev = nullptr;
+    }
+
+    // returns a new root node which melded the two inputs; both must be
+    // exact roots (no prev or sibling)
+    Node* meld(Node* pq1Root, Node* pq2Root) {
+        if(this->compare(pq1Root->elt, pq2Root->elt)) {
+            std::swap(pq1Root, pq2Root);
+        }
+        // pq2 goes under pq1, whose lazy delta it must not pick up
+        pq2Root->elt = minus(pq2Root->elt, pq1Root->lazy);
+        pq2Root->lazy = minus(pq2Root->lazy, pq1Root->lazy);
+        pq2Root->sibling = pq1Root->child;
+        if(pq1Root->child != nullptr) {
+            pq1Root->child->prev = pq2Root;
+        }
+        pq2Root->prev = pq1Root;
+        pq1Root->child = pq2Root;
+        return pq1Root;
+    }
+
+    Node* root;
+    size_t count;
+    NodeAlloc nodeAlloc;
+}; // ShiftPairingPQ
+
+
+namespace pmr {
+    // ShiftPairingPQ drawing its nodes from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using ShiftPairingPQ = ::ShiftPairingPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // SHIFTPAIRINGPQ_H
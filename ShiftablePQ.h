@@ -0,0 +1,186 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SHIFTABLEPQ_H
+#define SHIFTABLEPQ_H
+
+#include "Eecs281PQ.h"
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Any of the PQ implementations over arithmetic keys, e.g.
+// ShiftablePQ<BinaryPQ, int>, with shift_all(delta), which adds delta to
+// every key held in O(1). Aging policies that raise every queued priority
+// by the same amount can use it instead of changing each key and calling
+// updatePriorities(), since such a shift never changes the order.
+//
+// The underlying PQ stores each key minus a queue-wide base, and
+// shift_all() only moves the base. top() adds the base back; keys pushed
+// later are stored against the base at that time, so a shift affects only
+// the keys already held. Integral keys are stored as 64-bit signed offsets,
+// so unsigned keys pushed below the base still order correctly; every key
+// minus the base must fit in an int64_t. Floating keys are stored as TYPE
+// and lose precision as the base grows far from the keys.
+//
+// Only std::less and std::greater (typed or transparent) are allowed, as
+// the order has to survive subtracting the base. The underlying PQ
+// allocates with Allocator rebound to Offset.
+template<template<typename...> typename PQ, typename TYPE,
+         typename COMP_FUNCTOR = std::less<TYPE>, typename Allocator = std::allocator<TYPE>>
+class ShiftablePQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    static_assert(std::is_arithmetic<TYPE>::value, "ShiftablePQ needs arithmetic keys");
+
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    static constexpr bool GREATER = std::is_same<COMP_FUNCTOR, std::greater<TYPE>>::value
+        || std::is_same<COMP_FUNCTOR, std::greater<>>::value;
+    static_assert(GREATER || std::is_same<COMP_FUNCTOR, std::less<TYPE>>::value
+                  || std::is_same<COMP_FUNCTOR, std::less<>>::value,
+                  "ShiftablePQ orders keys with std::less or std::greater");
+
+public:
+    using allocator_type = Allocator;
+
+    // What the underlying PQ stores: a key minus the base.
+    using Offset = std::conditional_t<std::is_floating_point<TYPE>::value, TYPE, std::int64_t>;
+
+private:
+    using OffsetComp = std::conditional_t<GREATER, std::greater<Offset>, std::less<Offset>>;
+    using OffsetAlloc = ReboundAllocator<Allocator, Offset>;
+    using OffsetVector = std::vector<Offset, OffsetAlloc>;
+    using Impl = PQ<Offset, OffsetComp, OffsetAlloc>;
+
+public:
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: That of the underlying PQ.
+    explicit ShiftablePQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, impl{ OffsetComp(), OffsetAlloc(alloc) }, base{ 0 }, absoluteTop{} {
+    } // ShiftablePQ()
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: That of the underlying PQ.
+    explicit ShiftablePQ(const Allocator &alloc) :
+        ShiftablePQ{ COMP_FUNCTOR(), alloc } {
+    } // ShiftablePQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor.
+    // Runtime: That of the underlying PQ's range constructor.
+    template<typename InputIterator>
+    ShiftablePQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                const Allocator &alloc = Allocator()) :
+        ShiftablePQ{ OffsetVector(start, end, OffsetAlloc(alloc)), comp } {
+    } // ShiftablePQ()
+
+
+    // Description: Destructor doesn't need any code, the keys are owned by
+    //              'impl'.
+    virtual ~ShiftablePQ() {
+    } // ~ShiftablePQ()
+
+
+    // Description: Assumes that all elements inside the PQ are out of order
+    //              and 'rebuilds' it.
+    // Runtime: That of the underlying PQ.
+    virtual void updatePriorities() {
+        impl.updatePriorities();
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: That of the underlying PQ.
+    virtual void push(const TYPE &val) {
+        impl.push(static_cast<Offset>(static_cast<Offset>(val) - base));
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ.
+    // Runtime: That of the underlying PQ.
+    virtual void pop() {
+        impl.pop();
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ, with every shift since it was pushed applied. The
+    //              reference is to a copy that the next call to top()
+    //              overwrites.
+    // Runtime: That of the underlying PQ.
+    virtual const TYPE &top() const {
+        absoluteTop = static_cast<TYPE>(impl.top() + base);
+        return absoluteTop;
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return impl.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return impl.empty();
+    } // empty()
+
+
+    // Description: Add 'delta' to every key held. Keys pushed afterwards
+    //              are not shifted.
+    // Runtime: O(1)
+    void shift_all(Offset delta) {
+        base += delta;
+    } // shift_all()
+
+
+    // Description: Remove every element for which 'pred' returns true with
+    //              the underlying PQ's remove_if(), returning how many.
+    //              'pred' sees each key with every shift applied.
+    // Runtime: That of the underlying PQ's remove_if().
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        return impl.remove_if([this, &pred](const Offset &offset) {
+            return static_cast<bool>(pred(static_cast<TYPE>(offset + base)));
+        });
+    } // remove_if()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(impl.get_allocator());
+    } // get_allocator()
+
+
+private:
+    ShiftablePQ(OffsetVector &&offsets, COMP_FUNCTOR comp) :
+        BaseClass{ comp },
+        impl{ std::make_move_iterator(offsets.begin()), std::make_move_iterator(offsets.end()),
+              OffsetComp(), offsets.get_allocator() },
+        base{ 0 }, absoluteTop{} {
+    }
+
+    Impl impl;
+    Offset base;
+    mutable TYPE absoluteTop;
+}; // ShiftablePQ
+
+
+namespace pmr {
+    // ShiftablePQ drawing its storage from a std::pmr::memory_resource.
+    template<template<typename...> typename PQ, typename TYPE,
+             typename COMP_FUNCTOR = std::less<TYPE>>
+    using ShiftablePQ =
+        ::ShiftablePQ<PQ, TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // SHIFTABLEPQ_H
@@ -0,0 +1,501 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef SOFTHEAPPQ_H
+#define SOFTHEAPPQ_H
+
+#include "Eecs281PQ.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// An approximate priority queue: Kaplan and Zwick's simplified soft heap.
+// In exchange for pops that may come slightly out of order, push and pop
+// cost amortized O(log(1/epsilon)), a constant that does not grow with the
+// number of elements.
+//
+// Elements sit in lists at the nodes of binary trees. A node treats every
+// element in its list as if it were the node's 'ckey', which is at least as
+// extreme as each of them. Trees are heap-ordered by ckey, and their roots
+// are kept one per rank, like the digits of a binary counter. top() is an
+// element of the root with the most extreme ckey, found through a suffix
+// "best root" table. Nodes of rank above r = ceil(log2(1/epsilon)) + 5 may
+// hold several elements; when a node refills its list from a child, its
+// elements take on the child's less extreme ckey and are corrupted: they
+// are popped later than their own value says they should be. At most
+// epsilon * (pushes since construction or updatePriorities()) elements are
+// corrupted at any time, and while fewer than 2^(r+1) elements have been
+// pushed, none are, so the PQ is exact.
+//
+// corrupted() counts the elements held now whose value is more extreme than
+// their node's ckey, and corruptedPops() those popped so far. Items and
+// nodes live in two pools linked by 32-bit indices, as in CompactPairingPQ,
+// using Allocator rebound to their types.
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
+class SoftHeapPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    using Index = std::uint32_t;
+    static constexpr Index NIL = std::numeric_limits<Index>::max();
+
+    // An element in the list of the node holding it; a free item is linked
+    // into the free list through 'next' as well.
+    struct Item {
+        TYPE elt;
+        Index next;
+    };
+
+    // A tree node and its list of items. A free node is linked into the
+    // free list through 'left'.
+    struct Node {
+        TYPE ckey;
+        Index left;
+        Index right;
+        Index head;
+        Index tail;
+        std::uint32_t listSize;
+        std::uint32_t rank;
+    };
+
+    template<typename T>
+    using Vector = std::vector<T, ReboundAllocator<Allocator, T>>;
+
+public:
+    using allocator_type = Allocator;
+
+    // Exact for the first 2^13 pushes.
+    static constexpr double DEFAULT_EPSILON = 0.01;
+
+    // Description: Construct an empty soft heap with error rate
+    //              DEFAULT_EPSILON and an optional comparison functor.
+    // Runtime: O(1)
+    explicit SoftHeapPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                        const Allocator &alloc = Allocator()) :
+        SoftHeapPQ{ DEFAULT_EPSILON, comp, alloc } {
+    } // SoftHeapPQ()
+
+
+    // Description: Construct an empty soft heap that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit SoftHeapPQ(const Allocator &alloc) :
+        SoftHeapPQ{ DEFAULT_EPSILON, COMP_FUNCTOR(), alloc } {
+    } // SoftHeapPQ()
+
+
+    // Description: Construct an empty soft heap that corrupts at most
+    //              'epsilon' of the elements pushed, 0 < epsilon <= 1.
+    //              Throws std::invalid_argument for any other epsilon.
+    // Runtime: O(1)
+    explicit SoftHeapPQ(double epsilon, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                        const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, items(alloc), nodes(alloc), roots(alloc), best(alloc),
+        freeItems{ NIL }, freeNodes{ NIL }, count{ 0 }, corruptedPopCount{ 0 },
+        errorRate{ epsilon } {
+        if(!(epsilon > 0 && epsilon <= 1)) {
+            throw std::invalid_argument("SoftHeapPQ needs 0 < epsilon <= 1");
+        }
+        std::uint64_t exactRank = static_cast<std::uint64_t>(std::ceil(std::log2(1 / epsilon))) + 5;
+        std::uint64_t target = 1;
+        for(std::size_t rank = 0; rank < targets.size(); ++rank) {
+            if(rank > exactRank) {
+                target = std::min<std::uint64_t>((3*target + 1)/2, NIL);
+            }
+            targets[rank] = static_cast<std::uint32_t>(target);
+        }
+    } // SoftHeapPQ()
+
+
+    // Description: Construct a soft heap out of an iterator range with an
+    //              optional comparison functor.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    SoftHeapPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+               const Allocator &alloc = Allocator()) :
+        SoftHeapPQ{ DEFAULT_EPSILON, comp, alloc } {
+        while(start != end) {
+            push(*start);
+            start++;
+        }
+    } // SoftHeapPQ()
+
+
+    // Description: Construct a soft heap with error rate 'epsilon' out of an
+    //              iterator range.
+    // Runtime: O(n) where n is number of elements in range.
+    template<typename InputIterator>
+    SoftHeapPQ(InputIterator start, InputIterator end, double epsilon,
+               COMP_FUNCTOR comp = COMP_FUNCTOR(), const Allocator &alloc = Allocator()) :
+        SoftHeapPQ{ epsilon, comp, alloc } {
+        while(start != end) {
+            push(*start);
+            start++;
+        }
+    } // SoftHeapPQ()
+
+
+    // Description: Destructor doesn't need any code, the pools release every
+    //              item and node.
+    virtual ~SoftHeapPQ() {
+    } // ~SoftHeapPQ()
+
+
+    // Description: Rebuilds the soft heap from its elements, each pushed
+    //              again as if new. Corruption is undone, and the count of
+    //              pushes the bound is measured against starts over.
+    // Runtime: O(n log(1/epsilon))
+    virtual void updatePriorities() {
+        Vector<Index> live(items.get_allocator());
+        forEachItem([&live](const Node &, Index item) { live.push_back(item); });
+        nodes.clear();
+        freeNodes = NIL;
+        roots.clear();
+        best.clear();
+        count = 0;
+        for(Index item : live) {
+            insert(item);
+        }
+    } // updatePriorities()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed. The soft heap is rebuilt
+    //              from the rest as updatePriorities() does, which undoes
+    //              corruption too.
+    // Runtime: O(n log(1/epsilon))
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        Vector<Index> live(items.get_allocator());
+        forEachItem([&live](const Node &, Index item) { live.push_back(item); });
+        nodes.clear();
+        freeNodes = NIL;
+        roots.clear();
+        best.clear();
+        count = 0;
+        std::size_t removed = 0;
+        for(Index item : live) {
+            if(pred(static_cast<const TYPE&>(items[item].elt))) {
+                releaseItem(item);
+                removed++;
+            }
+            else {
+                insert(item);
+            }
+        }
+        return removed;
+    } // remove_if()
+
+
+    // Description: Add a new element to the soft heap. It becomes a tree of
+    //              rank 0 that is carried through the root list.
+    // Runtime: Amortized O(log(1/epsilon))
+    virtual void push(const TYPE &val) {
+        insert(acquireItem(val));
+    } // push()
+
+
+    // Description: Remove the element top() returns. If that leaves the
+    //              root's list at most half full, the root refills it from
+    //              its children, and the best root table is refreshed.
+    // Runtime: Amortized O(log(1/epsilon)), plus O(log(n)) when the table
+    //          is refreshed.
+    virtual void pop() {
+        releaseItem(unlinkTop());
+    } // pop()
+
+
+    // Description: Return an element of the root with the most extreme ckey.
+    //              It is the most extreme element unless some are corrupted.
+    // Runtime: O(1)
+    virtual const TYPE &top() const {
+        return items[nodes[roots[best[0]]].head].elt;
+    } // top()
+
+
+    // Description: Get the number of elements in the soft heap.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return count;
+    } // size()
+
+
+    // Description: Return true if the soft heap is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return count == 0;
+    } // empty()
+
+
+    // Description: Pop up to k elements, writing them to 'out' in the order
+    //              pop() would remove them.
+    // Runtime: Amortized O(k log(1/epsilon))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        for(k = std::min(k, count); k > 0; --k) {
+            Index item = unlinkTop();
+            *out++ = std::move(items[item].elt);
+            releaseItem(item);
+        }
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in the order
+    //              pop() would remove them.
+    // Runtime: Amortized O(n log(1/epsilon))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        return pop_k(count, out);
+    } // drain()
+
+
+    // Description: The error rate the soft heap was constructed with.
+    // Runtime: O(1)
+    double epsilon() const {
+        return errorRate;
+    } // epsilon()
+
+
+    // Description: The number of elements held now that are corrupted, that
+    //              is, more extreme than the ckey of their node.
+    // Runtime: O(n)
+    std::size_t corrupted() const {
+        std::size_t corruptedNow = 0;
+        forEachItem([this, &corruptedNow](const Node &node, Index item) {
+            if(this->compare(node.ckey, items[item].elt)) {
+                corruptedNow++;
+            }
+        });
+        return corruptedNow;
+    } // corrupted()
+
+
+    // Description: The number of pops that removed a corrupted element.
+    // Runtime: O(1)
+    std::size_t corruptedPops() const {
+        return corruptedPopCount;
+    } // corruptedPops()
+
+
+    // Description: The allocator the soft heap was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(items.get_allocator());
+    } // get_allocator()
+
+
+private:
+    Index acquireItem(const TYPE &val) {
+        if(freeItems != NIL) {
+            Index index = freeItems;
+            freeItems = items[index].next;
+            items[index] = Item{ val, NIL };
+            return index;
+        }
+        if(items.size() >= NIL) {
+            throw std::length_error("SoftHeapPQ holds at most 2^32 - 1 elements");
+        }
+        items.push_back(Item{ val, NIL });
+        return static_cast<Index>(items.size() - 1);
+    }
+
+    void releaseItem(Index index) {
+        items[index].next = freeItems;
+        freeItems = index;
+    }
+
+    Index acquireNode(const TYPE &ckey, std::uint32_t rank) {
+        Node node{ ckey, NIL, NIL, NIL, NIL, 0, rank };
+        if(freeNodes != NIL) {
+            Index index = freeNodes;
+            freeNodes = nodes[index].left;
+            nodes[index] = node;
+            return index;
+        }
+        nodes.push_back(node);
+        return static_cast<Index>(nodes.size() - 1);
+    }
+
+    void releaseNode(Index index) {
+        nodes[index].left = freeNodes;
+        freeNodes = index;
+    }
+
+    bool isLeaf(Index x) const {
+        return nodes[x].left == NIL && nodes[x].right == NIL;
+    }
+
+    // Makes a rank 0 tree holding 'item' and adds it to the roots, combining
+    // equal ranks the way a binary counter carries.
+    void insert(Index item) {
+        items[item].next = NIL;
+        Index tree = acquireNode(items[item].elt, 0);
+        nodes[tree].head = item;
+        nodes[tree].tail = item;
+        nodes[tree].listSize = 1;
+        std::size_t rank = 0;
+        while(rank < roots.size() && roots[rank] != NIL) {
+            tree = combine(roots[rank], tree);
+            roots[rank] = NIL;
+            rank++;
+        }
+        if(rank == roots.size()) {
+            roots.push_back(NIL);
+            best.push_back(NIL);
+        }
+        roots[rank] = tree;
+        updateBest(rank);
+        count++;
+    }
+
+    // Makes a new node of the next rank up with x and y, of equal rank, as
+    // its children, and fills its list from them.
+    Index combine(Index x, Index y) {
+        TYPE ckey = nodes[x].ckey;
+        Index z = acquireNode(ckey, nodes[x].rank + 1);
+        nodes[z].left = x;
+        nodes[z].right = y;
+        sift(z);
+        return z;
+    }
+
+    // Until x's list reaches the target size for its rank or x is a leaf,
+    // moves the list of x's child with the more extreme ckey up into x,
+    // taking that ckey, and refills the child the same way. A child left
+    // empty as a leaf is freed.
+    void sift(Index x) {
+        while(nodes[x].listSize < targets[nodes[x].rank] && !isLeaf(x)) {
+            Node &node = nodes[x];
+            if(node.left == NIL
+               || (node.right != NIL && this->compare(nodes[node.left].ckey, nodes[node.right].ckey))) {
+                std::swap(node.left, node.right);
+            }
+            Index from = node.left;
+            Node &child = nodes[from];
+            if(node.head == NIL) {
+                node.head = child.head;
+            }
+            else {
+                items[node.tail].next = child.head;
+            }
+            node.tail = child.tail;
+            node.listSize += child.listSize;
+            node.ckey = child.ckey;
+            child.head = NIL;
+            child.tail = NIL;
+            child.listSize = 0;
+            if(isLeaf(from)) {
+                releaseNode(from);
+                node.left = NIL;
+            }
+            else {
+                sift(from);
+            }
+        }
+    }
+
+    // Recomputes best[i], the rank of the root with the most extreme ckey
+    // among ranks i and up, for every i <= rank. Ties go to the lower rank.
+    void updateBest(std::size_t rank) {
+        for(std::size_t i = rank + 1; i-- > 0;) {
+            Index after = i + 1 < roots.size() ? best[i + 1] : NIL;
+            if(roots[i] == NIL) {
+                best[i] = after;
+            }
+            else if(after == NIL || !this->compare(nodes[roots[i]].ckey, nodes[roots[after]].ckey)) {
+                best[i] = static_cast<Index>(i);
+            }
+            else {
+                best[i] = after;
+            }
+        }
+    }
+
+    // Takes the item top() returns out of its list, refilling or removing
+    // its root as needed, and returns it still allocated.
+    Index unlinkTop() {
+        Index rank = best[0];
+        Index x = roots[rank];
+        Node &node = nodes[x];
+        Index item = node.head;
+        node.head = items[item].next;
+        if(node.head == NIL) {
+            node.tail = NIL;
+        }
+        node.listSize--;
+        count--;
+        if(this->compare(node.ckey, items[item].elt)) {
+            corruptedPopCount++;
+        }
+
+        if(2*node.listSize > targets[node.rank]) {
+            return item;
+        }
+        if(!isLeaf(x)) {
+            sift(x);
+            updateBest(rank);
+        }
+        else if(node.listSize == 0) {
+            releaseNode(x);
+            roots[rank] = NIL;
+            while(!roots.empty() && roots.back() == NIL) {
+                roots.pop_back();
+                best.pop_back();
+            }
+            if(!roots.empty()) {
+                updateBest(std::min<std::size_t>(rank, roots.size() - 1));
+            }
+        }
+        return item;
+    }
+
+    // Calls visit(node, item) for every item held, walking each tree with
+    // an explicit stack.
+    template<typename Visit>
+    void forEachItem(Visit visit) const {
+        Vector<Index> stack(nodes.get_allocator());
+        for(Index root : roots) {
+            if(root != NIL) {
+                stack.push_back(root);
+            }
+        }
+        while(!stack.empty()) {
+            const Node &node = nodes[stack.back()];
+            stack.pop_back();
+            for(Index item = node.head; item != NIL; item = items[item].next) {
+                visit(node, item);
+            }
+            if(node.left != NIL) { stack.push_back(node.left); }
+            if(node.right != NIL) { stack.push_back(node.right); }
+        }
+    }
+
+    Vector<Item> items;
+    Vector<Node> nodes;
+    // roots[k] is the tree of rank k, or NIL.
+    Vector<Index> roots;
+    Vector<Index> best;
+    // The list size each rank of node refills to.
+    std::array<std::uint32_t, 64> targets;
+    Index freeItems;
+    Index freeNodes;
+    std::size_t count;
+    std::size_t corruptedPopCount;
+    double errorRate;
+}; // SoftHeapPQ
+
+
+namespace pmr {
+    // SoftHeapPQ drawing its pools from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using SoftHeapPQ = ::SoftHeapPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // SOFTHEAPPQ_H
@@ -6,23 +6,35 @@
 #include "Eecs281PQ.h"
 #include <algorithm>
 #include <iostream>
+#include <memory_resource>
 
 // A specialized version of the priority queue ADT that is implemented with
 // an underlying sorted array-based container.
 // Note: The most extreme element should be found at the end of the 'data'
 //       container, such that traversing the iterators yields the elements in
 //       sorted order.
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
 class SortedPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
+    using allocator_type = Allocator;
+
     // Description: Construct an empty PQ with an optional comparison
     //              functor.
     // Runtime: O(1)
-    explicit SortedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp } {
+    explicit SortedPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                      const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data(alloc) {
+    } // SortedPQ
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit SortedPQ(const Allocator &alloc) :
+        SortedPQ{ COMP_FUNCTOR(), alloc } {
     } // SortedPQ
 
 
@@ -30,8 +42,9 @@ public:
     //              comparison functor.
     // Runtime: O(n log n) where n is number of elements in range.
     template<typename InputIterator>
-    SortedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp } {
+    SortedPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data(alloc) {
         while(start != end) {
             data.push_back(*start);
             start++;
@@ -101,10 +114,78 @@ public:
     } // updatePriorities()
 
 
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order. They are already the last k
+    //              elements, so this is one reverse move and one truncate.
+    // Runtime: O(k)
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        k = std::min(k, data.size());
+        out = std::move(data.rbegin(), data.rbegin() + static_cast<std::ptrdiff_t>(k), out);
+        data.resize(data.size() - k);
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: O(n)
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        out = std::move(data.rbegin(), data.rend(), out);
+        data.clear();
+        return out;
+    } // drain()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed. std::remove_if() keeps the
+    //              survivors in order, so the vector stays sorted.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        auto kept = std::remove_if(data.begin(), data.end(), pred);
+        auto removed = static_cast<std::size_t>(data.end() - kept);
+        data.erase(kept, data.end());
+        return removed;
+    } // remove_if()
+
+
+    // Description: Moves every element out of the PQ, in storage order
+    //              rather than priority order, and leaves the PQ empty.
+    // Runtime: O(1)
+    std::vector<TYPE, Allocator> release() {
+        std::vector<TYPE, Allocator> out(data.get_allocator());
+        out.swap(data);
+        return out;
+    } // release()
+
+
+    // Description: Make room for 'n' elements, so pushes up to that size
+    //              do not allocate.
+    // Runtime: O(size()) if it reallocates, otherwise O(1)
+    void reserve(std::size_t n) {
+        data.reserve(n);
+    } // reserve()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return data.get_allocator();
+    } // get_allocator()
+
+
 private:
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
+    std::vector<TYPE, Allocator> data;
 
 }; // SortedPQ
 
+namespace pmr {
+    // SortedPQ drawing its storage from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using SortedPQ = ::SortedPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
 #endif // SORTEDPQ_H
@@ -0,0 +1,270 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef STABLEPQ_H
+#define STABLEPQ_H
+
+#include "Eecs281PQ.h"
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A stable (first-in first-out among equal priorities) version of any of
+// the PQ implementations, e.g. StablePQ<BinaryPQ, Job, JobComp>. Elements
+// that compare equal are popped in the order they were pushed.
+//
+// Each element is stored next to its insertion sequence number, which
+// breaks ties in the comparison. How that number is stored depends on TYPE:
+//
+// - Integral TYPE ordered by std::less or std::greater: equal elements are
+//   indistinguishable, so every pop order is already stable and the values
+//   are stored as they are, at no cost.
+// - When TYPE's alignment is below 8 bytes (an int, a struct of ints) a
+//   32-bit sequence number is packed beside it, taking 4 bytes where a
+//   64-bit counter would take 8 plus padding. When the counter runs out the
+//   queue is renumbered, an O(n log(n)) step once every 2^32 pushes.
+// - Otherwise a 64-bit sequence number sits beside the element, in the
+//   same space a 32-bit one would take up with padding.
+//
+// updatePriorities() keeps the order among elements whose priorities tie
+// after the update: it is still the order they were pushed in.
+//
+// The underlying PQ, and the scratch vectors used to build and renumber
+// it, allocate with Allocator rebound to Stored.
+template<template<typename...> typename PQ, typename TYPE,
+         typename COMP_FUNCTOR = std::less<TYPE>, typename Allocator = std::allocator<TYPE>>
+class StablePQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
+    // This is a way to refer to the base class object.
+    using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
+
+    template<typename SEQUENCE>
+    struct Entry {
+        TYPE value;
+        SEQUENCE sequence;
+    };
+
+    static constexpr bool TIES_INVISIBLE = std::is_integral<TYPE>::value
+        && (std::is_same<COMP_FUNCTOR, std::less<TYPE>>::value
+            || std::is_same<COMP_FUNCTOR, std::greater<TYPE>>::value
+            || std::is_same<COMP_FUNCTOR, std::less<>>::value
+            || std::is_same<COMP_FUNCTOR, std::greater<>>::value);
+
+    static constexpr bool NARROW = sizeof(Entry<std::uint32_t>) < sizeof(Entry<std::uint64_t>);
+
+    using Sequence = std::conditional_t<NARROW, std::uint32_t, std::uint64_t>;
+
+public:
+    using allocator_type = Allocator;
+
+    // What the underlying PQ stores.
+    using Stored = std::conditional_t<TIES_INVISIBLE, TYPE, Entry<Sequence>>;
+
+    // a is less extreme than b when 'compare' says so, or when they tie and
+    // a was pushed later.
+    class StoredComp {
+    public:
+        explicit StoredComp(const COMP_FUNCTOR &comp = COMP_FUNCTOR()) : compare{ comp } {}
+
+        bool operator()(const Stored &a, const Stored &b) const {
+            if constexpr(TIES_INVISIBLE) {
+                return compare(a, b);
+            }
+            else {
+                if(compare(a.value, b.value)) { return true; }
+                if(compare(b.value, a.value)) { return false; }
+                return a.sequence > b.sequence;
+            }
+        }
+
+    private:
+        COMP_FUNCTOR compare;
+    }; // StoredComp
+
+private:
+    using StoredAlloc = ReboundAllocator<Allocator, Stored>;
+    using StoredVector = std::vector<Stored, StoredAlloc>;
+    using Impl = PQ<Stored, StoredComp, StoredAlloc>;
+
+public:
+
+
+    // Description: Construct an empty PQ with an optional comparison functor.
+    // Runtime: That of the underlying PQ.
+    explicit StablePQ(COMP_FUNCTOR comp = COMP_FUNCTOR(), const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, impl{ StoredComp{ comp }, StoredAlloc(alloc) }, next{ 0 } {
+    } // StablePQ()
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: That of the underlying PQ.
+    explicit StablePQ(const Allocator &alloc) :
+        StablePQ{ COMP_FUNCTOR(), alloc } {
+    } // StablePQ()
+
+
+    // Description: Construct a PQ out of an iterator range with an optional
+    //              comparison functor. Elements of the range that tie are
+    //              popped in range order.
+    // Runtime: That of the underlying PQ's range constructor.
+    template<typename InputIterator>
+    StablePQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+             const Allocator &alloc = Allocator()) :
+        StablePQ{ numbered(start, end, StoredAlloc(alloc)), comp } {
+    } // StablePQ()
+
+
+    // Description: Destructor doesn't need any code, the elements are owned
+    //              by 'impl'.
+    virtual ~StablePQ() {
+    } // ~StablePQ()
+
+
+    // Description: Assumes that all elements inside the PQ are out of order
+    //              and 'rebuilds' it.
+    // Runtime: That of the underlying PQ.
+    virtual void updatePriorities() {
+        impl.updatePriorities();
+    } // updatePriorities()
+
+
+    // Description: Add a new element to the PQ.
+    // Runtime: That of the underlying PQ, plus O(n log(n)) once every 2^32
+    //          pushes when the sequence is 32 bits.
+    virtual void push(const TYPE &val) {
+        if constexpr(!TIES_INVISIBLE && NARROW) {
+            if(next == std::numeric_limits<Sequence>::max()) {
+                renumber();
+            }
+        }
+        impl.push(makeStored(val));
+    } // push()
+
+
+    // Description: Remove the most extreme (defined by 'compare') element
+    //              from the PQ, the earliest pushed of those that tie.
+    // Runtime: That of the underlying PQ.
+    virtual void pop() {
+        impl.pop();
+    } // pop()
+
+
+    // Description: Return the most extreme (defined by 'compare') element of
+    //              the PQ, the earliest pushed of those that tie.
+    // Runtime: That of the underlying PQ.
+    virtual const TYPE &top() const {
+        if constexpr(TIES_INVISIBLE) {
+            return impl.top();
+        }
+        else {
+            return impl.top().value;
+        }
+    } // top()
+
+
+    // Description: Get the number of elements in the PQ.
+    // Runtime: O(1)
+    virtual std::size_t size() const {
+        return impl.size();
+    } // size()
+
+
+    // Description: Return true if the PQ is empty.
+    // Runtime: O(1)
+    virtual bool empty() const {
+        return impl.empty();
+    } // empty()
+
+
+    // Description: Remove every element for which 'pred' returns true with
+    //              the underlying PQ's remove_if(), returning how many. The
+    //              sequence numbers of the rest are kept, so their ties
+    //              still pop in push order.
+    // Runtime: That of the underlying PQ's remove_if().
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        return impl.remove_if([&pred](const Stored &stored) {
+            if constexpr(TIES_INVISIBLE) {
+                return static_cast<bool>(pred(stored));
+            }
+            else {
+                return static_cast<bool>(pred(stored.value));
+            }
+        });
+    } // remove_if()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return allocator_type(impl.get_allocator());
+    } // get_allocator()
+
+
+private:
+    StablePQ(StoredVector &&entries, COMP_FUNCTOR comp) :
+        BaseClass{ comp },
+        impl{ std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()),
+              StoredComp{ comp }, entries.get_allocator() },
+        next{ static_cast<Sequence>(entries.size()) } {
+    }
+
+    template<typename InputIterator>
+    static StoredVector numbered(InputIterator start, InputIterator end, const StoredAlloc &alloc) {
+        StoredVector entries(alloc);
+        while(start != end) {
+            if constexpr(TIES_INVISIBLE) {
+                entries.push_back(*start);
+            }
+            else {
+                entries.push_back(Stored{ *start, static_cast<Sequence>(entries.size()) });
+            }
+            start++;
+        }
+        return entries;
+    }
+
+    Stored makeStored(const TYPE &val) {
+        if constexpr(TIES_INVISIBLE) {
+            return val;
+        }
+        else {
+            return Stored{ val, next++ };
+        }
+    }
+
+    // Pops everything in order and numbers it again from zero, which keeps
+    // the relative order of every tie.
+    void renumber() {
+        StoredVector entries(impl.get_allocator());
+        entries.reserve(impl.size());
+        while(!impl.empty()) {
+            entries.push_back(impl.top());
+            impl.pop();
+        }
+        next = 0;
+        for(Stored &entry : entries) {
+            entry.sequence = next++;
+        }
+        impl = Impl(std::make_move_iterator(entries.begin()), std::make_move_iterator(entries.end()),
+                    StoredComp{ this->compare }, entries.get_allocator());
+    }
+
+    Impl impl;
+    Sequence next;
+}; // StablePQ
+
+
+namespace pmr {
+    // StablePQ drawing its storage from a std::pmr::memory_resource.
+    template<template<typename...> typename PQ, typename TYPE,
+             typename COMP_FUNCTOR = std::less<TYPE>>
+    using StablePQ =
+        ::StablePQ<PQ, TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
+
+#endif // STABLEPQ_H
@@ -4,6 +4,8 @@
 #define UNORDEREDFASTPQ_H
 
 #include "Eecs281PQ.h"
+#include <algorithm>
+#include <memory_resource>
 
 #include <limits>  // needed for UNKNOWN
 
@@ -22,16 +24,27 @@ static const size_t UNKNOWN = std::numeric_limits<size_t>::max();
 // Pay particular attention to how the constructors and findExtreme()
 // are written, especially the use of this->compare.
 
-template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>,
+         typename Allocator = std::allocator<TYPE>>
 class UnorderedFastPQ : public Eecs281PQ<TYPE, COMP_FUNCTOR> {
     // This is a way to refer to the base class object.
     using BaseClass = Eecs281PQ<TYPE, COMP_FUNCTOR>;
 
 public:
+    using allocator_type = Allocator;
+
     // Description: Construct an empty PQ with an optional comparison functor.
     // Runtime: O(1)
-    explicit UnorderedFastPQ(COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp }, extreme{ UNKNOWN } {
+    explicit UnorderedFastPQ(COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                             const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data(alloc), extreme{ UNKNOWN } {
+    } // UnorderedFastPQ()
+
+
+    // Description: Construct an empty PQ that allocates with 'alloc'.
+    // Runtime: O(1)
+    explicit UnorderedFastPQ(const Allocator &alloc) :
+        UnorderedFastPQ{ COMP_FUNCTOR(), alloc } {
     } // UnorderedFastPQ()
 
 
@@ -39,8 +52,9 @@ public:
     //              comparison functor.
     // Runtime: O(n) where n is number of elements in range.
     template<typename InputIterator>
-    UnorderedFastPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR()) :
-        BaseClass{ comp }, data{ start, end }, extreme{ UNKNOWN } {
+    UnorderedFastPQ(InputIterator start, InputIterator end, COMP_FUNCTOR comp = COMP_FUNCTOR(),
+                    const Allocator &alloc = Allocator()) :
+        BaseClass{ comp }, data{ start, end, alloc }, extreme{ UNKNOWN } {
     } // UnorderedFastPQ()
 
 
@@ -122,9 +136,80 @@ public:
     } // empty()
 
 
+    // Description: Pop up to k of the most extreme elements, writing them to
+    //              'out' in priority order. nth_element() gathers the k
+    //              most extreme at the back, only those k are sorted, and
+    //              the vector is truncated once.
+    // Runtime: O(n + k log(k))
+    template<typename OutputIterator>
+    OutputIterator pop_k(std::size_t k, OutputIterator out) {
+        k = std::min(k, data.size());
+        auto first = data.end() - static_cast<std::ptrdiff_t>(k);
+        std::nth_element(data.begin(), first, data.end(), this->compare);
+        std::sort(first, data.end(), this->compare);
+        out = std::move(data.rbegin(), data.rbegin() + static_cast<std::ptrdiff_t>(k), out);
+        data.erase(first, data.end());
+        extreme = UNKNOWN;
+        return out;
+    } // pop_k()
+
+
+    // Description: Pop every element, writing them to 'out' in priority
+    //              order.
+    // Runtime: O(n log(n))
+    template<typename OutputIterator>
+    OutputIterator drain(OutputIterator out) {
+        std::sort(data.begin(), data.end(), this->compare);
+        out = std::move(data.rbegin(), data.rend(), out);
+        data.clear();
+        extreme = UNKNOWN;
+        return out;
+    } // drain()
+
+
+    // Description: Moves every element out of the PQ, in storage order
+    //              rather than priority order, and leaves the PQ empty.
+    // Runtime: O(1)
+    std::vector<TYPE, Allocator> release() {
+        std::vector<TYPE, Allocator> out(data.get_allocator());
+        out.swap(data);
+        extreme = UNKNOWN;
+        return out;
+    } // release()
+
+
+    // Description: Remove every element for which 'pred' returns true and
+    //              return how many were removed. The vector is compacted in
+    //              place, which forgets the remembered most extreme index.
+    // Runtime: O(n)
+    template<typename Predicate>
+    std::size_t remove_if(Predicate pred) {
+        auto kept = std::remove_if(data.begin(), data.end(), pred);
+        auto removed = static_cast<std::size_t>(data.end() - kept);
+        data.erase(kept, data.end());
+        extreme = UNKNOWN;
+        return removed;
+    } // remove_if()
+
+
+    // Description: Make room for 'n' elements, so pushes up to that size
+    //              do not allocate.
+    // Runtime: O(size()) if it reallocates, otherwise O(1)
+    void reserve(std::size_t n) {
+        data.reserve(n);
+    } // reserve()
+
+
+    // Description: The allocator the PQ was constructed with.
+    // Runtime: O(1)
+    allocator_type get_allocator() const {
+        return data.get_allocator();
+    } // get_allocator()
+
+
 private:
     // Note: This vector *must* be used for your PQ implementation.
-    std::vector<TYPE> data;
+    std::vector<TYPE, Allocator> data;
 
 private:
     // A member variable that can be changed by a const member function;
@@ -146,4 +231,11 @@ private:
     } // findExtreme()
 }; // UnorderedFastPQ
 
+namespace pmr {
+    // UnorderedFastPQ drawing its storage from a std::pmr::memory_resource.
+    template<typename TYPE, typename COMP_FUNCTOR = std::less<TYPE>>
+    using UnorderedFastPQ =
+        ::UnorderedFastPQ<TYPE, COMP_FUNCTOR, std::pmr::polymorphic_allocator<TYPE>>;
+} // namespace pmr
+
 #endif // UNORDEREDFASTPQ_H
@@ -0,0 +1,103 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Calibration and comparison for AdaptivePQ.
+//
+// The first table times a steady push/top/pop cycle at a fixed size for each
+// of AdaptivePQ's representations; the small-queue thresholds should sit
+// near the size where UnorderedFastPQ stops winning. The second table runs
+// a few mixed workloads through each fixed representation and AdaptivePQ.
+//
+// Usage: bench/benchAdaptive [operations]
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "AdaptivePQ.h"
+#include "BinaryPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "bench/benchUtil.h"
+
+
+// ns per push+top+pop cycle at a steady size.
+template<typename PQ>
+double steadyCycle(size_t size, size_t cycles) {
+    BenchRng rng;
+    PQ pq;
+    for(size_t i = 0; i < size; ++i) pq.push(static_cast<int>(rng.below(1000000)));
+    Stopwatch timer;
+    for(size_t i = 0; i < cycles; ++i) {
+        pq.push(static_cast<int>(rng.below(1000000)));
+        doNotOptimize(pq.top());
+        pq.pop();
+    }
+    return timer.elapsedNs() / static_cast<double>(cycles);
+}
+
+
+// Fills to 'size', then runs 'operations' steps where each step is a push
+// with probability pushPct, an updatePriorities() every 'updateEvery' steps
+// (0 for never), and otherwise a top()+pop() while anything is queued.
+template<typename PQ>
+double mixed(size_t size, size_t operations, size_t pushPct, size_t updateEvery) {
+    BenchRng rng;
+    PQ pq;
+    Stopwatch timer;
+    for(size_t i = 0; i < size; ++i) pq.push(static_cast<int>(rng.below(1000000)));
+    for(size_t i = 0; i < operations; ++i) {
+        if(updateEvery != 0 && i % updateEvery == 0) {
+            pq.updatePriorities();
+        }
+        else if(pq.empty() || rng.below(100) < pushPct) {
+            pq.push(static_cast<int>(rng.below(1000000)));
+        }
+        else {
+            doNotOptimize(pq.top());
+            pq.pop();
+        }
+    }
+    return timer.elapsedNs() / 1e6;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t operations = argOr(argc, argv, 1, 2000000);
+
+    std::cout << "steady push/top/pop, ns per cycle" << std::endl;
+    std::cout << std::setw(8) << "size" << std::setw(12) << "Unordered"
+              << std::setw(12) << "Binary" << std::setw(12) << "Sorted" << std::endl;
+    for(size_t size : { 4, 8, 16, 24, 32, 48, 64, 128, 256 }) {
+        size_t cycles = operations / 4;
+        std::cout << std::setw(8) << size << std::fixed << std::setprecision(1)
+                  << std::setw(12) << steadyCycle<UnorderedFastPQ<int>>(size, cycles)
+                  << std::setw(12) << steadyCycle<BinaryPQ<int>>(size, cycles)
+                  << std::setw(12) << steadyCycle<SortedPQ<int>>(size, cycles) << std::endl;
+    }
+
+    struct Workload { const char *name; size_t size; size_t pushPct; size_t updateEvery; };
+    const Workload workloads[] = {
+        { "tiny queue, 50% push     ", 16, 50, 0 },
+        { "large queue, 50% push    ", 100000, 50, 0 },
+        { "large build then drain   ", 200000, 0, 0 },
+        { "medium, update every 4   ", 2000, 50, 4 },
+    };
+
+    std::cout << std::endl << "mixed workloads, ms" << std::endl;
+    std::cout << std::setw(26) << "" << std::setw(12) << "Unordered" << std::setw(12) << "Binary"
+              << std::setw(12) << "Sorted" << std::setw(12) << "Adaptive" << std::endl;
+    for(const Workload &w : workloads) {
+        size_t ops = w.pushPct == 0 ? w.size : operations;
+        std::cout << w.name << std::fixed << std::setprecision(1);
+        // The unordered scan is quadratic on the large workloads; skip it.
+        if(w.size > 10000) std::cout << std::setw(12) << "-";
+        else std::cout << std::setw(12) << mixed<UnorderedFastPQ<int>>(w.size, ops, w.pushPct, w.updateEvery);
+        std::cout << std::setw(12) << mixed<BinaryPQ<int>>(w.size, ops, w.pushPct, w.updateEvery);
+        if(w.pushPct != 0 && w.size > 10000) std::cout << std::setw(12) << "-";
+        else std::cout << std::setw(12) << mixed<SortedPQ<int>>(w.size, ops, w.pushPct, w.updateEvery);
+        std::cout << std::setw(12) << mixed<AdaptivePQ<int>>(w.size, ops, w.pushPct, w.updateEvery)
+                  << std::endl;
+    }
+
+    return 0;
+}
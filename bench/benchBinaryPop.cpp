@@ -0,0 +1,109 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Compares BinaryPQ's bottom-up pop against the previous swap-based
+// recursive fixDown, reporting comparator calls, time and hardware counters
+// (where available) per pop.
+//
+// Usage: bench/benchBinaryPop [n]
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "bench/benchUtil.h"
+#include "bench/perfCounters.h"
+
+
+// The pop/fixDown that BinaryPQ used before the hole-based sift, kept here
+// only as a reference point.
+template<typename TYPE, typename COMP_FUNCTOR>
+class LegacyBinaryHeap {
+public:
+    void push(const TYPE &val) {
+        data.push_back(val);
+        size_t index = data.size() - 1;
+        while(index != 0 && compare(data[(index - 1)/2], data[index])) {
+            std::swap(data[(index - 1)/2], data[index]);
+            index = (index - 1)/2;
+        }
+    }
+
+    void pop() {
+        data[0] = data.back();
+        data.pop_back();
+        fixDown(0);
+    }
+
+    const TYPE &top() const { return data.front(); }
+    bool empty() const { return data.empty(); }
+
+private:
+    void fixDown(size_t index) {
+        if(index >= (data.size()/2)) return;
+        size_t largestIndex = index;
+        if(compare(data[index], data[(2*index) + 1])) largestIndex = (2*index) + 1;
+        if(((2*index) + 2) < data.size() && compare(data[largestIndex], data[(2*index) + 2])) {
+            largestIndex = (2*index) + 2;
+        }
+        if(largestIndex == index) return;
+        std::swap(data[index], data[largestIndex]);
+        fixDown(largestIndex);
+    }
+
+    std::vector<TYPE> data;
+    COMP_FUNCTOR compare;
+}; // LegacyBinaryHeap
+
+
+// Pushes every key, then times and counts comparisons over popping them all.
+template<typename HEAP, typename COMP, typename TYPE>
+void run(const char *name, const std::vector<TYPE> &keys, PerfCounters &counters) {
+    HEAP heap;
+    for(const TYPE &key : keys) heap.push(key);
+
+    COMP::calls = 0;
+    counters.start();
+    Stopwatch timer;
+    while(!heap.empty()) {
+        doNotOptimize(heap.top());
+        heap.pop();
+    }
+    double ns = timer.elapsedNs();
+    counters.stop();
+    double n = static_cast<double>(keys.size());
+
+    std::cout << "  " << name << ": "
+              << static_cast<double>(COMP::calls) / n << " compares/pop, "
+              << counters.perOp(ns, n) << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 1000000);
+    BenchRng rng;
+
+    std::vector<int> ints(n);
+    for(int &val : ints) val = static_cast<int>(rng.next() >> 33);
+
+    // Long shared prefixes make every comparison walk most of the string.
+    std::vector<std::string> strings(n);
+    for(std::string &str : strings) {
+        str = std::string(48, 'k') + std::to_string(rng.next());
+    }
+
+    using IntComp = CountingComp<std::less<int>>;
+    using StrComp = CountingComp<std::less<std::string>>;
+
+    PerfCounters counters;
+    counters.describe(std::cout);
+    std::cout << "int keys, n = " << n << std::endl;
+    run<LegacyBinaryHeap<int, IntComp>, IntComp>("legacy fixDown ", ints, counters);
+    run<BinaryPQ<int, IntComp>, IntComp>("bottom-up pop  ", ints, counters);
+
+    std::cout << "string keys, n = " << n << std::endl;
+    run<LegacyBinaryHeap<std::string, StrComp>, StrComp>("legacy fixDown ", strings, counters);
+    run<BinaryPQ<std::string, StrComp>, StrComp>("bottom-up pop  ", strings, counters);
+
+    return 0;
+}
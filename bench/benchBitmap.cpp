@@ -0,0 +1,66 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Integer priorities from a small universe of levels, as QoS classes and
+// deadline buckets are: BinaryPQ against BitmapPQ as the number of queued
+// elements n grows, for 256 and 65536 levels.
+//
+// Each run fills the PQ with n keys, then does 'rounds' of pop() followed by
+// push() of a fresh key (the hold model, size stays n), then drains it.
+// Reported: ns per fill push, per hold round, and per drain pop. Both PQs
+// must pop the same keys, checked through a checksum.
+//
+// Usage: bench/benchBitmap [max n] [rounds]
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "BitmapPQ.h"
+#include "bench/benchUtil.h"
+
+
+template<typename PQ>
+void run(const char *name, PQ &pq, std::size_t n, std::size_t rounds, const std::vector<int> &keys) {
+    std::uint64_t checksum = 0;
+    Stopwatch clock;
+    for(std::size_t i = 0; i < n; ++i) pq.push(keys[i]);
+    double fillNs = clock.elapsedNs();
+    clock.reset();
+    for(std::size_t r = 0; r < rounds; ++r) {
+        checksum += static_cast<std::uint64_t>(pq.top()) * (r + 1);
+        pq.pop();
+        pq.push(keys[n + r]);
+    }
+    double holdNs = clock.elapsedNs();
+    clock.reset();
+    while(!pq.empty()) {
+        checksum += static_cast<std::uint64_t>(pq.top());
+        pq.pop();
+    }
+    double drainNs = clock.elapsedNs();
+    std::cout << "    " << name << fillNs / static_cast<double>(n) << "\t"
+              << holdNs / static_cast<double>(rounds) << "\t" << drainNs / static_cast<double>(n)
+              << "\t(checksum " << checksum << ")" << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t maxN = argOr(argc, argv, 1, 1000000);
+    std::size_t rounds = argOr(argc, argv, 2, 1000000);
+    BenchRng rng;
+
+    for(std::size_t levels : { 256, 65536 }) {
+        std::vector<int> keys(maxN + rounds);
+        for(int &key : keys) key = static_cast<int>(rng.below(levels));
+        std::cout << levels << " levels; ns per fill push, hold round, drain pop" << std::endl;
+        for(std::size_t n = 1000; n <= maxN; n *= 10) {
+            std::cout << "  n = " << n << std::endl;
+            BinaryPQ<int> binary;
+            run("BinaryPQ : ", binary, n, rounds, keys);
+            BitmapPQ<int> bitmap{ levels };
+            run("BitmapPQ : ", bitmap, n, rounds, keys);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// BinaryPQ's branchless sifts, used for arithmetic keys under std::less or
+// std::greater, against the branching ones, reached with the same keys
+// through an equivalent comparator BinaryPQ does not recognize. For each
+// input order, times and counts hardware events (branch misses above all,
+// where the PMU is available) for building a heap from the range, pushing
+// every key, and popping them all.
+//
+// Random keys make the pick between two children a coin flip for a branch
+// predictor. The other inputs are the orders a predictor handles best or
+// worst: already sorted either way, few distinct keys (most children tie),
+// and an organ pipe (rising then falling).
+//
+// Usage: bench/benchBranchless [n]
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "bench/benchUtil.h"
+#include "bench/perfCounters.h"
+
+
+// std::less under another name, so BinaryPQ keeps its branching sifts.
+template<typename TYPE>
+struct BranchingLess {
+    bool operator()(const TYPE &a, const TYPE &b) const { return a < b; }
+};
+
+
+template<typename PQ, typename TYPE>
+void phases(const char *name, const std::vector<TYPE> &keys, PerfCounters &counters) {
+    std::cout << "    " << name << std::endl;
+    measureRegion(counters, "      build", keys.size(), [&]() {
+        PQ pq{ keys.begin(), keys.end() };
+        doNotOptimize(pq.top());
+    });
+    PQ pq;
+    measureRegion(counters, "      push ", keys.size(), [&]() {
+        for(const TYPE &key : keys) pq.push(key);
+    });
+    measureRegion(counters, "      pop  ", keys.size(), [&]() {
+        while(!pq.empty()) {
+            doNotOptimize(pq.top());
+            pq.pop();
+        }
+    });
+}
+
+
+template<typename TYPE>
+void compare(const char *type, std::size_t n, PerfCounters &counters) {
+    BenchRng rng;
+    std::vector<TYPE> random(n);
+    for(TYPE &key : random) key = static_cast<TYPE>(rng.next() >> 33);
+    std::vector<TYPE> ascending = random;
+    std::sort(ascending.begin(), ascending.end());
+    std::vector<TYPE> descending(ascending.rbegin(), ascending.rend());
+    std::vector<TYPE> few(n);
+    for(TYPE &key : few) key = static_cast<TYPE>(rng.below(4));
+    std::vector<TYPE> organ(n);
+    for(std::size_t i = 0; i < n; ++i) {
+        organ[i] = static_cast<TYPE>(i < n/2 ? i : n - i);
+    }
+
+    const std::pair<const char*, const std::vector<TYPE>*> inputs[] = {
+        { "random", &random }, { "ascending", &ascending }, { "descending", &descending },
+        { "4 distinct", &few }, { "organ pipe", &organ },
+    };
+    for(const auto &input : inputs) {
+        std::cout << "  " << type << " keys, " << input.first << std::endl;
+        phases<BinaryPQ<TYPE, BranchingLess<TYPE>>>("branching ", *input.second, counters);
+        phases<BinaryPQ<TYPE, std::less<TYPE>>>("branchless", *input.second, counters);
+    }
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 1000000);
+    PerfCounters counters;
+    counters.describe(std::cout);
+    std::cout << "n = " << n << ", per element" << std::endl;
+    compare<std::uint32_t>("uint32", n, counters);
+    compare<double>("double", n, counters);
+    return 0;
+}
@@ -0,0 +1,126 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Head-to-head of PairingPQ, CompactPairingPQ and RankPairingPQ running
+// Dijkstra with addNode()/updateElt() on random graphs. Denser graphs improve a
+// tentative distance more often, so the workload shifts from pops to
+// priority increases as the degree grows.
+//
+// Usage: bench/benchDecreaseKey [vertices]
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "CompactPairingPQ.h"
+#include "PairingPQ.h"
+#include "RankPairingPQ.h"
+#include "bench/benchUtil.h"
+
+
+// Compressed adjacency lists.
+struct Graph {
+    std::vector<size_t> offsets;
+    std::vector<size_t> targets;
+    std::vector<unsigned> weights;
+};
+
+Graph randomGraph(size_t vertices, size_t degree, BenchRng &rng) {
+    Graph graph;
+    graph.offsets.reserve(vertices + 1);
+    graph.offsets.push_back(0);
+    for(size_t v = 0; v < vertices; ++v) {
+        for(size_t e = 0; e < degree; ++e) {
+            graph.targets.push_back(rng.below(vertices));
+            graph.weights.push_back(static_cast<unsigned>(1 + rng.below(100000)));
+        }
+        graph.offsets.push_back(graph.targets.size());
+    }
+    return graph;
+}
+
+
+// Priority is (distance, vertex); std::greater puts the smallest on top.
+using Entry = std::pair<unsigned long long, size_t>;
+using EntryComp = CountingComp<std::greater<Entry>>;
+
+struct RunStats {
+    double ns = 0;
+    size_t updates = 0;
+    size_t pops = 0;
+    size_t compares = 0;
+    unsigned long long checksum = 0;
+};
+
+template<typename HEAP>
+RunStats dijkstra(const Graph &graph, size_t source) {
+    size_t vertices = graph.offsets.size() - 1;
+    using Handle = decltype(std::declval<HEAP&>().addNode(std::declval<const Entry&>()));
+    std::vector<Handle> handles(vertices);
+    std::vector<bool> queued(vertices, false);
+    std::vector<unsigned long long> dist(vertices, ~0ULL);
+    std::vector<bool> done(vertices, false);
+
+    RunStats stats;
+    EntryComp::calls = 0;
+    Stopwatch timer;
+
+    HEAP heap;
+    dist[source] = 0;
+    handles[source] = heap.addNode({ 0, source });
+    queued[source] = true;
+    while(!heap.empty()) {
+        size_t u = heap.top().second;
+        heap.pop();
+        stats.pops++;
+        queued[u] = false;
+        done[u] = true;
+        for(size_t e = graph.offsets[u]; e < graph.offsets[u + 1]; ++e) {
+            size_t v = graph.targets[e];
+            unsigned long long candidate = dist[u] + graph.weights[e];
+            if(done[v] || candidate >= dist[v]) continue;
+            dist[v] = candidate;
+            if(!queued[v]) {
+                handles[v] = heap.addNode({ candidate, v });
+                queued[v] = true;
+            }
+            else {
+                heap.updateElt(handles[v], { candidate, v });
+                stats.updates++;
+            }
+        }
+    }
+
+    stats.ns = timer.elapsedNs();
+    stats.compares = EntryComp::calls;
+    for(unsigned long long d : dist) {
+        if(d != ~0ULL) stats.checksum += d;
+    }
+    return stats;
+}
+
+template<typename HEAP>
+void report(const char *name, const Graph &graph, unsigned long long expected) {
+    RunStats stats = dijkstra<HEAP>(graph, 0);
+    std::cout << "  " << name << ": " << stats.ns / 1e6 << " ms, "
+              << stats.updates << " updateElt, " << stats.pops << " pops, "
+              << stats.compares << " compares"
+              << (expected != 0 && stats.checksum != expected ? "  CHECKSUM MISMATCH" : "")
+              << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    size_t vertices = argOr(argc, argv, 1, 200000);
+    BenchRng rng;
+
+    for(size_t degree : { 4, 16, 64 }) {
+        Graph graph = randomGraph(vertices, degree, rng);
+        std::cout << "n = " << vertices << ", degree = " << degree << std::endl;
+        unsigned long long expected = dijkstra<PairingPQ<Entry, EntryComp>>(graph, 0).checksum;
+        report<PairingPQ<Entry, EntryComp>>("PairingPQ       ", graph, expected);
+        report<CompactPairingPQ<Entry, EntryComp>>("CompactPairingPQ", graph, expected);
+        report<RankPairingPQ<Entry, EntryComp>>("RankPairingPQ   ", graph, expected);
+    }
+
+    return 0;
+}
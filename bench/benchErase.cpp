@@ -0,0 +1,150 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Cancelling scheduled items: erase(handle) on IndexedBinaryPQ, PairingPQ
+// and CompactPairingPQ, against lazy deletion in a plain BinaryPQ, where a
+// cancelled item stays queued as a tombstone and is skipped when it reaches
+// the top. The same script runs on every queue: about 'size' items are kept
+// scheduled, each step schedules one and runs the earliest, and 'percent'
+// of all items are cancelled before they run. Reports ns per step and, for
+// the tombstones, how much larger the heap gets.
+//
+// Usage: bench/benchErase [steps] [size] [percent]
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "CompactPairingPQ.h"
+#include "IndexedBinaryPQ.h"
+#include "PairingPQ.h"
+#include "bench/benchUtil.h"
+
+
+// An item is its due time shifted above its id, so every key is unique and
+// every queue pops in the same order.
+const unsigned ID_BITS = 24;
+const std::uint64_t ID_MASK = (std::uint64_t{ 1 } << ID_BITS) - 1;
+using Comp = std::greater<std::uint64_t>;
+
+enum class Kind { Schedule, Cancel, Run };
+
+struct Op {
+    Kind kind;
+    std::uint64_t key;
+};
+
+
+// Simulates the workload once with a std::set to decide which items are
+// live when each cancellation happens.
+std::vector<Op> script(std::size_t steps, std::size_t size, std::size_t percent) {
+    BenchRng rng;
+    std::vector<Op> ops;
+    std::set<std::uint64_t> live;
+    std::vector<std::uint64_t> keys;
+    std::uint64_t now = 0;
+    auto schedule = [&]() {
+        std::uint64_t key = ((now + rng.below(1000000)) << ID_BITS) | keys.size();
+        keys.push_back(key);
+        live.insert(key);
+        ops.push_back({ Kind::Schedule, key });
+    };
+    for(std::size_t i = 0; i < size; ++i) {
+        schedule();
+    }
+    for(std::size_t i = 0; i < steps && keys.size() < ID_MASK; ++i) {
+        schedule();
+        // Each item is cancelled with the given probability, at a random
+        // point while it is queued.
+        if(rng.below(100) < percent) {
+            auto victim = live.lower_bound(keys[rng.below(keys.size())]);
+            if(victim != live.end()) {
+                ops.push_back({ Kind::Cancel, *victim });
+                live.erase(victim);
+            }
+        }
+        if(live.size() > size) {
+            now = *live.begin() >> ID_BITS;
+            ops.push_back({ Kind::Run, *live.begin() });
+            live.erase(live.begin());
+        }
+    }
+    return ops;
+}
+
+
+void tombstones(const std::vector<Op> &ops) {
+    BinaryPQ<std::uint64_t, Comp> pq;
+    std::vector<bool> cancelled(ops.size(), false);
+    std::size_t peak = 0;
+    std::uint64_t checksum = 0;
+    Stopwatch timer;
+    for(const Op &op : ops) {
+        switch(op.kind) {
+        case Kind::Schedule:
+            pq.push(op.key);
+            break;
+        case Kind::Cancel:
+            cancelled[op.key & ID_MASK] = true;
+            break;
+        case Kind::Run:
+            while(cancelled[pq.top() & ID_MASK]) {
+                pq.pop();
+            }
+            checksum += pq.top();
+            pq.pop();
+            break;
+        }
+        peak = std::max(peak, pq.size());
+    }
+    double ns = timer.elapsedNs() / static_cast<double>(ops.size());
+    std::cout << "  tombstones in BinaryPQ: " << ns << " ns/op, peak heap " << peak
+              << ", checksum " << checksum << std::endl;
+}
+
+
+template<typename PQ>
+void erasing(const char *name, const std::vector<Op> &ops) {
+    PQ pq;
+    using Handle = decltype(pq.addNode(0));
+    std::vector<Handle> handles(ops.size());
+    std::size_t peak = 0;
+    std::uint64_t checksum = 0;
+    Stopwatch timer;
+    for(const Op &op : ops) {
+        switch(op.kind) {
+        case Kind::Schedule:
+            handles[op.key & ID_MASK] = pq.addNode(op.key);
+            break;
+        case Kind::Cancel:
+            pq.erase(handles[op.key & ID_MASK]);
+            break;
+        case Kind::Run:
+            checksum += pq.top();
+            pq.pop();
+            break;
+        }
+        peak = std::max(peak, pq.size());
+    }
+    double ns = timer.elapsedNs() / static_cast<double>(ops.size());
+    std::cout << "  erase in " << name << ": " << ns << " ns/op, peak heap " << peak
+              << ", checksum " << checksum << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t steps = argOr(argc, argv, 1, 2000000);
+    std::size_t size = argOr(argc, argv, 2, 100000);
+    std::size_t percent = argOr(argc, argv, 3, 30);
+
+    std::vector<Op> ops = script(steps, size, percent);
+    std::cout << ops.size() << " operations, about " << size << " items scheduled, "
+              << percent << "% cancelled" << std::endl;
+    tombstones(ops);
+    erasing<IndexedBinaryPQ<std::uint64_t, Comp>>("IndexedBinaryPQ", ops);
+    erasing<PairingPQ<std::uint64_t, Comp>>("PairingPQ", ops);
+    erasing<CompactPairingPQ<std::uint64_t, Comp>>("CompactPairingPQ", ops);
+    return 0;
+}
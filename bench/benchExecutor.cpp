@@ -0,0 +1,175 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Task throughput and scheduling latency of PriorityExecutor with BinaryPQ
+// and PairingPQ queues, against a pool that keeps every task in one BinaryPQ
+// under a single global mutex, as the worker count grows.
+//
+// Throughput: 'tasks' empty tasks are submitted from the main thread and the
+// clock stops when the last one has run. Latency: tasks doing about 'work'
+// ns of spinning are submitted at random priorities, and each records the
+// time from submit() to the moment a worker started it; p50/p99 are over the
+// tasks of the highest priority class, which is what the priority order is
+// for, and over all tasks.
+//
+// Usage: bench/benchExecutor [tasks] [work]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "PairingPQ.h"
+#include "PriorityExecutor.h"
+#include "bench/benchUtil.h"
+
+
+// The design PriorityExecutor replaces: one heap, one mutex, one condition
+// variable shared by every submitter and worker.
+class GlobalLockPool {
+public:
+    explicit GlobalLockPool(std::size_t workers) : stopping{ false }, sequence{ 0 } {
+        for(std::size_t i = 0; i < workers; ++i) {
+            threads.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~GlobalLockPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        ready.notify_all();
+        for(std::thread &thread : threads) thread.join();
+    }
+
+    template<typename F>
+    std::future<void> submit(int priority, F &&task) {
+        Job *job = new Job{ priority, 0, std::packaged_task<void()>(std::forward<F>(task)) };
+        std::future<void> result = job->task.get_future();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            job->sequence = sequence++;
+            jobs.push(job);
+        }
+        ready.notify_one();
+        return result;
+    }
+
+private:
+    struct Job {
+        int priority;
+        std::uint64_t sequence;
+        std::packaged_task<void()> task;
+    };
+
+    struct JobComp {
+        bool operator()(const Job *a, const Job *b) const {
+            if(a->priority != b->priority) return a->priority < b->priority;
+            return a->sequence > b->sequence;
+        }
+    };
+
+    void work() {
+        for(;;) {
+            Job *job = nullptr;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                ready.wait(guard, [this]() { return stopping || !jobs.empty(); });
+                if(jobs.empty()) return;
+                job = jobs.top();
+                jobs.pop();
+            }
+            job->task();
+            delete job;
+        }
+    }
+
+    std::mutex lock;
+    std::condition_variable ready;
+    BinaryPQ<Job*, JobComp> jobs;
+    std::vector<std::thread> threads;
+    bool stopping;
+    std::uint64_t sequence;
+}; // GlobalLockPool
+
+
+using Clock = std::chrono::steady_clock;
+
+void spinFor(std::size_t ns) {
+    Clock::time_point end = Clock::now() + std::chrono::nanoseconds(ns);
+    while(Clock::now() < end) {}
+}
+
+double percentile(std::vector<double> samples, double p) {
+    if(samples.empty()) return 0;
+    std::size_t rank = static_cast<std::size_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(rank), samples.end());
+    return samples[rank];
+}
+
+
+template<typename POOL>
+void run(const char *name, std::size_t workers, std::size_t tasks, std::size_t work) {
+    double throughput = 0;
+    {
+        std::atomic<std::size_t> done{ 0 };
+        Stopwatch timer;
+        {
+            POOL pool(workers);
+            for(std::size_t i = 0; i < tasks; ++i) {
+                pool.submit(static_cast<int>(i % 8), [&done]() { done++; });
+            }
+        }
+        throughput = static_cast<double>(done) / timer.elapsedNs() * 1e3;
+    }
+
+    const int classes = 8;
+    std::size_t latencyTasks = std::max<std::size_t>(tasks / 20, 1000);
+    std::vector<double> started(latencyTasks);
+    std::vector<Clock::time_point> submitted(latencyTasks);
+    std::vector<int> priorities(latencyTasks);
+    BenchRng rng;
+    {
+        POOL pool(workers);
+        for(std::size_t i = 0; i < latencyTasks; ++i) {
+            priorities[i] = static_cast<int>(rng.below(classes));
+            submitted[i] = Clock::now();
+            pool.submit(priorities[i], [&, i]() {
+                started[i] = std::chrono::duration<double, std::micro>(
+                    Clock::now() - submitted[i]).count();
+                spinFor(work);
+            });
+        }
+    }
+    std::vector<double> urgent;
+    for(std::size_t i = 0; i < latencyTasks; ++i) {
+        if(priorities[i] == classes - 1) urgent.push_back(started[i]);
+    }
+
+    std::cout << "  " << name << " workers=" << workers << ": "
+              << throughput << " Mtasks/s, urgent p50 " << percentile(urgent, 0.5)
+              << " us p99 " << percentile(urgent, 0.99) << " us, all p99 "
+              << percentile(started, 0.99) << " us" << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t tasks = argOr(argc, argv, 1, 200000);
+    std::size_t work = argOr(argc, argv, 2, 2000);
+
+    std::cout << "tasks = " << tasks << ", work = " << work << " ns, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+    for(std::size_t workers : { 1, 2, 4, 8 }) {
+        run<GlobalLockPool>("GlobalLock", workers, tasks, work);
+        run<PriorityExecutor<BinaryPQ>>("Executor<Binary>", workers, tasks, work);
+        run<PriorityExecutor<PairingPQ>>("Executor<Pairing>", workers, tasks, work);
+    }
+    return 0;
+}
@@ -0,0 +1,484 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Graph searches with every PQ in the tree: Dijkstra from one source, A*
+// between random pairs of vertices (graphs with coordinates only) and
+// Prim's minimum spanning forest of the graph taken as undirected.
+//
+// PQs with addNode()/updateElt() (PairingPQ, CompactPairingPQ,
+// RankPairingPQ, IndexedBinaryPQ) run each search with one entry per
+// vertex, lowering its key in place. The rest push a new entry whenever a
+// key improves and skip the stale ones as they come out. Dijkstra and A*
+// skip entries whose key is out of date rather than ones for vertices
+// already done, so they stay exact under SoftHeapPQ's out-of-order pops;
+// Prim can't, and reports how far over the minimum SoftHeapPQ's forest
+// is. BitmapPQ only fits Prim, whose keys are arc weights, and only when
+// the largest weight is below BitmapPQ::MAX_LEVELS. UnorderedPQ,
+// UnorderedFastPQ and SortedPQ spend O(n) per operation, and are only run
+// on graphs of at most 'slow limit' vertices. ShiftPairingPQ and the
+// wrappers (StablePQ, InlinePQ, ShiftablePQ, RecordingPQ) are left out:
+// the first only takes arithmetic keys, the others add to the PQ they wrap.
+//
+// Reported per PQ: time; pushes (including addNode()), pops, stale pops and
+// updateElt() calls; comparator calls; and peak heap bytes during the
+// search, measured through a replaced global operator new. SharedMemoryPQ's
+// region is mapped, not allocated, and is added to its peak. Every PQ's
+// result is checked against BinaryPQ's.
+//
+// With no arguments, synthetic graphs are generated: road-like grids with
+// coordinates and random graphs of out-degree 8. Otherwise the file is read
+// as DIMACS if it ends in ".gr" and as an edge list if not; DIMACS
+// coordinates for A* may follow.
+//
+// Usage: bench/benchGraph [graph.gr | edges.txt] [coords.co]
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include "AdaptivePQ.h"
+#include "BinaryPQ.h"
+#include "BitmapPQ.h"
+#include "CompactPairingPQ.h"
+#include "IndexedBinaryPQ.h"
+#include "PairingPQ.h"
+#include "PersistentPQ.h"
+#include "RankPairingPQ.h"
+#include "SequenceHeapPQ.h"
+#include "SharedMemoryPQ.h"
+#include "SoftHeapPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "UnorderedPQ.h"
+#include "bench/benchUtil.h"
+#include "bench/graphLoad.h"
+
+
+// Heap bytes held, as malloc sizes them, and the most held since the last
+// reset of 'peakBytes'.
+static std::size_t liveBytes = 0;
+static std::size_t peakBytes = 0;
+
+static void *tracked(void *p) {
+    if(p == nullptr) throw std::bad_alloc();
+    liveBytes += malloc_usable_size(p);
+    if(liveBytes > peakBytes) peakBytes = liveBytes;
+    return p;
+}
+
+static void untrack(void *p) {
+    if(p == nullptr) return;
+    liveBytes -= malloc_usable_size(p);
+    std::free(p);
+}
+
+void *operator new(std::size_t bytes) {
+    return tracked(std::malloc(bytes == 0 ? 1 : bytes));
+}
+
+void *operator new(std::size_t bytes, std::align_val_t alignment) {
+    std::size_t align = static_cast<std::size_t>(alignment);
+    return tracked(std::aligned_alloc(align, (bytes + align - 1) / align * align));
+}
+
+void operator delete(void *p) noexcept { untrack(p); }
+void operator delete(void *p, std::size_t) noexcept { untrack(p); }
+void operator delete(void *p, std::align_val_t) noexcept { untrack(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { untrack(p); }
+
+
+// Priority is the key; std::greater's order puts the smallest on top.
+struct Entry {
+    std::uint64_t key;
+    std::uint32_t vertex;
+};
+
+struct EntryGreater {
+    bool operator()(const Entry &a, const Entry &b) const { return a.key > b.key; }
+};
+
+using EntryComp = CountingComp<EntryGreater>;
+
+// For BitmapPQ under Prim: the lighter the arc, the higher the level.
+struct WeightLevel {
+    bool operator()(const Entry &a, const Entry &b) const {
+        ++EntryComp::calls;
+        return a.key > b.key;
+    }
+    std::size_t level(const Entry &entry) const {
+        return BitmapPQ<int>::MAX_LEVELS - 1 - static_cast<std::size_t>(entry.key);
+    }
+};
+
+static constexpr std::uint64_t UNREACHED = ~std::uint64_t{ 0 };
+
+
+struct Stats {
+    double ns = 0;
+    std::size_t pushes = 0;
+    std::size_t pops = 0;
+    std::size_t stale = 0;
+    std::size_t updates = 0;
+    std::size_t compares = 0;
+    std::size_t peak = 0;
+    std::uint64_t result = 0;
+};
+
+
+template<typename HEAP, typename = void>
+struct HasUpdateElt : std::false_type {};
+template<typename HEAP>
+struct HasUpdateElt<HEAP, std::void_t<decltype(std::declval<HEAP&>().addNode(std::declval<const Entry&>()))>>
+    : std::true_type {};
+
+template<typename HEAP>
+struct IsSharedMemory : std::false_type {};
+template<typename C>
+struct IsSharedMemory<SharedMemoryPQ<Entry, C>> : std::true_type {};
+
+template<typename HEAP>
+struct IsBitmap : std::false_type {};
+template<typename C, typename A>
+struct IsBitmap<BitmapPQ<Entry, C, A>> : std::true_type {};
+
+// SoftHeapPQ may pop an entry before a smaller one.
+template<typename HEAP>
+struct IsExact : std::true_type {};
+template<typename C, typename A>
+struct IsExact<SoftHeapPQ<Entry, C, A>> : std::false_type {};
+
+
+// Holds the PQ and the per-vertex state of one search. Handles are only
+// kept for PQs that have them.
+template<typename HEAP, bool DECREASE = HasUpdateElt<HEAP>::value>
+struct Queue {
+    static HEAP make(const Graph &graph) {
+        if constexpr(IsSharedMemory<HEAP>::value) {
+            return HEAP{ EntryComp(), graph.arcs() + graph.vertices() + 1 };
+        }
+        else if constexpr(IsBitmap<HEAP>::value) {
+            return HEAP{ HEAP::MAX_LEVELS };
+        }
+        else {
+            return HEAP{};
+        }
+    }
+
+    Queue(const Graph &graph, Stats &stats) : heap{ make(graph) }, stats{ stats } {}
+
+    // Offers 'vertex' at 'key', which is better than any key it had.
+    void offer(std::uint32_t vertex, std::uint64_t key) {
+        heap.push(Entry{ key, vertex });
+        stats.pushes++;
+    }
+
+    // The vertex of the next live entry and its key, or false when empty.
+    // 'current' is the key the vertex has now; an entry with any other key
+    // is stale.
+    template<typename Current>
+    bool next(Entry &entry, Current current) {
+        while(!heap.empty()) {
+            entry = heap.top();
+            heap.pop();
+            stats.pops++;
+            if(entry.key == current(entry.vertex)) return true;
+            stats.stale++;
+        }
+        return false;
+    }
+
+    HEAP heap;
+    Stats &stats;
+};
+
+template<typename HEAP>
+struct Queue<HEAP, true> {
+    using Handle = decltype(std::declval<HEAP&>().addNode(std::declval<const Entry&>()));
+
+    Queue(const Graph &graph, Stats &stats) :
+        heap{}, handles(graph.vertices()), queued(graph.vertices(), false), stats{ stats } {}
+
+    void offer(std::uint32_t vertex, std::uint64_t key) {
+        if(queued[vertex]) {
+            heap.updateElt(handles[vertex], Entry{ key, vertex });
+            stats.updates++;
+        }
+        else {
+            handles[vertex] = heap.addNode(Entry{ key, vertex });
+            queued[vertex] = true;
+            stats.pushes++;
+        }
+    }
+
+    template<typename Current>
+    bool next(Entry &entry, Current) {
+        if(heap.empty()) return false;
+        entry = heap.top();
+        heap.pop();
+        queued[entry.vertex] = false;
+        stats.pops++;
+        return true;
+    }
+
+    HEAP heap;
+    std::vector<Handle> handles;
+    std::vector<bool> queued;
+    Stats &stats;
+};
+
+
+// Distances from 'source'; the result is their sum over reached vertices.
+template<typename HEAP>
+void dijkstra(const Graph &graph, std::uint32_t source, Stats &stats) {
+    std::vector<std::uint64_t> dist(graph.vertices(), UNREACHED);
+    Queue<HEAP> queue{ graph, stats };
+    dist[source] = 0;
+    queue.offer(source, 0);
+    Entry entry;
+    auto current = [&dist](std::uint32_t v) { return dist[v]; };
+    while(queue.next(entry, current)) {
+        for(std::uint64_t e = graph.offsets[entry.vertex]; e < graph.offsets[entry.vertex + 1]; ++e) {
+            std::uint32_t v = graph.targets[e];
+            std::uint64_t candidate = entry.key + graph.weights[e];
+            if(candidate < dist[v]) {
+                dist[v] = candidate;
+                queue.offer(v, candidate);
+            }
+        }
+    }
+    for(std::uint64_t d : dist) {
+        if(d != UNREACHED) stats.result += d;
+    }
+}
+
+
+// Shortest paths between the 'pairs', keyed by distance so far plus
+// 'scale' times the straight-line distance left. The result is the sum of
+// the distances found. An exact PQ stops at the target; under an
+// approximate one the search runs until every entry that could still
+// improve on the best distance to the target is gone.
+template<typename HEAP>
+void astar(const Graph &graph, double scale, const std::vector<std::pair<std::uint32_t, std::uint32_t>> &pairs,
+           Stats &stats) {
+    std::vector<std::uint64_t> dist(graph.vertices(), UNREACHED);
+    std::vector<std::uint32_t> touched;
+    for(const auto &pair : pairs) {
+        std::uint32_t target = pair.second;
+        const auto &goal = graph.coords[target];
+        auto estimate = [&graph, &goal, scale](std::uint32_t v) {
+            const auto &at = graph.coords[v];
+            return static_cast<std::uint64_t>(scale * std::hypot(at.first - goal.first, at.second - goal.second));
+        };
+        auto current = [&dist, &estimate](std::uint32_t v) { return dist[v] + estimate(v); };
+        Queue<HEAP> queue{ graph, stats };
+        dist[pair.first] = 0;
+        touched.push_back(pair.first);
+        queue.offer(pair.first, estimate(pair.first));
+        Entry entry;
+        while(queue.next(entry, current)) {
+            if(entry.vertex == target && IsExact<HEAP>::value) break;
+            if(entry.key >= dist[target]) continue;
+            std::uint64_t at = dist[entry.vertex];
+            for(std::uint64_t e = graph.offsets[entry.vertex]; e < graph.offsets[entry.vertex + 1]; ++e) {
+                std::uint32_t v = graph.targets[e];
+                std::uint64_t candidate = at + graph.weights[e];
+                if(candidate < dist[v]) {
+                    if(dist[v] == UNREACHED) touched.push_back(v);
+                    dist[v] = candidate;
+                    queue.offer(v, candidate + estimate(v));
+                }
+            }
+        }
+        if(dist[target] != UNREACHED) stats.result += dist[target];
+        for(std::uint32_t v : touched) dist[v] = UNREACHED;
+        touched.clear();
+    }
+}
+
+
+// A minimum spanning forest of the undirected 'graph'; the result is its
+// weight.
+template<typename HEAP>
+void prim(const Graph &graph, Stats &stats) {
+    std::vector<std::uint64_t> best(graph.vertices(), UNREACHED);
+    std::vector<bool> inTree(graph.vertices(), false);
+    Queue<HEAP> queue{ graph, stats };
+    Entry entry;
+    auto current = [&best, &inTree](std::uint32_t v) { return inTree[v] ? UNREACHED : best[v]; };
+    for(std::uint32_t root = 0; root < graph.vertices(); ++root) {
+        if(inTree[root]) continue;
+        best[root] = 0;
+        queue.offer(root, 0);
+        while(queue.next(entry, current)) {
+            inTree[entry.vertex] = true;
+            stats.result += entry.key;
+            for(std::uint64_t e = graph.offsets[entry.vertex]; e < graph.offsets[entry.vertex + 1]; ++e) {
+                std::uint32_t v = graph.targets[e];
+                if(!inTree[v] && graph.weights[e] < best[v]) {
+                    best[v] = graph.weights[e];
+                    queue.offer(v, best[v]);
+                }
+            }
+        }
+    }
+}
+
+
+// Runs 'search' on a fresh PQ of type HEAP and prints a row, checking the
+// result against 'expected' unless it is 0.
+template<typename HEAP, typename Search>
+Stats measure(const char *name, Search search, std::uint64_t expected, std::size_t mapped = 0) {
+    Stats stats;
+    EntryComp::calls = 0;
+    std::size_t base = liveBytes;
+    peakBytes = liveBytes;
+    Stopwatch clock;
+    search(stats);
+    stats.ns = clock.elapsedNs();
+    stats.compares = EntryComp::calls;
+    stats.peak = peakBytes - base + mapped;
+
+    std::cout << "    " << std::left << std::setw(17) << name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(10) << stats.ns / 1e6
+              << std::setw(11) << stats.pushes << std::setw(11) << stats.pops
+              << std::setw(11) << stats.stale << std::setw(10) << stats.updates
+              << std::setw(12) << stats.compares
+              << std::setw(9) << static_cast<double>(stats.peak) / (1 << 20);
+    if(expected != 0 && stats.result != expected) {
+        std::cout << "  result differs by " << std::showpos
+                  << static_cast<long long>(stats.result - expected) << std::noshowpos;
+    }
+    std::cout << std::defaultfloat << std::endl;
+    return stats;
+}
+
+
+template<typename T>
+struct Tag {
+    using type = T;
+};
+
+
+// One search, with every PQ that fits it. 'Run' is a class template whose
+// run<HEAP>(stats) does the search.
+template<typename Run>
+void everyPQ(const char *title, const Graph &graph, std::size_t slowLimit, Run run) {
+    std::cout << "  " << title << std::endl;
+    std::cout << "    PQ                      ms     pushes       pops      stale   updates    compares  peak MB"
+              << std::endl;
+    std::uint64_t expected = measure<BinaryPQ<Entry, EntryComp>>(
+        "BinaryPQ", [&run](Stats &s) { run.template go<BinaryPQ<Entry, EntryComp>>(s); }, 0).result;
+    auto row = [&run, expected](const char *name, auto tag, std::size_t mapped = 0) {
+        using HEAP = typename decltype(tag)::type;
+        measure<HEAP>(name, [&run](Stats &s) { run.template go<HEAP>(s); }, expected, mapped);
+    };
+    row("PairingPQ", Tag<PairingPQ<Entry, EntryComp>>{});
+    row("CompactPairingPQ", Tag<CompactPairingPQ<Entry, EntryComp>>{});
+    row("RankPairingPQ", Tag<RankPairingPQ<Entry, EntryComp>>{});
+    row("IndexedBinaryPQ", Tag<IndexedBinaryPQ<Entry, EntryComp>>{});
+    row("AdaptivePQ", Tag<AdaptivePQ<Entry, EntryComp>>{});
+    row("SequenceHeapPQ", Tag<SequenceHeapPQ<Entry, EntryComp>>{});
+    row("SoftHeapPQ", Tag<SoftHeapPQ<Entry, EntryComp>>{});
+    row("PersistentPQ", Tag<PersistentPQ<Entry, EntryComp>>{});
+    row("SharedMemoryPQ", Tag<SharedMemoryPQ<Entry, EntryComp>>{},
+        SharedMemoryPQ<Entry, EntryComp>::bytesFor(graph.arcs() + graph.vertices() + 1));
+    if(graph.vertices() <= slowLimit) {
+        row("UnorderedPQ", Tag<UnorderedPQ<Entry, EntryComp>>{});
+        row("UnorderedFastPQ", Tag<UnorderedFastPQ<Entry, EntryComp>>{});
+        row("SortedPQ", Tag<SortedPQ<Entry, EntryComp>>{});
+    }
+    else {
+        std::cout << "    UnorderedPQ, UnorderedFastPQ, SortedPQ: skipped, more than " << slowLimit
+                  << " vertices" << std::endl;
+    }
+    if constexpr(Run::PRIM) {
+        std::uint32_t heaviest = 0;
+        for(std::uint32_t weight : graph.weights) heaviest = std::max(heaviest, weight);
+        if(heaviest < BitmapPQ<int>::MAX_LEVELS) {
+            row("BitmapPQ", Tag<BitmapPQ<Entry, WeightLevel>>{});
+        }
+        else {
+            std::cout << "    BitmapPQ: skipped, weights of " << BitmapPQ<int>::MAX_LEVELS
+                      << " or more" << std::endl;
+        }
+    }
+}
+
+
+struct DijkstraRun {
+    static constexpr bool PRIM = false;
+    const Graph &graph;
+    template<typename HEAP> void go(Stats &stats) { dijkstra<HEAP>(graph, 0, stats); }
+};
+
+struct AStarRun {
+    static constexpr bool PRIM = false;
+    const Graph &graph;
+    double scale;
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>> &pairs;
+    template<typename HEAP> void go(Stats &stats) { astar<HEAP>(graph, scale, pairs, stats); }
+};
+
+struct PrimRun {
+    static constexpr bool PRIM = true;
+    const Graph &graph;
+    template<typename HEAP> void go(Stats &stats) { prim<HEAP>(graph, stats); }
+};
+
+
+void suite(const std::string &title, const Graph &graph, std::size_t slowLimit) {
+    std::cout << title << ": " << graph.vertices() << " vertices, " << graph.arcs() << " arcs" << std::endl;
+    if(graph.vertices() == 0) return;
+    everyPQ("Dijkstra from vertex 0", graph, slowLimit, DijkstraRun{ graph });
+
+    double scale = heuristicScale(graph);
+    if(graph.coords.empty()) {
+        std::cout << "  A*: skipped, no coordinates" << std::endl;
+    }
+    else {
+        BenchRng rng{ 281 };
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+        for(int i = 0; i < 20; ++i) {
+            pairs.emplace_back(static_cast<std::uint32_t>(rng.below(graph.vertices())),
+                               static_cast<std::uint32_t>(rng.below(graph.vertices())));
+        }
+        everyPQ("A* between 20 random pairs", graph, slowLimit, AStarRun{ graph, scale, pairs });
+    }
+
+    Graph both = undirected(graph);
+    everyPQ("Prim, minimum spanning forest", both, slowLimit, PrimRun{ both });
+    std::cout << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    const std::size_t slowLimit = 20000;
+    try {
+        if(argc > 1) {
+            Stopwatch clock;
+            Graph graph = loadGraph(argv[1]);
+            if(argc > 2) loadDimacsCoords(argv[2], graph);
+            std::cout << "loaded in " << clock.elapsedNs() / 1e6 << " ms" << std::endl;
+            suite(argv[1], graph, slowLimit);
+            return 0;
+        }
+        BenchRng rng;
+        suite("grid 100 x 100", gridGraph(100, rng), slowLimit);
+        suite("random, out-degree 8", randomGraph(10000, 8, rng), slowLimit);
+        suite("grid 700 x 700", gridGraph(700, rng), slowLimit);
+        suite("random, out-degree 8", randomGraph(200000, 8, rng), slowLimit);
+    }
+    catch(const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Short-lived queues: each cycle constructs a PQ, pushes m keys, pops them
+// all and destroys it. Each PQ is run as is and as InlinePQ<PQ, int,
+// std::less<int>, 16>, for m below, at and above the inline capacity.
+// Reported per cycle: time, and calls to the global operator new, counted
+// by replacing it in this driver.
+//
+// Usage: bench/benchInline [cycles]
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "InlinePQ.h"
+#include "PairingPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "UnorderedPQ.h"
+#include "bench/benchUtil.h"
+
+
+static std::size_t newCalls = 0;
+
+void *operator new(std::size_t bytes) {
+    ++newCalls;
+    if(void *p = std::malloc(bytes == 0 ? 1 : bytes)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned forms.
+void *operator new(std::size_t bytes, std::align_val_t alignment) {
+    ++newCalls;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if(void *p = std::aligned_alloc(align, (bytes + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+
+template<typename PQ>
+void cycles(const char *name, std::size_t count, std::size_t m, const std::vector<int> &keys) {
+    std::size_t before = newCalls;
+    Stopwatch clock;
+    for(std::size_t c = 0; c < count; ++c) {
+        PQ pq;
+        for(std::size_t i = 0; i < m; ++i) pq.push(keys[(c + i) % keys.size()]);
+        while(!pq.empty()) {
+            doNotOptimize(pq.top());
+            pq.pop();
+        }
+    }
+    double elapsed = clock.elapsedNs();
+    double per = static_cast<double>(count);
+    std::cout << "    " << name << elapsed / per << " ns/cycle, "
+              << static_cast<double>(newCalls - before) / per << " new/cycle" << std::endl;
+}
+
+
+template<template<typename...> typename PQ>
+void compare(const char *name, std::size_t count, std::size_t m, const std::vector<int> &keys) {
+    std::cout << "  " << name << std::endl;
+    cycles<PQ<int>>("heap   : ", count, m, keys);
+    cycles<InlinePQ<PQ, int, std::less<int>, 16>>("inline : ", count, m, keys);
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t count = argOr(argc, argv, 1, 200000);
+    std::vector<int> keys(4096);
+    BenchRng rng;
+    for(int &key : keys) key = static_cast<int>(rng.below(1000000));
+
+    for(std::size_t m : { 4, 8, 16, 32 }) {
+        std::cout << "m = " << m << " keys per queue, " << count << " cycles, inline capacity 16"
+                  << std::endl;
+        compare<BinaryPQ>("BinaryPQ", count, m, keys);
+        compare<SortedPQ>("SortedPQ", count, m, keys);
+        compare<UnorderedPQ>("UnorderedPQ", count, m, keys);
+        compare<UnorderedFastPQ>("UnorderedFastPQ", count, m, keys);
+        compare<PairingPQ>("PairingPQ", count, m, keys);
+    }
+    return 0;
+}
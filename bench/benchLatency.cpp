@@ -0,0 +1,124 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Per-operation latency rather than throughput: bursts of n pushes followed
+// by n pops, as a latency-sensitive queue sees them, timing every push and
+// pop on its own. PairingPQ pays for a burst in the first pop after it,
+// which pairs the root's n children; BoundedPairingPQ pairs during the
+// pushes and bounds every pop to O(log(n)) links. BinaryPQ is the
+// reference.
+//
+// Reported per PQ: mean, p50, p99, p99.9, p99.99 and max latency in ns for
+// push and pop, the slowest first pop after a burst, then a histogram of
+// pop latencies in power-of-two buckets. The clock read costs a few tens of
+// ns and is included in every sample, and so is any preemption: compare
+// the max against BinaryPQ's to tell the two apart.
+// All PQs must pop the same keys, checked through a checksum.
+//
+// Usage: bench/benchLatency [max n] [ops per size]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "BoundedPairingPQ.h"
+#include "PairingPQ.h"
+#include "bench/benchUtil.h"
+
+
+// Buckets [2^b, 2^(b+1)) ns, the first also holding everything below.
+constexpr std::size_t BUCKETS = 24;
+constexpr std::size_t FIRST_BUCKET = 4;
+
+
+std::uint64_t nowNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+
+// Prints the summary of 'samples', which it sorts.
+void summarize(const char *what, std::vector<std::uint64_t> &samples) {
+    std::sort(samples.begin(), samples.end());
+    auto at = [&samples](double fraction) {
+        auto idx = static_cast<std::size_t>(fraction * static_cast<double>(samples.size() - 1));
+        return samples[idx];
+    };
+    std::uint64_t total = 0;
+    for(std::uint64_t ns : samples) total += ns;
+    std::cout << "      " << what << std::setw(10) << total / samples.size()
+              << std::setw(10) << at(0.5) << std::setw(10) << at(0.99)
+              << std::setw(10) << at(0.999) << std::setw(10) << at(0.9999)
+              << std::setw(12) << samples.back() << std::endl;
+}
+
+
+void histogram(const std::vector<std::uint64_t> &samples) {
+    std::vector<std::size_t> counts(BUCKETS);
+    for(std::uint64_t ns : samples) {
+        std::size_t bucket = FIRST_BUCKET;
+        while(bucket + 1 < FIRST_BUCKET + BUCKETS && (ns >> (bucket + 1)) != 0) ++bucket;
+        counts[bucket - FIRST_BUCKET]++;
+    }
+    std::size_t last = BUCKETS;
+    while(last > 1 && counts[last - 1] == 0) --last;
+    std::cout << "      pop histogram (ns >= : count)";
+    for(std::size_t b = 0; b < last; ++b) {
+        if(b % 6 == 0) std::cout << std::endl << "       ";
+        std::cout << std::setw(11) << (std::uint64_t{ 1 } << (b + FIRST_BUCKET)) << ":"
+                  << std::setw(8) << counts[b];
+    }
+    std::cout << std::endl;
+}
+
+
+template<typename PQ>
+void run(const char *name, std::size_t n, std::size_t bursts, const std::vector<std::uint32_t> &keys) {
+    std::vector<std::uint64_t> pushes, pops;
+    pushes.reserve(n * bursts);
+    pops.reserve(n * bursts);
+    std::uint64_t checksum = 0, firstPop = 0;
+    PQ pq;
+    for(std::size_t burst = 0, next = 0; burst < bursts; ++burst) {
+        for(std::size_t i = 0; i < n; ++i) {
+            std::uint32_t key = keys[next++ % keys.size()];
+            std::uint64_t start = nowNs();
+            pq.push(key);
+            pushes.push_back(nowNs() - start);
+        }
+        for(std::size_t i = 0; i < n; ++i) {
+            checksum += pq.top() * (i + 1);
+            std::uint64_t start = nowNs();
+            pq.pop();
+            pops.push_back(nowNs() - start);
+            if(i == 0) firstPop = std::max(firstPop, pops.back());
+        }
+    }
+    std::cout << "    " << name << "  (checksum " << checksum << ")" << std::endl
+              << "                 mean       p50       p99     p99.9    p99.99         max" << std::endl;
+    summarize("push: ", pushes);
+    summarize("pop:  ", pops);
+    std::cout << "      slowest first pop after a burst: " << firstPop << std::endl;
+    histogram(pops);
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t maxN = argOr(argc, argv, 1, 1000000);
+    std::size_t ops = argOr(argc, argv, 2, 2000000);
+    std::vector<std::uint32_t> keys(1 << 22);
+    BenchRng rng;
+    for(std::uint32_t &key : keys) key = static_cast<std::uint32_t>(rng.below(1000000000));
+
+    for(std::size_t n = 1000; n <= maxN; n *= 10) {
+        std::size_t bursts = std::max<std::size_t>(1, ops / n);
+        std::cout << "n = " << n << " per burst, " << bursts << " bursts; latency in ns" << std::endl;
+        run<BinaryPQ<std::uint32_t>>("BinaryPQ        ", n, bursts, keys);
+        run<PairingPQ<std::uint32_t>>("PairingPQ       ", n, bursts, keys);
+        run<BoundedPairingPQ<std::uint32_t>>("BoundedPairingPQ", n, bursts, keys);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Merging k sorted runs two ways: LoserTreeMerge over IteratorRuns, against
+// pushing each run's head into a BinaryPQ through an Eecs281PQ reference and
+// replacing the popped head with the next element of its run, which is how
+// the merges we replace were written.
+//
+// n keys in total are split evenly over k runs, for k = 2, 4, ..., max k.
+// Reported per merged element: time, and comparator calls from a separate
+// run with a counting comparator. Both merges must produce the same output,
+// checked by a checksum.
+//
+// Usage: bench/benchMerge [n] [max k]
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "LoserTreeMerge.h"
+#include "bench/benchUtil.h"
+
+
+struct Head {
+    std::uint64_t key;
+    std::size_t run;
+};
+
+struct HeadLess {
+    bool operator()(const Head &a, const Head &b) const { return a.key < b.key; }
+};
+
+
+template<typename COMP_FUNCTOR>
+std::uint64_t viaBinaryPQ(const std::vector<std::vector<std::uint64_t>> &runs) {
+    BinaryPQ<Head, COMP_FUNCTOR> heads;
+    Eecs281PQ<Head, COMP_FUNCTOR> &pq = heads;
+    std::vector<std::size_t> next(runs.size(), 1);
+    for(std::size_t r = 0; r < runs.size(); ++r) {
+        if(!runs[r].empty()) pq.push(Head{ runs[r][0], r });
+    }
+    std::uint64_t checksum = 0;
+    std::uint64_t position = 0;
+    while(!pq.empty()) {
+        Head head = pq.top();
+        pq.pop();
+        checksum += head.key * ++position;
+        if(next[head.run] < runs[head.run].size()) {
+            pq.push(Head{ runs[head.run][next[head.run]++], head.run });
+        }
+    }
+    return checksum;
+}
+
+
+template<typename COMP_FUNCTOR>
+std::uint64_t viaLoserTree(const std::vector<std::vector<std::uint64_t>> &runs) {
+    using Run = IteratorRun<std::vector<std::uint64_t>::const_iterator>;
+    std::vector<Run> sources;
+    for(const auto &run : runs) sources.emplace_back(run.cbegin(), run.cend());
+    LoserTreeMerge<Run, COMP_FUNCTOR> merge{ sources.begin(), sources.end() };
+    std::uint64_t checksum = 0;
+    std::uint64_t position = 0;
+    for(std::uint64_t key : merge) {
+        checksum += key * ++position;
+    }
+    return checksum;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 4000000);
+    std::size_t maxK = argOr(argc, argv, 2, 4096);
+    BenchRng rng;
+    std::cout << "n = " << n << "; ns and comparisons per merged element" << std::endl;
+    std::cout << "     k   BinaryPQ ns  cmp   LoserTree ns  cmp" << std::endl;
+    for(std::size_t k = 2; k <= maxK; k *= 2) {
+        std::vector<std::vector<std::uint64_t>> runs(k);
+        for(std::size_t i = 0; i < n; ++i) runs[i % k].push_back(rng.next() >> 20);
+        for(auto &run : runs) std::sort(run.begin(), run.end(), std::greater<std::uint64_t>());
+
+        Stopwatch clock;
+        std::uint64_t heapSum = viaBinaryPQ<HeadLess>(runs);
+        double heapNs = clock.elapsedNs();
+        clock.reset();
+        std::uint64_t treeSum = viaLoserTree<std::less<std::uint64_t>>(runs);
+        double treeNs = clock.elapsedNs();
+
+        CountingComp<HeadLess>::calls = 0;
+        viaBinaryPQ<CountingComp<HeadLess>>(runs);
+        double heapCmp = static_cast<double>(CountingComp<HeadLess>::calls);
+        CountingComp<std::less<std::uint64_t>>::calls = 0;
+        viaLoserTree<CountingComp<std::less<std::uint64_t>>>(runs);
+        double treeCmp = static_cast<double>(CountingComp<std::less<std::uint64_t>>::calls);
+
+        double per = static_cast<double>(n);
+        std::cout << "  " << k << "\t" << heapNs / per << "\t" << heapCmp / per << "\t"
+                  << treeNs / per << "\t" << treeCmp / per
+                  << (heapSum == treeSum ? "" : "  OUTPUTS DIFFER") << std::endl;
+    }
+    return 0;
+}
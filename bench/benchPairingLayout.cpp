@@ -0,0 +1,73 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Node layout of PairingPQ (pointers, one allocation per node) against
+// CompactPairingPQ (32-bit indices into a pool), for int elements. Reports
+// the bytes per node, ns per pop + push over a hold workload, and ns per
+// updateElt() when the updated nodes sit at the far end of a long sibling
+// list: 'n' nodes are added under one root, then each, oldest first, is
+// raised above the current root. A cut that walks the sibling list to find
+// the node's left neighbour makes that quadratic.
+//
+// Usage: bench/benchPairingLayout [n]
+
+#include <iostream>
+#include <vector>
+
+#include "CompactPairingPQ.h"
+#include "PairingPQ.h"
+#include "bench/benchUtil.h"
+
+
+template<typename PQ>
+double hold(const std::vector<int> &values) {
+    PQ pq;
+    std::size_t n = values.size() / 2;
+    for(std::size_t i = 0; i < n; ++i) {
+        pq.push(values[i]);
+    }
+    Stopwatch timer;
+    for(std::size_t i = n; i < values.size(); ++i) {
+        doNotOptimize(pq.top());
+        pq.pop();
+        pq.push(values[i]);
+    }
+    return timer.elapsedNs() / static_cast<double>(values.size() - n);
+}
+
+
+template<typename PQ>
+double lateCuts(std::size_t n) {
+    using Handle = decltype(std::declval<PQ&>().addNode(0));
+    PQ pq;
+    std::vector<Handle> handles;
+    int top = static_cast<int>(n);
+    pq.push(top);
+    for(std::size_t i = 0; i < n; ++i) {
+        handles.push_back(pq.addNode(static_cast<int>(i)));
+    }
+    Stopwatch timer;
+    for(Handle handle : handles) {
+        pq.updateElt(handle, ++top);
+    }
+    double ns = timer.elapsedNs() / static_cast<double>(n);
+    doNotOptimize(pq.top());
+    return ns;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 1000000);
+    BenchRng rng;
+    std::vector<int> values(2 * n);
+    for(int &value : values) value = static_cast<int>(rng.below(1000000000));
+
+    std::cout << "n = " << n << "; bytes per node: PairingPQ "
+              << sizeof(PairingPQ<int>::Node) << " + allocator overhead, CompactPairingPQ "
+              << CompactPairingPQ<int>::nodeBytes() << std::endl;
+    std::cout << "  hold pop + push: PairingPQ " << hold<PairingPQ<int>>(values)
+              << " ns, CompactPairingPQ " << hold<CompactPairingPQ<int>>(values) << " ns" << std::endl;
+    std::cout << "  updateElt at the end of a sibling list: PairingPQ "
+              << lateCuts<PairingPQ<int>>(n) << " ns, CompactPairingPQ "
+              << lateCuts<CompactPairingPQ<int>>(n) << " ns" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Branching search, as our planner does it: a depth-first walk of a tree of
+// alternatives, each state holding a PQ of n pending keys. Every child
+// starts from a copy of its parent's PQ, pops the best key and pushes two
+// new ones, and each leaf reads its top. Copying BinaryPQ and PairingPQ is
+// O(n); copying PersistentPQ is O(1), and the child's pop and pushes build
+// O(log(n)) new nodes.
+//
+// All variants see the same keys in the same order and must read the same
+// tops, checked through a checksum.
+//
+// Usage: bench/benchPersistent [n] [branching] [depth]
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "PairingPQ.h"
+#include "PersistentPQ.h"
+#include "bench/benchUtil.h"
+
+
+struct Search {
+    std::size_t branching;
+    const std::vector<std::uint32_t> &fresh;
+    std::size_t next;
+    std::uint64_t checksum;
+    std::size_t copies;
+
+    template<typename PQ>
+    void explore(const PQ &state, std::size_t depth) {
+        if(depth == 0) {
+            checksum += state.top();
+            return;
+        }
+        for(std::size_t b = 0; b < branching; ++b) {
+            PQ child{ state };
+            copies++;
+            child.pop();
+            child.push(fresh[next++ % fresh.size()]);
+            child.push(fresh[next++ % fresh.size()]);
+            explore(child, depth - 1);
+        }
+    }
+};
+
+
+template<typename PQ>
+void run(const char *name, std::size_t n, std::size_t branching, std::size_t depth,
+         const std::vector<std::uint32_t> &fresh) {
+    PQ start;
+    for(std::size_t i = 0; i < n; ++i) start.push(fresh[i]);
+    Search search{ branching, fresh, n, 0, 0 };
+    Stopwatch clock;
+    search.explore(start, depth);
+    double elapsed = clock.elapsedNs();
+    std::cout << "  " << name << elapsed / 1e6 << " ms, "
+              << elapsed / static_cast<double>(search.copies) << " ns/child  (checksum "
+              << search.checksum << ")" << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 10000);
+    std::size_t branching = argOr(argc, argv, 2, 4);
+    std::size_t depth = argOr(argc, argv, 3, 6);
+    std::vector<std::uint32_t> fresh(1 << 20);
+    BenchRng rng;
+    for(std::uint32_t &key : fresh) key = static_cast<std::uint32_t>(rng.below(1000000000));
+
+    std::size_t children = 0;
+    for(std::size_t level = 0, width = 1; level < depth; ++level) {
+        width *= branching;
+        children += width;
+    }
+    std::cout << "n = " << n << " keys per state, branching " << branching << ", depth " << depth
+              << ": " << children << " children" << std::endl;
+    run<BinaryPQ<std::uint32_t>>("BinaryPQ, copied     : ", n, branching, depth, fresh);
+    run<PairingPQ<std::uint32_t>>("PairingPQ, copied    : ", n, branching, depth, fresh);
+    run<PersistentPQ<std::uint32_t>>("PersistentPQ, shared : ", n, branching, depth, fresh);
+    return 0;
+}
@@ -0,0 +1,61 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Hardware counters per operation for each phase of a PQ's life: pushing n
+// random ints, updatePriorities() over all of them, and popping them all.
+// Cycles, instructions, L1d/LLC/dTLB misses and branch misses are read with
+// perf_event_open (see perfCounters.h); where the machine does not expose
+// them only ns/op is shown.
+//
+// Usage: bench/benchPhases [n]
+
+#include <iostream>
+#include <vector>
+
+#include "AdaptivePQ.h"
+#include "BinaryPQ.h"
+#include "CompactPairingPQ.h"
+#include "IndexedBinaryPQ.h"
+#include "PairingPQ.h"
+#include "RankPairingPQ.h"
+#include "SequenceHeapPQ.h"
+#include "bench/benchUtil.h"
+#include "bench/perfCounters.h"
+
+
+template<typename PQ>
+void phases(const char *name, const std::vector<int> &keys, PerfCounters &counters) {
+    std::cout << name << std::endl;
+    PQ pq;
+    measureRegion(counters, "  push            ", keys.size(), [&]() {
+        for(int key : keys) pq.push(key);
+    });
+    measureRegion(counters, "  updatePriorities", keys.size(), [&]() {
+        pq.updatePriorities();
+    });
+    measureRegion(counters, "  pop             ", keys.size(), [&]() {
+        while(!pq.empty()) {
+            doNotOptimize(pq.top());
+            pq.pop();
+        }
+    });
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 1000000);
+    BenchRng rng;
+    std::vector<int> keys(n);
+    for(int &key : keys) key = static_cast<int>(rng.next() >> 33);
+
+    PerfCounters counters;
+    std::cout << "n = " << n << "; ";
+    counters.describe(std::cout);
+    phases<BinaryPQ<int>>("BinaryPQ", keys, counters);
+    phases<IndexedBinaryPQ<int>>("IndexedBinaryPQ", keys, counters);
+    phases<PairingPQ<int>>("PairingPQ", keys, counters);
+    phases<CompactPairingPQ<int>>("CompactPairingPQ", keys, counters);
+    phases<RankPairingPQ<int>>("RankPairingPQ", keys, counters);
+    phases<SequenceHeapPQ<int>>("SequenceHeapPQ", keys, counters);
+    phases<AdaptivePQ<int>>("AdaptivePQ", keys, counters);
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Short-lived queues: each cycle creates a PQ, pushes 'size' ints, pops
+// them all and destroys it, as a per-request scheduler or a search that
+// builds a fresh frontier each time would. Compares the default allocator
+// with the pmr:: aliases drawing from a monotonic_buffer_resource over a
+// buffer reused by every cycle, so no cycle reaches malloc unless the
+// buffer runs out, and with an unsynchronized_pool_resource kept across
+// cycles. Reports ns per element (one push and one pop).
+//
+// Usage: bench/benchPmr [cycles] [size] [bufferKiB]
+
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <vector>
+
+#include "AdaptivePQ.h"
+#include "BinaryPQ.h"
+#include "CompactPairingPQ.h"
+#include "IndexedBinaryPQ.h"
+#include "PairingPQ.h"
+#include "RankPairingPQ.h"
+#include "SequenceHeapPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "UnorderedPQ.h"
+#include "bench/benchUtil.h"
+
+
+// Passes allocations on to new/delete, counting them; the arena's
+// upstream, to show how often it ran past its buffer.
+class SpillCounter : public std::pmr::memory_resource {
+public:
+    std::size_t spills = 0;
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++spills;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+}; // SpillCounter
+
+
+// One create/fill/drain/destroy cycle; 'make' builds the empty PQ.
+template<typename Make>
+long long cycle(const std::vector<int> &values, Make &&make) {
+    auto pq = make();
+    for(int value : values) {
+        pq.push(value);
+    }
+    long long checksum = 0;
+    while(!pq.empty()) {
+        checksum += pq.top();
+        pq.pop();
+    }
+    return checksum;
+}
+
+
+template<template<typename...> typename PQ>
+void compare(const char *name, std::size_t cycles, const std::vector<int> &values,
+             std::vector<std::byte> &buffer) {
+    using Default = PQ<int, std::less<int>>;
+    using Pmr = PQ<int, std::less<int>, std::pmr::polymorphic_allocator<int>>;
+    double elements = static_cast<double>(cycles * values.size());
+    long long checksums[3] = { 0, 0, 0 };
+
+    Stopwatch timer;
+    for(std::size_t i = 0; i < cycles; ++i) {
+        checksums[0] += cycle(values, []() { return Default{}; });
+    }
+    double plain = timer.elapsedNs() / elements;
+
+    SpillCounter upstream;
+    timer.reset();
+    for(std::size_t i = 0; i < cycles; ++i) {
+        std::pmr::monotonic_buffer_resource arena{ buffer.data(), buffer.size(), &upstream };
+        checksums[1] += cycle(values, [&arena]() { return Pmr{ &arena }; });
+    }
+    double monotonic = timer.elapsedNs() / elements;
+
+    std::pmr::unsynchronized_pool_resource pool;
+    timer.reset();
+    for(std::size_t i = 0; i < cycles; ++i) {
+        checksums[2] += cycle(values, [&pool]() { return Pmr{ &pool }; });
+    }
+    double pooled = timer.elapsedNs() / elements;
+
+    std::cout << "  " << name << ": default " << plain << " ns, monotonic " << monotonic
+              << " ns (" << upstream.spills << " upstream allocations), pool " << pooled << " ns";
+    if(checksums[0] != checksums[1] || checksums[0] != checksums[2]) {
+        std::cout << ", CHECKSUM MISMATCH";
+    }
+    std::cout << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t cycles = argOr(argc, argv, 1, 20000);
+    std::size_t size = argOr(argc, argv, 2, 200);
+    std::size_t kib = argOr(argc, argv, 3, 256);
+
+    BenchRng rng;
+    std::vector<int> values(size);
+    for(int &value : values) value = static_cast<int>(rng.below(1000000));
+    std::vector<std::byte> buffer(kib * 1024);
+
+    std::cout << cycles << " cycles of " << size << " pushes and pops, " << kib
+              << " KiB arena; ns per element" << std::endl;
+    compare<UnorderedPQ>("UnorderedPQ", cycles, values, buffer);
+    compare<UnorderedFastPQ>("UnorderedFastPQ", cycles, values, buffer);
+    compare<SortedPQ>("SortedPQ", cycles, values, buffer);
+    compare<BinaryPQ>("BinaryPQ", cycles, values, buffer);
+    compare<IndexedBinaryPQ>("IndexedBinaryPQ", cycles, values, buffer);
+    compare<PairingPQ>("PairingPQ", cycles, values, buffer);
+    compare<CompactPairingPQ>("CompactPairingPQ", cycles, values, buffer);
+    compare<RankPairingPQ>("RankPairingPQ", cycles, values, buffer);
+    compare<SequenceHeapPQ>("SequenceHeapPQ", cycles, values, buffer);
+    compare<AdaptivePQ>("AdaptivePQ", cycles, values, buffer);
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Compares extracting elements one at a time through the Eecs281PQ
+// interface (a virtual top() and pop() per element) with the batch pop_k()
+// of each PQ, for a few batch sizes, and drain() against popping
+// everything.
+//
+// Usage: bench/benchPopK [n]
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "PairingPQ.h"
+#include "RankPairingPQ.h"
+#include "SequenceHeapPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "bench/benchUtil.h"
+
+
+// Pops the whole PQ in batches of k, either element by element through the
+// base class or with pop_k(), and reports ns per element.
+template<typename PQ>
+void runBatches(const char *name, const std::vector<int> &keys, std::size_t k) {
+    std::vector<int> out(k);
+    double n = static_cast<double>(keys.size());
+
+    PQ loop(keys.begin(), keys.end());
+    Eecs281PQ<int> &base = loop;
+    Stopwatch timer;
+    while(!base.empty()) {
+        for(std::size_t i = 0; i < k && !base.empty(); ++i) {
+            out[i] = base.top();
+            base.pop();
+        }
+        doNotOptimize(out.front());
+    }
+    double loopNs = timer.elapsedNs() / n;
+
+    PQ batch(keys.begin(), keys.end());
+    timer.reset();
+    while(!batch.empty()) {
+        batch.pop_k(k, out.begin());
+        doNotOptimize(out.front());
+    }
+    double batchNs = timer.elapsedNs() / n;
+
+    std::cout << "  " << name << " k=" << k << ": top/pop " << loopNs
+              << " ns/elt, pop_k " << batchNs << " ns/elt" << std::endl;
+}
+
+
+// Empties the PQ with one drain() call.
+template<typename PQ>
+void runDrain(const char *name, const std::vector<int> &keys) {
+    std::vector<int> out;
+    out.reserve(keys.size());
+    PQ pq(keys.begin(), keys.end());
+    Stopwatch timer;
+    pq.drain(std::back_inserter(out));
+    doNotOptimize(out.front());
+    std::cout << "  " << name << " drain: "
+              << timer.elapsedNs() / static_cast<double>(keys.size())
+              << " ns/elt" << std::endl;
+}
+
+
+template<typename PQ>
+void runAll(const char *name, const std::vector<int> &keys) {
+    for(std::size_t k : { 1, 16, 256 }) {
+        runBatches<PQ>(name, keys, k);
+    }
+    runDrain<PQ>(name, keys);
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 1000000);
+    BenchRng rng;
+    std::vector<int> keys(n);
+    for(int &key : keys) {
+        key = static_cast<int>(rng.next() >> 1);
+    }
+
+    std::cout << "n = " << n << std::endl;
+    runAll<BinaryPQ<int>>("Binary", keys);
+    runAll<PairingPQ<int>>("Pairing", keys);
+    runAll<RankPairingPQ<int>>("RankPairing", keys);
+    runAll<SequenceHeapPQ<int>>("SequenceHeap", keys);
+    runAll<SortedPQ<int>>("Sorted", keys);
+
+    // The unordered scans are O(n) per pop, so they get a smaller input.
+    std::vector<int> small(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(std::min<std::size_t>(n, 20000)));
+    runAll<UnorderedFastPQ<int>>("UnorderedFast", small);
+    return 0;
+}
@@ -0,0 +1,113 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// SequenceHeapPQ against BinaryPQ and a 4-ary heap on queues much larger
+// than the last-level cache.
+//
+// Two workloads per size n:
+//   fill/drain - push n random keys, then pop all of them
+//   steady     - after the fill, n rounds of pop-then-push of a key a bit
+//                less extreme than the one popped (the "hold" model, which
+//                keeps the queue at size n)
+//
+// Usage: bench/benchSequenceHeap [n ...]     (default: 1000000 10000000)
+// Sizes up to 1e9 work given about 12 bytes of RAM per element.
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "SequenceHeapPQ.h"
+#include "bench/benchUtil.h"
+
+
+// Minimal 4-ary max-heap with hole-based sifts, as a second array heap to
+// compare against.
+template<typename TYPE>
+class QuaternaryHeap {
+public:
+    void push(const TYPE &val) {
+        data.push_back(val);
+        size_t index = data.size() - 1;
+        while(index > 0 && data[(index - 1)/4] < val) {
+            data[index] = data[(index - 1)/4];
+            index = (index - 1)/4;
+        }
+        data[index] = val;
+    }
+
+    void pop() {
+        TYPE val = data.back();
+        data.pop_back();
+        if(data.empty()) return;
+        size_t index = 0;
+        for(;;) {
+            size_t first = 4*index + 1;
+            if(first >= data.size()) break;
+            size_t last = std::min(first + 4, data.size());
+            size_t best = first;
+            for(size_t child = first + 1; child < last; ++child) {
+                if(data[best] < data[child]) best = child;
+            }
+            if(!(val < data[best])) break;
+            data[index] = data[best];
+            index = best;
+        }
+        data[index] = val;
+    }
+
+    const TYPE &top() const { return data.front(); }
+    bool empty() const { return data.empty(); }
+
+private:
+    std::vector<TYPE> data;
+}; // QuaternaryHeap
+
+
+template<typename PQ>
+void run(const char *name, size_t n) {
+    BenchRng rng;
+    PQ pq;
+
+    Stopwatch timer;
+    for(size_t i = 0; i < n; ++i) pq.push(rng.next() >> 1);
+    double pushNs = timer.elapsedNs();
+
+    timer.reset();
+    for(size_t i = 0; i < n; ++i) {
+        unsigned long long value = pq.top();
+        pq.pop();
+        pq.push(value - std::min<unsigned long long>(value, rng.next() >> 40));
+    }
+    double steadyNs = timer.elapsedNs();
+
+    timer.reset();
+    while(!pq.empty()) {
+        doNotOptimize(pq.top());
+        pq.pop();
+    }
+    double popNs = timer.elapsedNs();
+
+    double count = static_cast<double>(n);
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed
+              << std::setprecision(1)
+              << std::setw(10) << pushNs / count << " ns/push"
+              << std::setw(10) << popNs / count << " ns/pop"
+              << std::setw(10) << steadyNs / count << " ns/hold" << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::vector<size_t> sizes;
+    for(int i = 1; i < argc; ++i) sizes.push_back(argOr(argc, argv, i, 0));
+    if(sizes.empty()) sizes = { 1000000, 10000000 };
+
+    for(size_t n : sizes) {
+        std::cout << "n = " << n << std::endl;
+        run<BinaryPQ<unsigned long long>>("BinaryPQ", n);
+        run<QuaternaryHeap<unsigned long long>>("4-ary heap", n);
+        run<SequenceHeapPQ<unsigned long long>>("SequenceHeapPQ", n);
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// A multi-process pipeline two ways: producer processes write keys into one
+// pipe and the consumer pushes what it reads into its own BinaryPQ, against
+// producers pushing straight into a SharedMemoryPQ the consumer pops from.
+// In both, the consumer pops one key for every key it receives, so the
+// clock measures moving 'items' keys through the queue end to end, from
+// forking the producers to the last pop.
+//
+// Pipe writes are batches of 64 keys (512 bytes, under PIPE_BUF so batches
+// from different producers never interleave), which is how a pipe-fed
+// consumer would amortize its system calls. The shared PQ, at the default
+// capacity, is run both with one key per push() and waitPop(), and with the
+// same batches through pushRange() and waitPop_k().
+//
+// Usage: bench/benchSharedMemory [items] [max producers]
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BinaryPQ.h"
+#include "SharedMemoryPQ.h"
+#include "bench/benchUtil.h"
+
+
+static const std::size_t BATCH = 64;
+
+
+// Forks 'producers' children, each running produce(p, count) for its share
+// of 'items'.
+template<typename F>
+std::vector<pid_t> forkProducers(std::size_t items, std::size_t producers, F produce) {
+    std::vector<pid_t> pids;
+    for(std::size_t p = 0; p < producers; ++p) {
+        std::size_t count = items/producers + (p < items % producers ? 1 : 0);
+        pid_t pid = fork();
+        if(pid == 0) {
+            produce(p, count);
+            _exit(0);
+        }
+        pids.push_back(pid);
+    }
+    return pids;
+}
+
+
+void reap(const std::vector<pid_t> &pids) {
+    for(pid_t pid : pids) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+}
+
+
+double viaPipe(std::size_t items, std::size_t producers) {
+    Stopwatch clock;
+    int fds[2];
+    if(pipe(fds) != 0) return 0;
+    std::vector<pid_t> pids = forkProducers(items, producers, [&](std::size_t p, std::size_t count) {
+        close(fds[0]);
+        BenchRng rng{ 0x9E3779B97F4A7C15ULL + p };
+        std::uint64_t batch[BATCH];
+        while(count > 0) {
+            std::size_t n = count < BATCH ? count : BATCH;
+            for(std::size_t i = 0; i < n; ++i) batch[i] = rng.next();
+            if(write(fds[1], batch, n * sizeof(std::uint64_t)) < 0) _exit(1);
+            count -= n;
+        }
+    });
+    close(fds[1]);
+
+    BinaryPQ<std::uint64_t> pq;
+    std::vector<unsigned char> buffer(BATCH * sizeof(std::uint64_t) * 8);
+    std::size_t held = 0;
+    std::size_t popped = 0;
+    while(popped < items) {
+        ssize_t got = read(fds[0], buffer.data() + held, buffer.size() - held);
+        if(got <= 0) break;
+        held += static_cast<std::size_t>(got);
+        std::size_t keys = held / sizeof(std::uint64_t);
+        for(std::size_t i = 0; i < keys; ++i) {
+            std::uint64_t key;
+            std::memcpy(&key, buffer.data() + i * sizeof(key), sizeof(key));
+            pq.push(key);
+        }
+        for(std::size_t i = 0; i < keys; ++i) {
+            doNotOptimize(pq.top());
+            pq.pop();
+        }
+        popped += keys;
+        // keep a key split across two reads
+        std::memmove(buffer.data(), buffer.data() + keys * sizeof(std::uint64_t),
+                     held - keys * sizeof(std::uint64_t));
+        held -= keys * sizeof(std::uint64_t);
+    }
+    close(fds[0]);
+    reap(pids);
+    return clock.elapsedNs();
+}
+
+
+double viaSharedMemory(std::size_t items, std::size_t producers, std::size_t batch) {
+    Stopwatch clock;
+    SharedMemoryPQ<std::uint64_t> pq;
+    std::vector<pid_t> pids = forkProducers(items, producers, [&](std::size_t p, std::size_t count) {
+        BenchRng rng{ 0x9E3779B97F4A7C15ULL + p };
+        std::vector<std::uint64_t> keys(batch);
+        while(count > 0) {
+            std::size_t n = count < batch ? count : batch;
+            if(n == 1) {
+                pq.push(rng.next());
+            }
+            else {
+                for(std::size_t i = 0; i < n; ++i) keys[i] = rng.next();
+                pq.pushRange(keys.begin(), keys.begin() + static_cast<std::ptrdiff_t>(n));
+            }
+            count -= n;
+        }
+    });
+
+    std::vector<std::uint64_t> keys(batch);
+    std::size_t popped = 0;
+    while(popped < items) {
+        std::size_t got = static_cast<std::size_t>(pq.waitPop_k(batch, keys.begin()) - keys.begin());
+        if(got == 0) break;
+        doNotOptimize(keys[got - 1]);
+        popped += got;
+    }
+    reap(pids);
+    return clock.elapsedNs();
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t items = argOr(argc, argv, 1, 2000000);
+    std::size_t maxProducers = argOr(argc, argv, 2, 4);
+    std::cout << "items = " << items << ", ns per item end to end" << std::endl;
+    for(std::size_t producers = 1; producers <= maxProducers; producers *= 2) {
+        std::cout << "  " << producers << " producer(s)" << std::endl;
+        std::cout << "    pipe + BinaryPQ                : " << viaPipe(items, producers) / static_cast<double>(items)
+                  << std::endl;
+        std::cout << "    SharedMemoryPQ, 1 key per call  : "
+                  << viaSharedMemory(items, producers, 1) / static_cast<double>(items) << std::endl;
+        std::cout << "    SharedMemoryPQ, " << BATCH << " keys per call : "
+                  << viaSharedMemory(items, producers, BATCH) / static_cast<double>(items) << std::endl;
+    }
+    return 0;
+}
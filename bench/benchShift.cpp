@@ -0,0 +1,96 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// An aging scheduler: n tasks are queued, each round runs (pops) the most
+// urgent one and queues a fresh task in its place, and every 'period' rounds
+// every queued task's priority is raised by one. Aging is done two ways:
+// adding one to each key through pointers and calling updatePriorities(),
+// against shift_all() on ShiftablePQ and ShiftPairingPQ, which is O(1).
+//
+// All variants see the same fresh keys and must pop the same keys, checked
+// through a checksum of what was popped.
+//
+// Usage: bench/benchShift [n] [rounds] [period]
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "PairingPQ.h"
+#include "ShiftPairingPQ.h"
+#include "ShiftablePQ.h"
+#include "bench/benchUtil.h"
+
+
+struct KeyPtrComp {
+    bool operator()(const std::int64_t *a, const std::int64_t *b) const { return *a < *b; }
+};
+
+
+// Keys live in 'slots'; a popped task's slot is reused for the next one.
+template<template<typename...> typename PQ>
+void viaUpdatePriorities(const char *name, std::size_t n, std::size_t rounds, std::size_t period,
+                         const std::vector<std::int64_t> &fresh) {
+    std::vector<std::int64_t> slots(fresh.begin(), fresh.begin() + static_cast<std::ptrdiff_t>(n));
+    PQ<std::int64_t*, KeyPtrComp> pq;
+    for(std::int64_t &slot : slots) pq.push(&slot);
+    std::int64_t checksum = 0;
+    Stopwatch clock;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        std::int64_t *task = pq.top();
+        pq.pop();
+        checksum += *task;
+        *task = fresh[n + round];
+        pq.push(task);
+        if((round + 1) % period == 0) {
+            for(std::int64_t &slot : slots) slot++;
+            pq.updatePriorities();
+        }
+    }
+    double elapsed = clock.elapsedNs();
+    std::cout << "  " << name << elapsed / static_cast<double>(rounds) << " ns/round  (checksum "
+              << checksum << ")" << std::endl;
+}
+
+
+template<typename PQ>
+void viaShiftAll(const char *name, std::size_t n, std::size_t rounds, std::size_t period,
+                 const std::vector<std::int64_t> &fresh) {
+    PQ pq;
+    for(std::size_t i = 0; i < n; ++i) pq.push(fresh[i]);
+    std::int64_t checksum = 0;
+    Stopwatch clock;
+    for(std::size_t round = 0; round < rounds; ++round) {
+        checksum += pq.top();
+        pq.pop();
+        pq.push(fresh[n + round]);
+        if((round + 1) % period == 0) {
+            pq.shift_all(1);
+        }
+    }
+    double elapsed = clock.elapsedNs();
+    std::cout << "  " << name << elapsed / static_cast<double>(rounds) << " ns/round  (checksum "
+              << checksum << ")" << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 100000);
+    std::size_t rounds = argOr(argc, argv, 2, 100000);
+    std::size_t period = argOr(argc, argv, 3, 100);
+    std::vector<std::int64_t> fresh(n + rounds);
+    BenchRng rng;
+    for(std::int64_t &key : fresh) key = static_cast<std::int64_t>(rng.below(1000000));
+
+    std::cout << "n = " << n << ", rounds = " << rounds << ", aging every " << period << " rounds"
+              << std::endl;
+    viaUpdatePriorities<BinaryPQ>("BinaryPQ, ++ each + updatePriorities()  : ", n, rounds, period, fresh);
+    viaUpdatePriorities<PairingPQ>("PairingPQ, ++ each + updatePriorities() : ", n, rounds, period, fresh);
+    viaShiftAll<ShiftablePQ<BinaryPQ, std::int64_t>>("ShiftablePQ<BinaryPQ>, shift_all()     : ",
+                                                     n, rounds, period, fresh);
+    viaShiftAll<ShiftablePQ<PairingPQ, std::int64_t>>("ShiftablePQ<PairingPQ>, shift_all()    : ",
+                                                      n, rounds, period, fresh);
+    viaShiftAll<ShiftPairingPQ<std::int64_t>>("ShiftPairingPQ, shift_all()            : ",
+                                              n, rounds, period, fresh);
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Throughput of SoftHeapPQ at several error rates against the exact
+// BinaryPQ and PairingPQ, and how far out of order the soft heap's pops
+// really are.
+//
+// The keys are a shuffled permutation of 0..n-1. Each PQ is timed pushing
+// all n (build), then n rounds of a pop followed by a push of a fresh key
+// (hold), then popping everything (drain). A separate untimed run of the
+// soft heap's drain measures the rank error of each pop: the number of keys
+// still held that are larger than the one popped, found with a Fenwick tree,
+// so an exact PQ scores 0 on every pop. Also reported: corrupted() after the
+// build and corruptedPops() over the drain.
+//
+// Usage: bench/benchSoftHeap [n]
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "PairingPQ.h"
+#include "SoftHeapPQ.h"
+#include "bench/benchUtil.h"
+
+
+// Counts how many of the keys 0..n-1 are present and larger than a key.
+class Fenwick {
+public:
+    explicit Fenwick(std::size_t n) : tree(n + 1, 0) {}
+
+    void add(std::size_t key, int delta) {
+        for(std::size_t i = key + 1; i < tree.size(); i += i & (~i + 1)) tree[i] += delta;
+    }
+
+    // Present keys <= key.
+    std::size_t atMost(std::size_t key) const {
+        long long sum = 0;
+        for(std::size_t i = key + 1; i > 0; i -= i & (~i + 1)) sum += tree[i];
+        return static_cast<std::size_t>(sum);
+    }
+
+private:
+    std::vector<int> tree;
+};
+
+
+template<typename PQ>
+void throughput(const char *name, PQ pq, const std::vector<std::uint32_t> &keys) {
+    std::size_t n = keys.size() / 2;
+    Stopwatch clock;
+    for(std::size_t i = 0; i < n; ++i) pq.push(keys[i]);
+    double build = clock.elapsedNs();
+    clock.reset();
+    for(std::size_t i = n; i < keys.size(); ++i) {
+        doNotOptimize(pq.top());
+        pq.pop();
+        pq.push(keys[i]);
+    }
+    double hold = clock.elapsedNs();
+    clock.reset();
+    while(!pq.empty()) {
+        doNotOptimize(pq.top());
+        pq.pop();
+    }
+    double drain = clock.elapsedNs();
+    double per = static_cast<double>(n);
+    std::cout << "  " << name << "  build " << build / per << "  hold " << hold / per
+              << "  drain " << drain / per << "  ns/op" << std::endl;
+}
+
+
+void rankError(double epsilon, const std::vector<std::uint32_t> &keys) {
+    std::size_t n = keys.size() / 2;
+    SoftHeapPQ<std::uint32_t> pq{ epsilon };
+    Fenwick present(keys.size());
+    for(std::size_t i = 0; i < n; ++i) {
+        pq.push(keys[i]);
+        present.add(keys[i], 1);
+    }
+    std::size_t corruptedAfterBuild = pq.corrupted();
+
+    std::size_t held = n;
+    std::size_t outOfOrder = 0;
+    std::size_t worst = 0;
+    double total = 0;
+    while(!pq.empty()) {
+        std::uint32_t key = pq.top();
+        pq.pop();
+        std::size_t larger = held - present.atMost(key);
+        present.add(key, -1);
+        held--;
+        if(larger > 0) outOfOrder++;
+        worst = std::max(worst, larger);
+        total += static_cast<double>(larger);
+    }
+    double per = static_cast<double>(n);
+    std::cout << "  epsilon " << epsilon << ": corrupted after build " << corruptedAfterBuild
+              << " (" << 100.0 * static_cast<double>(corruptedAfterBuild) / per << "%), corrupted pops "
+              << pq.corruptedPops() << ", out-of-order pops " << 100.0 * static_cast<double>(outOfOrder) / per
+              << "%, rank error mean " << total / per << " max " << worst << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 1000000);
+    // the first n keys are built, the rest pushed during the hold phase
+    std::vector<std::uint32_t> keys(2*n);
+    for(std::size_t i = 0; i < keys.size(); ++i) keys[i] = static_cast<std::uint32_t>(i);
+    BenchRng rng;
+    for(std::size_t i = keys.size(); i > 1; --i) std::swap(keys[i - 1], keys[rng.below(i)]);
+
+    const double epsilons[] = { 0.01, 0.1, 0.25, 0.5 };
+    std::cout << "n = " << n << std::endl;
+    throughput("BinaryPQ          ", BinaryPQ<std::uint32_t>{}, keys);
+    throughput("PairingPQ         ", PairingPQ<std::uint32_t>{}, keys);
+    for(double epsilon : epsilons) {
+        std::cout << "  SoftHeapPQ e=" << epsilon << "\t";
+        throughput("", SoftHeapPQ<std::uint32_t>{ epsilon }, keys);
+    }
+    std::cout << "rank error of the soft heap's drain (keys still held larger than the one popped)"
+              << std::endl;
+    for(double epsilon : epsilons) {
+        rankError(epsilon, keys);
+    }
+    return 0;
+}
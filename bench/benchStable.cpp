@@ -0,0 +1,100 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Overhead of StablePQ against the unstable PQ it wraps, and against the
+// hand-written wrapper it replaces (the element plus a 64-bit counter and a
+// comparator that breaks ties on it). Elements are 8-byte records ordered by
+// a small priority, so most comparisons tie. Reports ns per push + pop over
+// a hold workload and the bytes stored per element.
+//
+// Usage: bench/benchStable [n] [priorities]
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BinaryPQ.h"
+#include "PairingPQ.h"
+#include "SequenceHeapPQ.h"
+#include "StablePQ.h"
+#include "bench/benchUtil.h"
+
+
+struct Record {
+    int priority;
+    int id;
+};
+
+struct RecordComp {
+    bool operator()(const Record &a, const Record &b) const {
+        return a.priority < b.priority;
+    }
+};
+
+struct Wrapped {
+    Record record;
+    std::uint64_t sequence;
+};
+
+struct WrappedComp {
+    bool operator()(const Wrapped &a, const Wrapped &b) const {
+        if(a.record.priority != b.record.priority) return a.record.priority < b.record.priority;
+        return a.sequence > b.sequence;
+    }
+};
+
+
+// Fills the PQ with n records, then does n pop + push pairs.
+template<typename PQ, typename MAKE>
+double hold(const std::vector<int> &priorities, MAKE make) {
+    PQ pq;
+    std::size_t n = priorities.size() / 2;
+    for(std::size_t i = 0; i < n; ++i) {
+        pq.push(make(priorities[i], i));
+    }
+    Stopwatch timer;
+    for(std::size_t i = n; i < priorities.size(); ++i) {
+        doNotOptimize(pq.top());
+        pq.pop();
+        pq.push(make(priorities[i], i));
+    }
+    return timer.elapsedNs() / static_cast<double>(priorities.size() - n);
+}
+
+
+template<template<typename...> typename PQ>
+void run(const char *name, const std::vector<int> &priorities) {
+    std::uint64_t sequence = 0;
+    auto record = [](int p, std::size_t i) { return Record{ p, static_cast<int>(i) }; };
+    auto wrapped = [&sequence](int p, std::size_t i) {
+        return Wrapped{ Record{ p, static_cast<int>(i) }, sequence++ };
+    };
+
+    double unstable = hold<PQ<Record, RecordComp>>(priorities, record);
+    double handWrapped = hold<PQ<Wrapped, WrappedComp>>(priorities, wrapped);
+    double stable = hold<StablePQ<PQ, Record, RecordComp>>(priorities, record);
+    double ints = hold<PQ<int>>(priorities, [](int p, std::size_t) { return p; });
+    double stableInts = hold<StablePQ<PQ, int>>(priorities, [](int p, std::size_t) { return p; });
+
+    std::cout << "  " << name << ": unstable " << unstable << " ns, hand-wrapped "
+              << handWrapped << " ns, StablePQ " << stable << " ns; int "
+              << ints << " ns, StablePQ<int> " << stableInts << " ns" << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::size_t n = argOr(argc, argv, 1, 1000000);
+    std::size_t range = argOr(argc, argv, 2, 16);
+    BenchRng rng;
+    std::vector<int> priorities(2 * n);
+    for(int &p : priorities) p = static_cast<int>(rng.below(range));
+
+    std::cout << "n = " << n << ", " << range << " priorities; bytes per element: "
+              << "unstable " << sizeof(Record) << ", hand-wrapped " << sizeof(Wrapped)
+              << ", StablePQ " << sizeof(StablePQ<BinaryPQ, Record, RecordComp>::Stored)
+              << std::endl;
+    run<BinaryPQ>("Binary", priorities);
+    run<PairingPQ>("Pairing", priorities);
+    run<SequenceHeapPQ>("SequenceHeap", priorities);
+    return 0;
+}
@@ -0,0 +1,82 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+// Small helpers shared by the benchmark drivers in this directory. The
+// drivers are built with "make allbench" (or "make bench/<name>") and are
+// never part of a submission.
+
+// Wall-clock timer, started on construction.
+class Stopwatch {
+public:
+    Stopwatch() : start{ std::chrono::steady_clock::now() } {}
+
+    void reset() { start = std::chrono::steady_clock::now(); }
+
+    // Nanoseconds since construction or the last reset().
+    double elapsedNs() const {
+        return std::chrono::duration<double, std::nano>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+}; // Stopwatch
+
+
+// Returns argv[idx] parsed as a number, or dflt if it was not given.
+inline std::size_t argOr(int argc, char *argv[], int idx, std::size_t dflt) {
+    if(idx >= argc) return dflt;
+    return static_cast<std::size_t>(std::strtoull(argv[idx], nullptr, 10));
+}
+
+
+// Deterministic xorshift generator so every run sees the same inputs.
+class BenchRng {
+public:
+    explicit BenchRng(unsigned long long seed = 0x9E3779B97F4A7C15ULL) : state{ seed } {}
+
+    unsigned long long next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    // Uniform-ish value in [0, bound).
+    std::size_t below(std::size_t bound) {
+        return static_cast<std::size_t>(next() % bound);
+    }
+
+private:
+    unsigned long long state;
+}; // BenchRng
+
+
+// Wraps a comparator and counts every call into a shared counter, so the
+// count survives the copies the PQs make of their functor.
+template<typename COMP_FUNCTOR>
+struct CountingComp {
+    static inline std::size_t calls = 0;
+
+    template<typename T>
+    bool operator()(const T &a, const T &b) const {
+        ++calls;
+        return COMP_FUNCTOR{}(a, b);
+    }
+}; // CountingComp
+
+
+// Keeps the optimizer from discarding a computed value.
+template<typename T>
+inline void doNotOptimize(const T &val) {
+    asm volatile("" : : "g"(&val) : "memory");
+}
+
+#endif // BENCHUTIL_H
@@ -0,0 +1,379 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef GRAPHLOAD_H
+#define GRAPHLOAD_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bench/benchUtil.h"
+
+// Graphs for the graph-search benchmarks: compressed adjacency lists, read
+// from DIMACS shortest-path files or plain edge lists, or generated.
+//
+// Files are mapped read-only and parsed in place by a hand-written scanner,
+// without iostreams or a copy of the text. Malformed input throws
+// std::runtime_error naming the line; a file that can't be opened or mapped
+// throws std::system_error.
+
+
+// Compressed adjacency lists; the arcs out of v are offsets[v] up to
+// offsets[v + 1]. Vertices with coordinates have one (x, y) pair each.
+struct Graph {
+    std::vector<std::uint64_t> offsets;
+    std::vector<std::uint32_t> targets;
+    std::vector<std::uint32_t> weights;
+    std::vector<std::pair<double, double>> coords;
+
+    std::size_t vertices() const { return offsets.size() - 1; }
+    std::size_t arcs() const { return targets.size(); }
+}; // Graph
+
+
+// An arc before the adjacency lists are built.
+struct Arc {
+    std::uint32_t from;
+    std::uint32_t to;
+    std::uint32_t weight;
+};
+
+
+// Builds the adjacency lists of 'vertices' vertices out of 'arcs', adding
+// the reverse of each arc as well when 'symmetric' is set.
+inline Graph buildGraph(std::size_t vertices, const std::vector<Arc> &arcs, bool symmetric) {
+    Graph graph;
+    graph.offsets.assign(vertices + 1, 0);
+    for(const Arc &arc : arcs) {
+        graph.offsets[arc.from + 1]++;
+        if(symmetric) graph.offsets[arc.to + 1]++;
+    }
+    for(std::size_t v = 0; v < vertices; ++v) {
+        graph.offsets[v + 1] += graph.offsets[v];
+    }
+    graph.targets.resize(graph.offsets[vertices]);
+    graph.weights.resize(graph.offsets[vertices]);
+    std::vector<std::uint64_t> next(graph.offsets.begin(), graph.offsets.end() - 1);
+    auto place = [&graph, &next](std::uint32_t from, std::uint32_t to, std::uint32_t weight) {
+        std::uint64_t slot = next[from]++;
+        graph.targets[slot] = to;
+        graph.weights[slot] = weight;
+    };
+    for(const Arc &arc : arcs) {
+        place(arc.from, arc.to, arc.weight);
+        if(symmetric) place(arc.to, arc.from, arc.weight);
+    }
+    return graph;
+}
+
+
+// A file mapped read-only for as long as this lives.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path) : data{ nullptr }, length{ 0 } {
+        int fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        struct stat info;
+        if(fstat(fd, &info) != 0) {
+            int err = errno;
+            close(fd);
+            throw std::system_error(err, std::generic_category(), "fstat " + path);
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if(length > 0) {
+            void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(mapped == MAP_FAILED) {
+                int err = errno;
+                close(fd);
+                throw std::system_error(err, std::generic_category(), "mmap " + path);
+            }
+            madvise(mapped, length, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapped);
+        }
+        close(fd);
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+        if(data != nullptr) munmap(const_cast<char*>(data), length);
+    }
+
+    const char *begin() const { return data; }
+    const char *end() const { return data + length; }
+
+private:
+    const char *data;
+    std::size_t length;
+}; // MappedFile
+
+
+// Reads whitespace-separated fields a line at a time out of [pos, end).
+class LineScanner {
+public:
+    LineScanner(const char *begin, const char *end, std::string name) :
+        pos{ begin }, end{ end }, line{ 1 }, name{ std::move(name) } {}
+
+    bool atEnd() const { return pos == end; }
+
+    // The first character of the line, after leading blanks, or '\n' for a
+    // blank line.
+    char peek() {
+        skipBlanks();
+        return pos == end ? '\n' : *pos;
+    }
+
+    void skipLine() {
+        while(pos != end && *pos != '\n') ++pos;
+        if(pos != end) {
+            ++pos;
+            ++line;
+        }
+    }
+
+    bool atLineEnd() {
+        skipBlanks();
+        return pos == end || *pos == '\n' || *pos == '\r';
+    }
+
+    void skipWord() {
+        skipBlanks();
+        while(pos != end && !isBlank(*pos) && *pos != '\n') ++pos;
+    }
+
+    std::uint64_t readUnsigned() {
+        skipBlanks();
+        if(pos == end || *pos < '0' || *pos > '9') fail("expected a number");
+        std::uint64_t value = 0;
+        while(pos != end && *pos >= '0' && *pos <= '9') {
+            value = value * 10 + static_cast<std::uint64_t>(*pos++ - '0');
+        }
+        return value;
+    }
+
+    double readNumber() {
+        skipBlanks();
+        bool negative = pos != end && *pos == '-';
+        if(negative || (pos != end && *pos == '+')) ++pos;
+        double value = static_cast<double>(readUnsigned());
+        if(pos != end && *pos == '.') {
+            ++pos;
+            for(double scale = 0.1; pos != end && *pos >= '0' && *pos <= '9'; scale /= 10) {
+                value += scale * (*pos++ - '0');
+            }
+        }
+        return negative ? -value : value;
+    }
+
+    [[noreturn]] void fail(const char *what) const {
+        throw std::runtime_error(name + ":" + std::to_string(line) + ": " + what);
+    }
+
+private:
+    static bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    void skipBlanks() {
+        while(pos != end && isBlank(*pos)) ++pos;
+    }
+
+    const char *pos;
+    const char *end;
+    std::size_t line;
+    std::string name;
+}; // LineScanner
+
+
+inline std::uint32_t checkedVertex(LineScanner &in, std::uint64_t id, std::uint64_t vertices) {
+    if(id >= vertices) in.fail("vertex out of range");
+    return static_cast<std::uint32_t>(id);
+}
+
+inline std::uint32_t checkedWeight(LineScanner &in, std::uint64_t weight) {
+    if(weight > UINT32_MAX) in.fail("weight out of range");
+    return static_cast<std::uint32_t>(weight);
+}
+
+
+// Loads a DIMACS shortest-path file: a "p sp <vertices> <arcs>" line, then
+// "a <from> <to> <weight>" lines with vertices numbered from 1; lines
+// starting with 'c' are comments.
+inline Graph loadDimacs(const std::string &path) {
+    MappedFile file{ path };
+    LineScanner in{ file.begin(), file.end(), path };
+    std::uint64_t vertices = 0;
+    bool sized = false;
+    std::vector<Arc> arcs;
+    while(!in.atEnd()) {
+        char kind = in.peek();
+        if(kind == 'p') {
+            in.skipWord();
+            in.skipWord();
+            vertices = in.readUnsigned();
+            if(vertices >= UINT32_MAX) in.fail("too many vertices");
+            arcs.reserve(in.readUnsigned());
+            sized = true;
+        }
+        else if(kind == 'a') {
+            if(!sized) in.fail("arc before the problem line");
+            in.skipWord();
+            std::uint64_t from = in.readUnsigned();
+            std::uint64_t to = in.readUnsigned();
+            if(from == 0 || to == 0) in.fail("vertices are numbered from 1");
+            arcs.push_back(Arc{ checkedVertex(in, from - 1, vertices), checkedVertex(in, to - 1, vertices),
+                                checkedWeight(in, in.readUnsigned()) });
+        }
+        else if(kind != 'c' && kind != '\n') {
+            in.fail("expected a 'c', 'p' or 'a' line");
+        }
+        in.skipLine();
+    }
+    if(!sized) in.fail("no problem line");
+    return buildGraph(vertices, arcs, false);
+}
+
+
+// Loads DIMACS coordinates, "v <vertex> <x> <y>" lines with vertices
+// numbered from 1, into 'graph'.
+inline void loadDimacsCoords(const std::string &path, Graph &graph) {
+    MappedFile file{ path };
+    LineScanner in{ file.begin(), file.end(), path };
+    graph.coords.assign(graph.vertices(), { 0.0, 0.0 });
+    while(!in.atEnd()) {
+        char kind = in.peek();
+        if(kind == 'v') {
+            in.skipWord();
+            std::uint64_t id = in.readUnsigned();
+            if(id == 0) in.fail("vertices are numbered from 1");
+            std::uint32_t v = checkedVertex(in, id - 1, graph.vertices());
+            double x = in.readNumber();
+            graph.coords[v] = { x, in.readNumber() };
+        }
+        else if(kind != 'c' && kind != 'p' && kind != '\n') {
+            in.fail("expected a 'c', 'p' or 'v' line");
+        }
+        in.skipLine();
+    }
+}
+
+
+// Loads an edge list: "<from> <to> [weight]" lines with vertices numbered
+// from 0 and weight 1 if none is given; lines starting with '#' or '%' are
+// comments, as in SNAP and Matrix Market files.
+inline Graph loadEdgeList(const std::string &path) {
+    MappedFile file{ path };
+    LineScanner in{ file.begin(), file.end(), path };
+    std::uint64_t vertices = 0;
+    std::vector<Arc> arcs;
+    while(!in.atEnd()) {
+        char kind = in.peek();
+        if(kind != '#' && kind != '%' && kind != '\n') {
+            std::uint64_t from = in.readUnsigned();
+            std::uint64_t to = in.readUnsigned();
+            if(std::max(from, to) >= UINT32_MAX - 1) in.fail("vertex out of range");
+            std::uint32_t weight = in.atLineEnd() ? 1 : checkedWeight(in, in.readUnsigned());
+            arcs.push_back(Arc{ static_cast<std::uint32_t>(from), static_cast<std::uint32_t>(to), weight });
+            vertices = std::max(vertices, std::max(from, to) + 1);
+        }
+        in.skipLine();
+    }
+    return buildGraph(vertices, arcs, false);
+}
+
+
+// Loads 'path' as DIMACS if it ends in ".gr", otherwise as an edge list.
+inline Graph loadGraph(const std::string &path) {
+    bool dimacs = path.size() >= 3 && path.compare(path.size() - 3, 3, ".gr") == 0;
+    return dimacs ? loadDimacs(path) : loadEdgeList(path);
+}
+
+
+// The graph with every arc of 'graph' both ways, for spanning trees.
+inline Graph undirected(const Graph &graph) {
+    std::vector<Arc> arcs;
+    arcs.reserve(graph.arcs());
+    for(std::size_t v = 0; v < graph.vertices(); ++v) {
+        for(std::uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            arcs.push_back(Arc{ static_cast<std::uint32_t>(v), graph.targets[e], graph.weights[e] });
+        }
+    }
+    return buildGraph(graph.vertices(), arcs, true);
+}
+
+
+// A road-like side x side grid with coordinates: each vertex joined both
+// ways to its right and lower neighbours, as road networks list both
+// directions, by weights from 100 to 199 times
+// the unit spacing, so 100 times the straight-line distance never
+// overestimates a path.
+inline Graph gridGraph(std::size_t side, BenchRng &rng) {
+    std::vector<Arc> arcs;
+    auto id = [side](std::size_t row, std::size_t col) {
+        return static_cast<std::uint32_t>(row * side + col);
+    };
+    for(std::size_t row = 0; row < side; ++row) {
+        for(std::size_t col = 0; col < side; ++col) {
+            if(col + 1 < side) {
+                arcs.push_back(Arc{ id(row, col), id(row, col + 1), static_cast<std::uint32_t>(100 + rng.below(100)) });
+            }
+            if(row + 1 < side) {
+                arcs.push_back(Arc{ id(row, col), id(row + 1, col), static_cast<std::uint32_t>(100 + rng.below(100)) });
+            }
+        }
+    }
+    Graph graph = buildGraph(side * side, arcs, true);
+    graph.coords.reserve(side * side);
+    for(std::size_t row = 0; row < side; ++row) {
+        for(std::size_t col = 0; col < side; ++col) {
+            graph.coords.emplace_back(static_cast<double>(col), static_cast<double>(row));
+        }
+    }
+    return graph;
+}
+
+
+// 'vertices' vertices with 'degree' arcs out of each to random vertices,
+// weights 1 to 100000, no coordinates.
+inline Graph randomGraph(std::size_t vertices, std::size_t degree, BenchRng &rng) {
+    std::vector<Arc> arcs;
+    arcs.reserve(vertices * degree);
+    for(std::size_t v = 0; v < vertices; ++v) {
+        for(std::size_t e = 0; e < degree; ++e) {
+            arcs.push_back(Arc{ static_cast<std::uint32_t>(v), static_cast<std::uint32_t>(rng.below(vertices)),
+                                static_cast<std::uint32_t>(1 + rng.below(100000)) });
+        }
+    }
+    return buildGraph(vertices, arcs, false);
+}
+
+
+// The largest factor by which straight-line distance can be scaled and
+// still never exceed an arc's weight, so that it is an admissible and
+// consistent A* heuristic; 0 without coordinates.
+inline double heuristicScale(const Graph &graph) {
+    if(graph.coords.empty()) return 0;
+    double scale = HUGE_VAL;
+    for(std::size_t v = 0; v < graph.vertices(); ++v) {
+        for(std::uint64_t e = graph.offsets[v]; e < graph.offsets[v + 1]; ++e) {
+            const auto &a = graph.coords[v];
+            const auto &b = graph.coords[graph.targets[e]];
+            double length = std::hypot(a.first - b.first, a.second - b.second);
+            if(length > 0) scale = std::min(scale, graph.weights[e] / length);
+        }
+    }
+    return scale == HUGE_VAL ? 0 : scale;
+}
+
+#endif // GRAPHLOAD_H
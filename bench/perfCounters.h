@@ -0,0 +1,213 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "bench/benchUtil.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware event counters for the benchmark drivers, read through Linux's
+// perf_event_open(2). Each counter covers user-space code of the calling
+// thread only, and is opened on its own, so a CPU or VM that lacks one
+// event still reports the others. Counters that cannot be opened at all
+// (no PMU in a VM, perf_event_paranoid too strict, not Linux) read as
+// unavailable and are left out of reports; timing always works.
+//
+// When the kernel time-multiplexes more events than the PMU has registers,
+// the counts are scaled by enabled/running time as perf stat does.
+class PerfCounters {
+public:
+    enum Event { Cycles, Instructions, L1dMisses, LlcMisses, DtlbMisses, BranchMisses, EVENTS };
+
+    PerfCounters() {
+        for(int e = 0; e < EVENTS; ++e) {
+            fds[e] = open(static_cast<Event>(e));
+            totals[e] = 0;
+        }
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for(int fd : fds) {
+            if(fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    static const char *name(Event e) {
+        static const char *const names[EVENTS] = {
+            "cycles", "instructions", "L1d-misses", "LLC-misses", "dTLB-misses", "branch-misses"
+        };
+        return names[e];
+    }
+
+    bool available(Event e) const { return fds[e] >= 0; }
+
+    bool anyAvailable() const {
+        for(int fd : fds) {
+            if(fd >= 0) return true;
+        }
+        return false;
+    }
+
+    // Zeroes and starts every available counter.
+    void start() {
+#ifdef __linux__
+        for(int fd : fds) {
+            if(fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Stops the counters and records their values since start().
+    void stop() {
+#ifdef __linux__
+        for(int fd : fds) {
+            if(fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+        for(int e = 0; e < EVENTS; ++e) {
+            totals[e] = 0;
+            if(fds[e] < 0) continue;
+            std::uint64_t values[3] = { 0, 0, 0 };
+            if(read(fds[e], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))) continue;
+            // value, time enabled, time running
+            double count = static_cast<double>(values[0]);
+            if(values[2] != 0 && values[2] < values[1]) {
+                count *= static_cast<double>(values[1]) / static_cast<double>(values[2]);
+            }
+            totals[e] = count;
+        }
+#endif
+    }
+
+    // The count of the last start()/stop() region.
+    double count(Event e) const { return totals[e]; }
+
+    // One line per region: ns/op, then each available counter per op.
+    std::string perOp(double ns, double ops) const {
+        std::ostringstream line;
+        line << ns / ops << " ns/op";
+        for(int e = 0; e < EVENTS; ++e) {
+            if(fds[e] >= 0) {
+                line << ", " << totals[e] / ops << " " << name(static_cast<Event>(e));
+            }
+        }
+        if(available(Cycles) && available(Instructions) && totals[Cycles] > 0) {
+            line << ", IPC " << totals[Instructions] / totals[Cycles];
+        }
+        return line.str();
+    }
+
+    // Says which counters could not be opened, if any.
+    void describe(std::ostream &out) const {
+        std::string missing;
+        for(int e = 0; e < EVENTS; ++e) {
+            if(fds[e] < 0) {
+                missing += missing.empty() ? "" : ", ";
+                missing += name(static_cast<Event>(e));
+            }
+        }
+        if(missing.empty()) {
+            out << "hardware counters: all available" << std::endl;
+        }
+        else if(!anyAvailable()) {
+            out << "hardware counters: unavailable (" << reason
+                << "), reporting time only" << std::endl;
+        }
+        else {
+            out << "hardware counters: not available for " << missing << std::endl;
+        }
+    }
+
+private:
+    int open(Event e) {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        auto cache = [](std::uint64_t which) {
+            return which | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                   | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        switch(e) {
+        case Cycles:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case Instructions:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case L1dMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_L1D);
+            break;
+        case LlcMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_LL);
+            break;
+        case DtlbMisses:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache(PERF_COUNT_HW_CACHE_DTLB);
+            break;
+        case BranchMisses:
+        default:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        }
+        long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if(fd < 0) {
+            reason = std::strerror(errno);
+            return -1;
+        }
+        return static_cast<int>(fd);
+#else
+        (void)e;
+        reason = "perf_event_open needs Linux";
+        return -1;
+#endif
+    }
+
+    int fds[EVENTS];
+    double totals[EVENTS];
+    std::string reason;
+}; // PerfCounters
+
+
+// Times 'body' and counts its hardware events, then prints a line with
+// everything per operation, e.g.
+//   measureRegion(counters, "  push", n, [&]() { ... });
+template<typename F>
+void measureRegion(PerfCounters &counters, const std::string &label, std::size_t ops, F &&body) {
+    counters.start();
+    Stopwatch timer;
+    body();
+    double ns = timer.elapsedNs();
+    counters.stop();
+    std::cout << label << ": " << counters.perOp(ns, static_cast<double>(ops)) << std::endl;
+}
+
+#endif // PERFCOUNTERS_H
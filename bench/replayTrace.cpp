@@ -0,0 +1,121 @@
+// Project identifier: 43DE0E0C4C76BFAA6D8C2F5AEAE0518A9C42CF4E
+
+// Replays an int trace written by RecordingPQ against every PQ in the tree,
+// reporting the time per operation and whether each PQ returned the same
+// top() values as the recording. The trace is decoded before any timing.
+//
+// Without a trace file, a synthetic hold-model workload (pushes, top/pop
+// pairs and an occasional updatePriorities, queue size around 'size') is
+// recorded to bench/sample.pqtr first, and the cost of recording is
+// reported against running the same workload on a bare BinaryPQ.
+//
+// Usage: bench/replayTrace [trace.pqtr]
+//        bench/replayTrace --record [operations] [size]
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AdaptivePQ.h"
+#include "BinaryPQ.h"
+#include "CompactPairingPQ.h"
+#include "PairingPQ.h"
+#include "RankPairingPQ.h"
+#include "RecordingPQ.h"
+#include "SequenceHeapPQ.h"
+#include "SortedPQ.h"
+#include "UnorderedFastPQ.h"
+#include "UnorderedPQ.h"
+#include "bench/benchUtil.h"
+
+
+// The workload recorded when no trace is given.
+void workload(Eecs281PQ<int> &pq, std::size_t operations, std::size_t size) {
+    BenchRng rng;
+    int now = 0;
+    for(std::size_t i = 0; i < size; ++i) {
+        pq.push(static_cast<int>(rng.below(1000000)));
+    }
+    for(std::size_t i = 0; i < operations; ++i) {
+        if(pq.empty() || rng.below(2 * size) > pq.size()) {
+            pq.push(now + static_cast<int>(rng.below(1000)));
+        }
+        else {
+            now = pq.top();
+            pq.pop();
+        }
+        if(i % 100000 == 99999) {
+            pq.updatePriorities();
+        }
+    }
+}
+
+
+template<typename PQ>
+void replay(const char *name, const std::vector<TraceEvent<int>> &events) {
+    bool handles = !std::is_void<decltype(handleType<int>(std::declval<PQ&>()))>::value;
+    if(traceNeedsHandles(events) && !handles) {
+        std::cout << "  " << name << ": skipped, trace uses updateElt" << std::endl;
+        return;
+    }
+    PQ pq;
+    Stopwatch timer;
+    std::size_t mismatches = replayTrace(events, pq);
+    double ns = timer.elapsedNs();
+    std::cout << "  " << name << ": " << ns / 1e6 << " ms, "
+              << ns / static_cast<double>(events.size()) << " ns/op, "
+              << (mismatches == 0 ? std::string("same results")
+                                  : std::to_string(mismatches) + " top() MISMATCHES")
+              << std::endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    std::string path = "bench/sample.pqtr";
+    if(argc > 1 && std::strcmp(argv[1], "--record") != 0) {
+        path = argv[1];
+    }
+    else {
+        std::size_t operations = argOr(argc, argv, 2, 2000000);
+        std::size_t size = argOr(argc, argv, 3, 1000);
+
+        BinaryPQ<int> bare;
+        Stopwatch timer;
+        workload(bare, operations, size);
+        double bareNs = timer.elapsedNs();
+
+        std::ofstream out(path, std::ios::binary);
+        timer.reset();
+        {
+            RecordingPQ<BinaryPQ, int> recording(out);
+            workload(recording, operations, size);
+        }
+        double recordNs = timer.elapsedNs();
+        std::cout << "recorded " << operations << " operations to " << path << ": "
+                  << recordNs / 1e6 << " ms with recording, " << bareNs / 1e6
+                  << " ms without" << std::endl;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if(!in) {
+        std::cerr << "cannot open " << path << std::endl;
+        return 1;
+    }
+    Stopwatch timer;
+    std::vector<TraceEvent<int>> events = readTrace<int>(in);
+    std::cout << path << ": " << events.size() << " operations, " << in.tellg()
+              << " bytes, decoded in " << timer.elapsedNs() / 1e6 << " ms" << std::endl;
+
+    replay<BinaryPQ<int>>("Binary", events);
+    replay<PairingPQ<int>>("Pairing", events);
+    replay<CompactPairingPQ<int>>("CompactPairing", events);
+    replay<RankPairingPQ<int>>("RankPairing", events);
+    replay<SequenceHeapPQ<int>>("SequenceHeap", events);
+    replay<AdaptivePQ<int>>("Adaptive", events);
+    replay<SortedPQ<int>>("Sorted", events);
+    replay<UnorderedFastPQ<int>>("UnorderedFast", events);
+    replay<UnorderedPQ<int>>("Unordered", events);
+    return 0;
+}
@@ -22,17 +22,49 @@
  * You do not have to submit this file, but it won't cause problems if you do.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cassert>
+#include <functional>
+#include <future>
+#include <iterator>
 #include <iostream>
+#include <memory_resource>
 #include <ostream>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <type_traits>
 #include <vector>
 
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "AdaptivePQ.h"
 #include "BinaryPQ.h"
+#include "BitmapPQ.h"
+#include "BoundedPairingPQ.h"
+#include "CompactPairingPQ.h"
 #include "Eecs281PQ.h"
+#include "IndexedBinaryPQ.h"
+#include "InlinePQ.h"
+#include "LoserTreeMerge.h"
 #include "PairingPQ.h"
+#include "PersistentPQ.h"
+#include "PriorityExecutor.h"
+#include "RankPairingPQ.h"
+#include "RecordingPQ.h"
+#include "SequenceHeapPQ.h"
+#include "SharedMemoryPQ.h"
+#include "ShiftPairingPQ.h"
+#include "ShiftablePQ.h"
+#include "SoftHeapPQ.h"
 #include "SortedPQ.h"
+#include "StablePQ.h"
+#include "UnorderedFastPQ.h"
 #include "UnorderedPQ.h"
 
 
@@ -42,6 +74,17 @@ enum class PQType {
     Sorted,
     Binary,
     Pairing,
+    RankPairing,
+    UnorderedFast,
+    Adaptive,
+    SequenceHeap,
+    CompactPairing,
+    IndexedBinary,
+    SharedMemory,
+    SoftHeap,
+    Persistent,
+    Bitmap,
+    BoundedPairing,
 };
 
 // These can be pretty-printed :)
@@ -55,6 +98,28 @@ std::ostream& operator<<(std::ostream& ost, PQType pqType) {
         return ost << "Binary";
     case PQType::Pairing:
         return ost << "Pairing";
+    case PQType::RankPairing:
+        return ost << "RankPairing";
+    case PQType::UnorderedFast:
+        return ost << "UnorderedFast";
+    case PQType::Adaptive:
+        return ost << "Adaptive";
+    case PQType::SequenceHeap:
+        return ost << "SequenceHeap";
+    case PQType::CompactPairing:
+        return ost << "CompactPairing";
+    case PQType::IndexedBinary:
+        return ost << "IndexedBinary";
+    case PQType::SharedMemory:
+        return ost << "SharedMemory";
+    case PQType::SoftHeap:
+        return ost << "SoftHeap";
+    case PQType::Persistent:
+        return ost << "Persistent";
+    case PQType::Bitmap:
+        return ost << "Bitmap";
+    case PQType::BoundedPairing:
+        return ost << "BoundedPairing";
     }
 
     return ost << "Unknown PQType";
@@ -67,6 +132,31 @@ struct IntPtrComp {
 };
 
 
+// A memory_resource that counts the allocations made through it and the
+//   bytes not yet given back.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t outstanding = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+
 // Test the primitive operations on a priority queue: constructor, push, pop, top, size, empty.
 template <template <typename...> typename PQ>
 void testPrimitiveOperations() {
@@ -97,6 +187,234 @@ void testPrimitiveOperations() {
 }
 
 
+// Push and pop a larger, deterministic mix of values and check that every
+// pop comes out in non-increasing order, including after interleaved pushes.
+template <template <typename...> typename PQ>
+void testPopOrder() {
+    std::cout << "Testing pop order with many elements..." << std::endl;
+
+    PQ<int> pq {};
+    Eecs281PQ<int>& eecsPQ = pq;
+
+    unsigned int state = 12345;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 1000);
+    };
+
+    for (int i = 0; i < 500; ++i) {
+        eecsPQ.push(nextValue());
+    }
+    int previous = eecsPQ.top();
+    for (int i = 0; i < 250; ++i) {
+        assert(eecsPQ.top() <= previous);
+        previous = eecsPQ.top();
+        eecsPQ.pop();
+    }
+
+    // New values may be larger than what was already popped.
+    for (int i = 0; i < 250; ++i) {
+        eecsPQ.push(nextValue());
+    }
+    previous = eecsPQ.top();
+    while (!eecsPQ.empty()) {
+        assert(eecsPQ.top() <= previous);
+        previous = eecsPQ.top();
+        eecsPQ.pop();
+    }
+    assert(eecsPQ.size() == 0);
+
+    std::cout << "testPopOrder succeeded!" << std::endl;
+}
+
+
+// Pop every size from 0 to 70 of arithmetic keys under the standard
+//   comparators, which BinaryPQ sifts without branches, and check the order
+//   against a sort. The sizes cover every shape of the last two levels.
+template <template <typename...> typename PQ, typename TYPE, typename COMP_FUNCTOR>
+void checkArithmeticOrder(std::vector<TYPE> const& values) {
+    for (size_t n = 0; n <= values.size(); ++n) {
+        std::vector<TYPE> expected(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(n));
+        std::sort(expected.begin(), expected.end(), [](TYPE const& a, TYPE const& b) {
+            return COMP_FUNCTOR {}(b, a);
+        });
+
+        PQ<TYPE, COMP_FUNCTOR> pushed {};
+        for (TYPE const& value : expected) {
+            pushed.push(value);
+        }
+        PQ<TYPE, COMP_FUNCTOR> ranged { values.begin(), values.begin() + static_cast<std::ptrdiff_t>(n) };
+        ranged.updatePriorities();
+        for (TYPE const& value : expected) {
+            assert(pushed.top() == value);
+            assert(ranged.top() == value);
+            pushed.pop();
+            ranged.pop();
+        }
+        assert(pushed.empty() && ranged.empty());
+    }
+}
+
+template <template <typename...> typename PQ>
+void testArithmeticKeys() {
+    std::cout << "Testing arithmetic keys with standard comparators..." << std::endl;
+
+    std::vector<double> doubles;
+    std::vector<unsigned> smalls;
+    unsigned int state = 2718;
+    for (int i = 0; i < 70; ++i) {
+        state = state * 1103515245u + 12345u;
+        doubles.push_back(static_cast<double>(state >> 8) / 3.0 - 1e6);
+        smalls.push_back((state >> 16) % 4);
+    }
+    checkArithmeticOrder<PQ, double, std::less<double>>(doubles);
+    checkArithmeticOrder<PQ, double, std::greater<double>>(doubles);
+    checkArithmeticOrder<PQ, unsigned, std::less<>>(smalls);
+    checkArithmeticOrder<PQ, unsigned, std::greater<>>(smalls);
+
+    std::cout << "testArithmeticKeys succeeded!" << std::endl;
+}
+
+// Test pop_k() and drain() against the same sequence of top()/pop() calls,
+//   including asking for more elements than the PQ holds and the generic
+//   fallback reached through an Eecs281PQ reference.
+template <template <typename...> typename PQ>
+void testPopK() {
+    std::cout << "Testing pop_k and drain..." << std::endl;
+
+    unsigned int state = 777;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 1000);
+    };
+
+    std::vector<int> values;
+    for (int i = 0; i < 700; ++i) {
+        values.push_back(nextValue());
+    }
+    PQ<int> pq { values.cbegin(), values.cend() };
+    PQ<int> reference { pq };
+
+    std::vector<int> popped;
+    pq.pop_k(100, std::back_inserter(popped));
+    assert(popped.size() == 100);
+    assert(pq.size() == 600);
+    for (int expected : popped) {
+        assert(reference.top() == expected);
+        reference.pop();
+    }
+
+    // Interleave pushes so batch pops see fresh elements.
+    for (int i = 0; i < 50; ++i) {
+        int value = nextValue();
+        pq.push(value);
+        reference.push(value);
+    }
+    assert(pq.top() == reference.top());
+
+    std::vector<int> rest(pq.size() + 5, -1);
+    auto end = pq.pop_k(pq.size() + 5, rest.begin());
+    assert(end == rest.begin() + 650);
+    assert(pq.empty());
+    for (auto it = rest.begin(); it != end; ++it) {
+        assert(reference.top() == *it);
+        reference.pop();
+    }
+    assert(reference.empty());
+    assert(pq.pop_k(3, rest.begin()) == rest.begin());
+
+    std::vector<int> drained;
+    PQ<int> full { values.cbegin(), values.cend() };
+    full.drain(std::back_inserter(drained));
+    assert(full.empty());
+    assert(drained.size() == values.size());
+    std::vector<int> sorted { values };
+    std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+    assert(drained == sorted);
+
+    // The base class fallback produces the same order.
+    PQ<int> viaBase { values.cbegin(), values.cend() };
+    Eecs281PQ<int>& eecsPQ = viaBase;
+    std::vector<int> generic;
+    eecsPQ.drain(std::back_inserter(generic));
+    assert(generic == sorted);
+    assert(eecsPQ.empty());
+
+    std::cout << "testPopK succeeded!" << std::endl;
+}
+
+
+// Test remove_if(): the count it returns, that the rest pop in order with
+//   pushes mixed in, that a copy made before is untouched, and predicates
+//   that match nothing or everything. The base class fallback must agree.
+template <template <typename...> typename PQ>
+void testRemoveIf() {
+    std::cout << "Testing remove_if..." << std::endl;
+
+    unsigned int state = 4242;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 1000);
+    };
+    auto isOdd = [](int value) { return value % 2 != 0; };
+
+    std::vector<int> values;
+    for (int i = 0; i < 2000; ++i) {
+        values.push_back(nextValue());
+    }
+    PQ<int> pq { values.cbegin(), values.cend() };
+    // Pop a few first so the pairing heaps have children to cut.
+    for (int i = 0; i < 10; ++i) {
+        pq.pop();
+    }
+    PQ<int> before { pq };
+    std::vector<int> expected;
+    PQ<int> { pq }.drain(std::back_inserter(expected));
+    const std::vector<int> original { expected };
+
+    size_t odd = static_cast<size_t>(std::count_if(expected.begin(), expected.end(), isOdd));
+    assert(pq.remove_if(isOdd) == odd);
+    assert(pq.size() == expected.size() - odd);
+    assert(pq.remove_if([](int) { return false; }) == 0);
+    expected.erase(std::remove_if(expected.begin(), expected.end(), isOdd), expected.end());
+    for (int i = 0; i < 300; ++i) {
+        int value = nextValue();
+        pq.push(value);
+        expected.push_back(value);
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+    std::vector<int> popped;
+    for (size_t i = 0; i < 100; ++i) {
+        popped.push_back(pq.top());
+        pq.pop();
+    }
+    assert(std::equal(popped.begin(), popped.end(), expected.begin()));
+
+    PQ<int> viaBase { pq };
+    size_t large = static_cast<size_t>(std::count_if(expected.begin() + 100, expected.end(),
+                                                     [](int value) { return value >= 500; }));
+    assert(pq.remove_if([](int value) { return value >= 500; }) == large);
+    Eecs281PQ<int>& eecsPQ = viaBase;
+    assert(eecsPQ.remove_if([](int value) { return value >= 500; }) == large);
+    std::vector<int> drained, generic;
+    pq.drain(std::back_inserter(drained));
+    viaBase.drain(std::back_inserter(generic));
+    assert(drained == generic);
+    assert(std::equal(drained.begin(), drained.end(), expected.end() - static_cast<std::ptrdiff_t>(drained.size())));
+
+    PQ<int> all { before };
+    std::vector<int> untouched;
+    before.drain(std::back_inserter(untouched));
+    assert(untouched == original);
+    assert(all.remove_if([](int) { return true; }) == original.size());
+    assert(all.empty());
+    all.push(7);
+    assert(all.top() == 7 && all.size() == 1);
+
+    std::cout << "testRemoveIf succeeded!" << std::endl;
+}
+
+
 // Test that the priority queue uses its comparator properly.
 // HiddenData can't be compared with operator<, so we use HiddenDataComp{} instead.
 template <template <typename...> typename PQ>
@@ -227,68 +545,2142 @@ void testPairing() {
 }
 
 
-// Run all tests for a particular PQ type.
+// Drive addNode() and updateElt() on a handle-based PQ with a deterministic
+//   mix of adds, priority increases and pops, checking each top() against a
+//   brute-force search of the live values.
 template <template <typename...> typename PQ>
-void testPriorityQueue() {
-    testPrimitiveOperations<PQ>();
-    testHiddenData<PQ>();
-    testUpdatePriorities<PQ>();
+void testUpdateEltMany() {
+    std::cout << "Testing many updateElt calls..." << std::endl;
+
+    using Node = typename PQ<int>::Node;
+    PQ<int> pq;
+    std::vector<Node*> handles;
+    std::vector<bool> live;
+
+    unsigned int state = 2024;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 1000);
+    };
+
+    for (int step = 0; step < 4000; ++step) {
+        int op = nextValue() % 4;
+        if (op < 2 || pq.empty()) {
+            handles.push_back(pq.addNode(nextValue()));
+            live.push_back(true);
+        }
+        else if (op == 2) {
+            size_t i = static_cast<size_t>(nextValue()) % handles.size();
+            if (live[i]) {
+                pq.updateElt(handles[i], handles[i]->getElt() + 1 + nextValue() % 200);
+            }
+        }
+        else {
+            int expected = -1;
+            for (size_t i = 0; i < handles.size(); ++i) {
+                if (live[i] && handles[i]->getElt() > expected) {
+                    expected = handles[i]->getElt();
+                }
+            }
+            assert(pq.top() == expected);
+            // Find which handle is about to be deleted by its address.
+            for (size_t i = 0; i < handles.size(); ++i) {
+                if (live[i] && &handles[i]->getElt() == &pq.top()) {
+                    live[i] = false;
+                }
+            }
+            pq.pop();
+        }
+    }
+
+    // Copies do not share nodes but must pop the same sequence.
+    PQ<int> copy { pq };
+    while (!pq.empty()) {
+        assert(copy.top() == pq.top());
+        copy.pop();
+        pq.pop();
+    }
+    assert(copy.empty());
+
+    std::cout << "testUpdateEltMany succeeded!" << std::endl;
 }
 
-// PairingPQ has some extra behavior we need to test in updateElement.
-// This template specialization handles that without changing the nice uniform
-//   interface of testPriorityQueue.
-template <>
-void testPriorityQueue<PairingPQ>() {
-    testPrimitiveOperations<PairingPQ>();
-    testHiddenData<PairingPQ>();
-    testUpdatePriorities<PairingPQ>();
-    testPairing();
+
+// The element behind a handle, for PQs whose handles are Node* and for
+//   those whose handles are looked up with getElt().
+template <typename PQ, typename Handle>
+const int& eltOf(PQ const& pq, Handle const& handle) {
+    if constexpr (std::is_pointer<Handle>::value) {
+        (void)pq;
+        return handle->getElt();
+    }
+    else {
+        return pq.getElt(handle);
+    }
 }
 
 
-int main() {
-    std::vector<PQType> const types {
-        PQType::Unordered,
-        PQType::Sorted,
-        PQType::Binary,
-        PQType::Pairing,
+// Drive erase() on a handle-based PQ: a deterministic mix of adds, priority
+//   increases, erasures of random live elements (including the top) and pops,
+//   checking each top() against a brute-force search of the live values and
+//   the final drain against them sorted.
+template <template <typename...> typename PQ>
+void testErase() {
+    std::cout << "Testing erase..." << std::endl;
+
+    PQ<int> pq;
+    using Handle = decltype(pq.addNode(0));
+    std::vector<Handle> handles;
+    std::vector<bool> live;
+
+    unsigned int state = 281;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 1000);
+    };
+    auto liveIndex = [&]() {
+        size_t i = static_cast<size_t>(nextValue()) % handles.size();
+        while (!live[i]) {
+            i = (i + 1) % handles.size();
+        }
+        return i;
     };
 
-    std::cout << "PQ tester" << std::endl << std::endl;
-    int idx { 0 };
-    for (auto const& type : types) {
-        std::cout << "  " << idx++ << ") " << type << std::endl;
+    for (int step = 0; step < 6000; ++step) {
+        int op = nextValue() % 6;
+        if (op < 2 || pq.empty()) {
+            handles.push_back(pq.addNode(nextValue()));
+            live.push_back(true);
+        }
+        else if (op == 2) {
+            size_t i = liveIndex();
+            pq.updateElt(handles[i], eltOf(pq, handles[i]) + 1 + nextValue() % 200);
+        }
+        else if (op < 5) {
+            size_t i = liveIndex();
+            pq.erase(handles[i]);
+            live[i] = false;
+        }
+        else {
+            int expected = -1;
+            for (size_t i = 0; i < handles.size(); ++i) {
+                if (live[i] && eltOf(pq, handles[i]) > expected) {
+                    expected = eltOf(pq, handles[i]);
+                }
+            }
+            assert(pq.top() == expected);
+            for (size_t i = 0; i < handles.size(); ++i) {
+                if (live[i] && &eltOf(pq, handles[i]) == &pq.top()) {
+                    live[i] = false;
+                    break;
+                }
+            }
+            pq.pop();
+        }
+        size_t count = static_cast<size_t>(std::count(live.begin(), live.end(), true));
+        assert(pq.size() == count);
     }
-    std::cout << std::endl;
 
-    std::cout << "Select one: ";
-    int choice {};
-    std::cin >> choice;
-    PQType const pqType = types.at(choice);
+    std::vector<int> expected;
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (live[i]) {
+            expected.push_back(eltOf(pq, handles[i]));
+        }
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+    std::vector<int> drained;
+    pq.drain(std::back_inserter(drained));
+    assert(drained == expected);
 
-    std::cout << "Testing the " << pqType << " PQ...";
+    std::cout << "testErase succeeded!" << std::endl;
+}
 
-    // TODO: Add more cases to test other priority queue types.
-    switch (pqType) {
-    case PQType::Unordered:
-        testPriorityQueue<UnorderedPQ>();
-        break;
-    case PQType::Sorted:
-        testPriorityQueue<SortedPQ>();
-        break;
-    case PQType::Binary:
-        testPriorityQueue<BinaryPQ>();
-        break;
-    case PQType::Pairing:
-        testPriorityQueue<PairingPQ>();
-        break;
-    default:
-        std::cout << "Unrecognized PQ type " << pqType << " in main." << std::endl
-                  << "Perhaps you forgot to add tests for all four PQ types." << std::endl;
-        return 1;
+
+// Test that remove_if() on a handle-based PQ leaves the handles of kept
+//   elements usable: updateElt() on them after the purge, then the drain
+//   checked against the live values.
+template <template <typename...> typename PQ>
+void testRemoveIfHandles() {
+    std::cout << "Testing remove_if with handles..." << std::endl;
+
+    PQ<int> pq;
+    using Handle = decltype(pq.addNode(0));
+    std::vector<Handle> handles;
+    std::vector<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back((i * 7919) % 1000);
+        handles.push_back(pq.addNode(values.back()));
+    }
+    for (int i = 0; i < 5; ++i) {
+        pq.pop();
+    }
+    // The values are 0..999 once each, so 995..999 were popped and 332
+    //   multiples of 3 are left.
+    assert(pq.remove_if([](int value) { return value % 3 == 0; }) == 332);
+    assert(pq.size() == 1000 - 5 - 332);
+
+    std::vector<int> expected;
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (values[i] % 3 == 0 || values[i] >= 995) {
+            continue;
+        }
+        if (i % 4 == 0) {
+            pq.updateElt(handles[i], values[i] + 1000);
+        }
+        assert(eltOf(pq, handles[i]) == (i % 4 == 0 ? values[i] + 1000 : values[i]));
+        expected.push_back(eltOf(pq, handles[i]));
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+    std::vector<int> drained;
+    pq.drain(std::back_inserter(drained));
+    assert(drained == expected);
+
+    std::cout << "testRemoveIfHandles succeeded!" << std::endl;
+}
+
+
+// Test ShiftPairingPQ's shifts against the keys its handles report: after
+//   shiftSubtree() every key moved by the delta or not at all, the node's
+//   own among the moved, and top() and the final drain must agree with the
+//   handles throughout. Also covers updateElt(), erase(), copies,
+//   updatePriorities() and unsigned keys wrapping below zero.
+void testShiftPairing() {
+    std::cout << "Testing ShiftPairingPQ..." << std::endl;
+
+    using Heap = ShiftPairingPQ<int>;
+    Heap pq;
+    std::vector<Heap::Node*> handles;
+    std::vector<int> keys;
+    unsigned int state = 2718;
+    auto next = [&state](unsigned int bound) {
+        state = state * 1103515245u + 12345u;
+        return (state >> 16) % bound;
+    };
+    auto largest = [&keys]() {
+        return static_cast<std::size_t>(std::max_element(keys.begin(), keys.end()) - keys.begin());
+    };
+    auto forget = [&](std::size_t i) {
+        handles[i] = handles.back();
+        handles.pop_back();
+        keys[i] = keys.back();
+        keys.pop_back();
+    };
+
+    for (int step = 0; step < 3000; ++step) {
+        unsigned int op = next(12);
+        if (handles.empty() || op < 4) {
+            int key = static_cast<int>(next(1000));
+            handles.push_back(pq.addNode(key));
+            keys.push_back(key);
+        }
+        else if (op == 4) {
+            // erasing the root is pop(), which pushes its delta down
+            std::size_t i = largest();
+            pq.erase(handles[i]);
+            forget(i);
+        }
+        else if (op == 5) {
+            std::size_t i = next(static_cast<unsigned int>(handles.size()));
+            pq.erase(handles[i]);
+            forget(i);
+        }
+        else if (op == 6) {
+            int delta = static_cast<int>(next(200)) - 100;
+            pq.shift_all(delta);
+            for (int& key : keys) {
+                key += delta;
+            }
+        }
+        else if (op == 7) {
+            std::size_t i = next(static_cast<unsigned int>(handles.size()));
+            keys[i] += static_cast<int>(next(300));
+            pq.updateElt(handles[i], keys[i]);
+        }
+        else {
+            std::size_t i = next(static_cast<unsigned int>(handles.size()));
+            int delta = static_cast<int>(next(400)) - 200;
+            pq.shiftSubtree(handles[i], delta);
+            keys[i] += delta;
+            for (std::size_t j = 0; j < handles.size(); ++j) {
+                int now = handles[j]->getElt();
+                assert(now == keys[j] || (j != i && now == keys[j] + delta));
+                keys[j] = now;
+            }
+        }
+
+        assert(pq.size() == handles.size());
+        if (!handles.empty()) {
+            assert(pq.top() == keys[largest()]);
+        }
+        if (step % 500 == 0) {
+            for (std::size_t j = 0; j < handles.size(); ++j) {
+                assert(**handles[j] == keys[j]);
+            }
+        }
+    }
+
+    Heap copy { pq };
+    pq.updatePriorities();
+    for (std::size_t j = 0; j < handles.size(); ++j) {
+        assert(handles[j]->getElt() == keys[j]);
+    }
+    std::sort(keys.begin(), keys.end(), std::greater<int>());
+    std::vector<int> drained;
+    pq.drain(std::back_inserter(drained));
+    assert(drained == keys);
+    drained.clear();
+    copy.drain(std::back_inserter(drained));
+    assert(drained == keys);
+
+    // Unsigned keys shifted down, and keys melded under a shifted root, are
+    //   stored wrapped.
+    ShiftPairingPQ<unsigned int, std::greater<unsigned int>> wrapped;
+    ShiftPairingPQ<unsigned int, std::greater<unsigned int>>::Node* high = wrapped.addNode(2000);
+    wrapped.push(1000);
+    wrapped.shift_all(0u - 500u);
+    wrapped.push(600);
+    assert(high->getElt() == 1500);
+    wrapped.shiftSubtree(high, 5);
+    assert(wrapped.top() == 500);
+    wrapped.pop();
+    assert(wrapped.top() == 600);
+    wrapped.pop();
+    assert(wrapped.top() == 1505);
+
+    static_assert(std::is_same<pmr::ShiftPairingPQ<int>,
+                               ShiftPairingPQ<int, std::less<int>, std::pmr::polymorphic_allocator<int>>>::value,
+                  "pmr::ShiftPairingPQ");
+
+    std::cout << "testShiftPairing succeeded!" << std::endl;
+}
+
+
+// Test the rank-pairing heap's constructors and handle operations.
+void testRankPairing() {
+    std::cout << "Testing Rank-Pairing Heap separately..." << std::endl;
+
+    {
+        std::vector<int> const vec {
+            1,
+            0,
+        };
+
+        RankPairingPQ<int> rank1 { vec.cbegin(), vec.cend() };
+        RankPairingPQ<int> rank2 { rank1 };
+        RankPairingPQ<int> rank3 {};
+        rank3 = rank2;
+
+        rank1.push(3);
+        rank2.pop();
+        assert(rank1.size() == 3);
+        assert(rank1.top() == 3);
+        assert(rank2.top() == 0);
+        assert(rank3.top() == 1);
+
+        RankPairingPQ<int> rpq;
+        RankPairingPQ<int>::Node *np = rpq.addNode(20);
+        rpq.push(10);
+        RankPairingPQ<int>::Node *np2 = rpq.addNode(8);
+        rpq.push(7);
+        rpq.push(6);
+        // Pop once so the remaining nodes are linked into a half-tree
+        //   before their priorities change.
+        rpq.pop();
+        assert(rpq.top() == 10);
+        rpq.updateElt(np2, 21);
+        assert(rpq.top() == 21);
+        assert(rpq.size() == 4);
+        np = rpq.addNode(1);
+        rpq.updateElt(np, 25);
+        assert(rpq.top() == 25);
+        assert(rpq.size() == 5);
+    }
+
+    std::cout << "testRankPairing succeeded!" << std::endl;
+}
+
+
+// Test that the adaptive PQ changes representation as its workload changes
+//   and keeps its contents across every migration.
+void testAdaptive() {
+    std::cout << "Testing Adaptive PQ migrations..." << std::endl;
+
+    using Representation = AdaptivePQ<int>::Representation;
+    AdaptivePQ<int> apq;
+    assert(apq.representation() == Representation::Unordered);
+
+    // Growing well past the small-queue threshold moves it into a heap.
+    for (int i = 0; i < 1000; ++i) {
+        apq.push((i * 37) % 1000);
+    }
+    assert(apq.representation() == Representation::Binary);
+
+    // A long run of pops with no pushes favours the sorted array.
+    int previous = apq.top();
+    for (int i = 0; i < 600; ++i) {
+        assert(apq.top() <= previous);
+        previous = apq.top();
+        apq.pop();
+    }
+    assert(apq.representation() == Representation::Sorted);
+    assert(apq.size() == 400);
+
+    // Copies keep the representation and contents.
+    AdaptivePQ<int> copy { apq };
+    assert(copy.representation() == Representation::Sorted);
+    assert(copy.top() == apq.top());
+
+    // Mixing pushes back in leaves the sorted array.
+    for (int i = 0; i < 400; ++i) {
+        apq.push(i % 7);
+        apq.pop();
+    }
+    assert(apq.representation() == Representation::Binary);
+
+    // Draining down to a handful of elements returns to the linear scan.
+    previous = apq.top();
+    while (apq.size() > 10) {
+        assert(apq.top() <= previous);
+        previous = apq.top();
+        apq.pop();
+    }
+    for (int i = 0; i < 100; ++i) {
+        apq.push(0);
+        apq.pop();
+    }
+    assert(apq.representation() == Representation::Unordered);
+    assert(apq.size() == 10);
+
+    // Peeking without popping is not a pop-heavy workload.
+    AdaptivePQ<int> peeked;
+    for (int i = 0; i < 2000; ++i) {
+        peeked.push(i);
+        for (int j = 0; j < 40; ++j) {
+            assert(peeked.top() == i);
+        }
+    }
+    assert(peeked.representation() == Representation::Binary);
+
+    // A copy into another resource allocates every representation from the
+    //   target's, and each resource gets back all it gave out.
+    {
+        using Alloc = std::pmr::polymorphic_allocator<int>;
+        CountingResource source, target;
+        {
+            pmr::AdaptivePQ<int> original { Alloc { &source } };
+            for (int i = 0; i < 1000; ++i) {
+                original.push((i * 37) % 1000);
+            }
+            while (original.size() > 400) {
+                original.pop();
+            }
+            assert(original.representation() == pmr::AdaptivePQ<int>::Representation::Sorted);
+            size_t sourceAllocations = source.allocations;
+            pmr::AdaptivePQ<int> copied { original, Alloc { &target } };
+            assert(source.allocations == sourceAllocations);
+            assert(target.allocations > 0);
+            pmr::AdaptivePQ<int> assigned { Alloc { &target } };
+            assigned = original;
+            assert(source.allocations == sourceAllocations);
+            assert(copied.top() == original.top() && assigned.top() == original.top());
+        }
+        assert(source.outstanding == 0);
+        assert(target.outstanding == 0);
+    }
+
+    std::cout << "testAdaptive succeeded!" << std::endl;
+}
+
+
+// Test the sequence heap with enough elements to fill several groups, which
+//   exercises run merging, buffer refills and updatePriorities(), checking
+//   every top() against a std::multiset.
+void testSequenceHeap() {
+    std::cout << "Testing Sequence Heap with many elements..." << std::endl;
+
+    SequenceHeapPQ<int> seq;
+    // A multiset rather than std::priority_queue, whose push and pop are O(n)
+    //   under _GLIBCXX_DEBUG's heap checks.
+    std::multiset<int> expected;
+
+    unsigned int state = 99;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 8) % 1000000);
+    };
+
+    // Phases alternate between mostly pushing and mostly popping.
+    for (int phase = 0; phase < 6; ++phase) {
+        int pushPercent = phase % 2 == 0 ? 90 : 30;
+        for (int step = 0; step < 60000; ++step) {
+            if (expected.empty() || nextValue() % 100 < pushPercent) {
+                int value = nextValue();
+                seq.push(value);
+                expected.insert(value);
+            }
+            else {
+                assert(seq.top() == *expected.rbegin());
+                seq.pop();
+                expected.erase(std::prev(expected.end()));
+            }
+            assert(seq.size() == expected.size());
+        }
+        if (phase == 2) {
+            seq.updatePriorities();
+        }
     }
 
+    SequenceHeapPQ<int> copy { seq };
+    while (!expected.empty()) {
+        assert(seq.top() == *expected.rbegin());
+        assert(copy.top() == *expected.rbegin());
+        seq.pop();
+        copy.pop();
+        expected.erase(std::prev(expected.end()));
+    }
+    assert(seq.empty());
+
+    std::cout << "testSequenceHeap succeeded!" << std::endl;
+}
+
+
+// Test LoserTreeMerge over sorted vectors and pipes: the merge must match a
+//   sort of every run's elements, keep equal keys in run order, stream
+//   through begin()/end() and pop_k(), refill BufferedRun across partial
+//   buffers, and reject input that ends inside a record.
+void testLoserTreeMerge() {
+    std::cout << "Testing LoserTreeMerge..." << std::endl;
+
+    unsigned int state = 31415;
+    auto next = [&state](unsigned int bound) {
+        state = state * 1103515245u + 12345u;
+        return (state >> 16) % bound;
+    };
+
+    struct Tagged {
+        int key;
+        int tag;
+    };
+    struct TaggedComp {
+        bool operator()(Tagged const& a, Tagged const& b) const { return a.key < b.key; }
+    };
+    using TaggedRun = IteratorRun<std::vector<Tagged>::const_iterator>;
+
+    for (int k : { 0, 1, 2, 3, 5, 64, 100 }) {
+        std::vector<std::vector<Tagged>> data(static_cast<size_t>(k));
+        std::vector<Tagged> all;
+        for (int run = 0; run < k; ++run) {
+            std::vector<Tagged>& items = data[static_cast<size_t>(run)];
+            unsigned int length = next(40);
+            for (unsigned int i = 0; i < length; ++i) {
+                items.push_back(Tagged { static_cast<int>(next(50)), 0 });
+            }
+            std::sort(items.begin(), items.end(), [](Tagged const& a, Tagged const& b) { return a.key > b.key; });
+            for (size_t i = 0; i < items.size(); ++i) {
+                items[i].tag = run * 1000 + static_cast<int>(i);
+            }
+            all.insert(all.end(), items.begin(), items.end());
+        }
+        std::vector<TaggedRun> runs;
+        for (auto const& items : data) {
+            runs.emplace_back(items.cbegin(), items.cend());
+        }
+        LoserTreeMerge<TaggedRun, TaggedComp> merge { runs.begin(), runs.end() };
+        assert(merge.runCount() == static_cast<size_t>(k));
+        std::vector<Tagged> merged;
+        merge.drain(std::back_inserter(merged));
+        assert(merge.empty());
+        assert(merged.size() == all.size());
+        for (size_t i = 1; i < merged.size(); ++i) {
+            assert(merged[i - 1].key > merged[i].key
+                   || (merged[i - 1].key == merged[i].key && merged[i - 1].tag < merged[i].tag));
+        }
+    }
+
+    std::vector<std::vector<int>> ascending { { 1, 4, 9 }, {}, { 2, 3, 10, 11 }, { 0 } };
+    using IntRun = IteratorRun<std::vector<int>::const_iterator>;
+    std::vector<IntRun> intRuns;
+    for (auto const& items : ascending) {
+        intRuns.emplace_back(items.cbegin(), items.cend());
+    }
+    LoserTreeMerge<IntRun, std::greater<int>> streamed { intRuns.begin(), intRuns.end() };
+    std::vector<int> firstThree;
+    streamed.pop_k(3, std::back_inserter(firstThree));
+    assert((firstThree == std::vector<int> { 0, 1, 2 }));
+    std::vector<int> rest(streamed.begin(), streamed.end());
+    assert((rest == std::vector<int> { 3, 4, 9, 10, 11 }));
+    assert(streamed.begin() == streamed.end());
+
+    // Strings are too big to copy into the tree and are compared in place.
+    std::vector<std::vector<std::string>> words { { "pear", "fig" }, { "plum", "kiwi", "apple" }, {} };
+    using WordRun = IteratorRun<std::vector<std::string>::const_iterator>;
+    std::vector<WordRun> wordRuns;
+    for (auto const& items : words) {
+        wordRuns.emplace_back(items.cbegin(), items.cend());
+    }
+    LoserTreeMerge<WordRun> byWord { wordRuns.begin(), wordRuns.end() };
+    std::vector<std::string> sortedWords(byWord.begin(), byWord.end());
+    assert((sortedWords == std::vector<std::string> { "plum", "pear", "kiwi", "fig", "apple" }));
+
+    // Each pipe holds one descending run; three records per buffer forces
+    //   refills in the middle of the merge.
+    std::vector<int> pipes;
+    std::vector<std::uint32_t> expected;
+    for (int run = 0; run < 4; ++run) {
+        std::vector<std::uint32_t> keys;
+        for (int i = 0; i < 20 + run; ++i) {
+            keys.push_back(next(1000));
+        }
+        std::sort(keys.begin(), keys.end(), std::greater<std::uint32_t>());
+        expected.insert(expected.end(), keys.begin(), keys.end());
+        int fds[2];
+        assert(pipe(fds) == 0);
+        ssize_t written = write(fds[1], keys.data(), keys.size() * sizeof(std::uint32_t));
+        assert(written == static_cast<ssize_t>(keys.size() * sizeof(std::uint32_t)));
+        close(fds[1]);
+        pipes.push_back(fds[0]);
+    }
+    std::sort(expected.begin(), expected.end(), std::greater<std::uint32_t>());
+    std::vector<BufferedRun<std::uint32_t>> fileRuns;
+    for (int fd : pipes) {
+        fileRuns.emplace_back(fd, 3);
+    }
+    LoserTreeMerge<BufferedRun<std::uint32_t>> fromPipes { fileRuns.begin(), fileRuns.end() };
+    std::vector<std::uint32_t> piped(fromPipes.begin(), fromPipes.end());
+    assert(piped == expected);
+    for (int fd : pipes) {
+        close(fd);
+    }
+
+    int fds[2];
+    assert(pipe(fds) == 0);
+    unsigned char partial[6] = { 1, 0, 0, 0, 2, 0 };
+    assert(write(fds[1], partial, sizeof(partial)) == static_cast<ssize_t>(sizeof(partial)));
+    close(fds[1]);
+    bool threw = false;
+    try {
+        BufferedRun<std::uint32_t> truncated { fds[0], 1 };
+        assert(truncated.front() == 1);
+        truncated.pop_front();
+    }
+    catch (std::runtime_error const&) {
+        threw = true;
+    }
+    assert(threw);
+    close(fds[0]);
+
+    static_assert(std::is_same<pmr::LoserTreeMerge<IntRun>,
+                               LoserTreeMerge<IntRun, std::less<int>, std::pmr::polymorphic_allocator<IntRun>>>::value,
+                  "pmr::LoserTreeMerge");
+
+    std::cout << "testLoserTreeMerge succeeded!" << std::endl;
+}
+
+
+// Test the pool-based pairing heap's handles: the same mix of adds, priority
+//   increases and pops as testUpdateEltMany, plus handles staying valid
+//   across pool growth, slot reuse, updatePriorities() and copies.
+void testCompactPairing() {
+    std::cout << "Testing Compact Pairing Heap separately..." << std::endl;
+
+    using Handle = CompactPairingPQ<int>::Handle;
+    CompactPairingPQ<int> pq;
+    std::vector<Handle> handles;
+    std::vector<bool> live;
+
+    unsigned int state = 2024;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 1000);
+    };
+
+    for (int step = 0; step < 4000; ++step) {
+        int op = nextValue() % 4;
+        if (op < 2 || pq.empty()) {
+            handles.push_back(pq.addNode(nextValue()));
+            live.push_back(true);
+        }
+        else if (op == 2) {
+            size_t i = static_cast<size_t>(nextValue()) % handles.size();
+            if (live[i]) {
+                pq.updateElt(handles[i], pq.getElt(handles[i]) + 1 + nextValue() % 200);
+            }
+        }
+        else {
+            int expected = -1;
+            for (size_t i = 0; i < handles.size(); ++i) {
+                if (live[i] && pq.getElt(handles[i]) > expected) {
+                    expected = pq.getElt(handles[i]);
+                }
+            }
+            assert(pq.top() == expected);
+            for (size_t i = 0; i < handles.size(); ++i) {
+                if (live[i] && &pq.getElt(handles[i]) == &pq.top()) {
+                    live[i] = false;
+                }
+            }
+            pq.pop();
+        }
+        if (step == 2000) {
+            pq.updatePriorities();
+        }
+    }
+
+    // Handles index the pool, so they refer to the same elements in a copy.
+    CompactPairingPQ<int> copy { pq };
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (live[i]) {
+            assert(copy.getElt(handles[i]) == pq.getElt(handles[i]));
+            copy.updateElt(handles[i], pq.getElt(handles[i]) + 1000);
+            pq.updateElt(handles[i], pq.getElt(handles[i]) + 1000);
+        }
+    }
+    while (!pq.empty()) {
+        assert(copy.top() == pq.top());
+        copy.pop();
+        pq.pop();
+    }
+    assert(copy.empty());
+
+    std::cout << "testCompactPairing succeeded!" << std::endl;
+}
+
+
+// Kills the calling process on a chosen comparison, to leave a
+//   SharedMemoryPQ's mutex held by a dead process partway through a sift.
+struct DyingComp {
+    static inline int countdown = -1;
+
+    bool operator()(int a, int b) const {
+        if (countdown >= 0 && countdown-- == 0) {
+            _exit(0);
+        }
+        return a < b;
+    }
+};
+
+// Runs 'body' in a child process and checks that the child exited cleanly.
+template <typename F>
+void inChild(F body) {
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        body();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+// Test the shared memory PQ from several processes: producers blocking on a
+//   full anonymous region while the parent pops, a named region created,
+//   attached and closed, and repair after a process dies inside a sift.
+void testSharedMemory() {
+    std::cout << "Testing the shared memory PQ across processes..." << std::endl;
+
+    SharedMemoryPQ<int> shared { std::less<int> {}, 64 };
+    std::vector<pid_t> producers;
+    for (int p = 0; p < 4; ++p) {
+        pid_t pid = fork();
+        assert(pid >= 0);
+        if (pid == 0) {
+            // Odd producers push in ranges larger than the capacity.
+            std::vector<int> values;
+            for (int i = 0; i < 1000; ++i) {
+                values.push_back(p * 1000 + i);
+                if (p % 2 == 0) {
+                    shared.push(values.back());
+                }
+            }
+            if (p % 2 == 1) {
+                shared.pushRange(values.begin(), values.begin() + 100);
+                shared.pushRange(values.begin() + 100, values.end());
+            }
+            _exit(0);
+        }
+        producers.push_back(pid);
+    }
+    std::vector<int> received;
+    int value = 0;
+    while (received.size() < 4000) {
+        size_t const before = received.size();
+        if (before % 2 == 0) {
+            if (shared.waitPop(value)) {
+                received.push_back(value);
+            }
+        }
+        else {
+            shared.waitPop_k(10, std::back_inserter(received));
+        }
+        assert(received.size() > before);
+    }
+    for (pid_t pid : producers) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    assert(shared.empty());
+    std::sort(received.begin(), received.end());
+    for (int i = 0; i < 4000; ++i) {
+        assert(received[static_cast<size_t>(i)] == i);
+    }
+
+    std::string const name = "/testPQ-" + std::to_string(getpid());
+    SharedMemoryPQ<int>::unlink(name);
+    {
+        auto created = SharedMemoryPQ<int>::create(name, 1000);
+        assert(created.capacity() == 1000);
+        bool threw = false;
+        try {
+            SharedMemoryPQ<int>::create(name, 10);
+        }
+        catch (std::system_error const&) {
+            threw = true;
+        }
+        assert(threw);
+        threw = false;
+        try {
+            SharedMemoryPQ<long long>::attach(name);
+        }
+        catch (std::runtime_error const&) {
+            threw = true;
+        }
+        assert(threw);
+
+        inChild([&name]() {
+            auto attached = SharedMemoryPQ<int>::attach(name);
+            for (int i = 0; i < 500; ++i) {
+                attached.push((i * 37) % 500);
+            }
+            attached.close();
+        });
+        assert(created.closed());
+        assert(created.size() == 500);
+        std::vector<int> drained;
+        created.drain(std::back_inserter(drained));
+        for (int i = 0; i < 500; ++i) {
+            assert(drained[static_cast<size_t>(i)] == 499 - i);
+        }
+        assert(!created.waitPop(value));
+        assert(!created.tryPop(value));
+    }
+    assert(SharedMemoryPQ<int>::unlink(name));
+    assert(!SharedMemoryPQ<int>::unlink(name));
+    bool threw = false;
+    try {
+        SharedMemoryPQ<int>::attach(name);
+    }
+    catch (std::system_error const&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Whichever comparison the child dies on, its push or pop has either
+    //   completed or never happened, and the heap still pops in order.
+    for (int countdown = 0; countdown < 24; ++countdown) {
+        for (bool popping : { false, true }) {
+            SharedMemoryPQ<int, DyingComp> pq {};
+            std::multiset<int> expected;
+            for (int i = 0; i < 200; ++i) {
+                pq.push((i * 7919) % 1000);
+                expected.insert((i * 7919) % 1000);
+            }
+            int const top = pq.top();
+            inChild([&pq, countdown, popping]() {
+                DyingComp::countdown = countdown;
+                if (popping) {
+                    pq.pop();
+                }
+                else {
+                    pq.push(1500);
+                }
+            });
+            if (pq.size() != expected.size()) {
+                if (popping) {
+                    expected.erase(expected.find(top));
+                }
+                else {
+                    expected.insert(1500);
+                }
+            }
+            std::vector<int> drained;
+            pq.drain(std::back_inserter(drained));
+            assert(std::equal(drained.begin(), drained.end(), expected.rbegin(), expected.rend()));
+        }
+    }
+
+    // A single-pass range is read once, not counted and then read again.
+    std::istringstream input { "5 3 9 1 7" };
+    SharedMemoryPQ<int> streamed { std::istream_iterator<int> { input }, std::istream_iterator<int> {} };
+    assert(streamed.size() == 5);
+    assert(streamed.capacity() == SharedMemoryPQ<int>::DEFAULT_CAPACITY);
+    std::vector<int> streamedOrder;
+    streamed.drain(std::back_inserter(streamedOrder));
+    assert((streamedOrder == std::vector<int> { 9, 7, 5, 3, 1 }));
+
+    std::cout << "testSharedMemory succeeded!" << std::endl;
+}
+
+
+// Test the soft heap past the size where it starts corrupting elements: the
+//   number corrupted must stay within epsilon of the pushes, every element
+//   must come back out exactly once, and copies must pop the same sequence.
+void testSoftHeap() {
+    std::cout << "Testing Soft Heap corruption bounds..." << std::endl;
+
+    bool threw = false;
+    try {
+        SoftHeapPQ<int> invalid { 0.0 };
+    }
+    catch (std::invalid_argument const&) {
+        threw = true;
+    }
+    assert(threw);
+
+    for (double epsilon : { 0.5, 0.1 }) {
+        SoftHeapPQ<int> soft { epsilon };
+        assert(soft.epsilon() == epsilon);
+        std::multiset<int> expected;
+        unsigned int state = 31337;
+        std::size_t pushes = 0;
+        for (int i = 0; i < 40000; ++i) {
+            state = state * 1103515245u + 12345u;
+            int value = static_cast<int>((state >> 8) % 1000000);
+            soft.push(value);
+            expected.insert(value);
+            pushes++;
+            if (i % 1000 == 999) {
+                assert(static_cast<double>(soft.corrupted()) <= epsilon * static_cast<double>(pushes));
+            }
+        }
+        assert(soft.corrupted() > 0);
+
+        SoftHeapPQ<int> copy { soft };
+        std::vector<int> popped;
+        while (!soft.empty()) {
+            assert(copy.top() == soft.top());
+            popped.push_back(soft.top());
+            soft.pop();
+            copy.pop();
+            if (popped.size() % 1000 == 0) {
+                assert(static_cast<double>(soft.corrupted()) <= epsilon * static_cast<double>(pushes));
+            }
+        }
+        assert(copy.empty());
+        assert(soft.corruptedPops() > 0);
+        assert(soft.corruptedPops() == copy.corruptedPops());
+        std::sort(popped.begin(), popped.end());
+        assert(std::equal(popped.begin(), popped.end(), expected.begin(), expected.end()));
+
+        // Rebuilding starts the bound over from the elements held.
+        std::vector<int> values(expected.begin(), expected.end());
+        SoftHeapPQ<int> ranged { values.begin(), values.begin() + 20000, epsilon };
+        for (int i = 0; i < 5000; ++i) {
+            ranged.pop();
+        }
+        ranged.updatePriorities();
+        assert(static_cast<double>(ranged.corrupted()) <= epsilon * 15000.0);
+        std::vector<int> drained;
+        ranged.drain(std::back_inserter(drained));
+        assert(drained.size() == 15000);
+    }
+
+    std::cout << "testSoftHeap succeeded!" << std::endl;
+}
+
+
+// Test StablePQ over this PQ type: elements with equal priorities must pop
+//   in the order they were pushed, for both the packed 32-bit sequence
+//   (8-byte Ticket) and the 64-bit one (pointers), including after
+//   updatePriorities() and from the range-based constructor.
+template <template <typename...> typename PQ>
+void testStable() {
+    std::cout << "Testing stable ordering..." << std::endl;
+
+    struct Ticket {
+        int priority;
+        int id;
+    };
+
+    struct TicketComp {
+        bool operator()(Ticket const& a, Ticket const& b) const {
+            return a.priority < b.priority;
+        }
+    };
+
+    static_assert(sizeof(typename StablePQ<PQ, Ticket, TicketComp>::Stored) == 12,
+                  "Ticket should get a 32-bit sequence number");
+    static_assert(sizeof(typename StablePQ<PQ, int>::Stored) == sizeof(int),
+                  "ints need no sequence number");
+
+    unsigned int state = 4242;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 5);
+    };
+
+    StablePQ<PQ, Ticket, TicketComp> stable;
+    Eecs281PQ<Ticket, TicketComp>& eecsPQ = stable;
+    int id = 0;
+    Ticket last { 100, -1 };
+    for (int step = 0; step < 3000; ++step) {
+        if (eecsPQ.empty() || nextValue() < 3) {
+            eecsPQ.push(Ticket { nextValue(), id++ });
+            last = Ticket { 100, -1 };
+        }
+        else {
+            Ticket const& top = eecsPQ.top();
+            assert(top.priority < last.priority || (top.priority == last.priority && top.id > last.id));
+            last = top;
+            eecsPQ.pop();
+        }
+    }
+
+    std::vector<Ticket> tickets;
+    for (int i = 0; i < 200; ++i) {
+        tickets.push_back(Ticket { nextValue(), i });
+    }
+    StablePQ<PQ, Ticket, TicketComp> ranged { tickets.cbegin(), tickets.cend() };
+    // Removing elements keeps the push order among the ties left.
+    assert(ranged.remove_if([](Ticket const& ticket) { return ticket.id % 2 == 1; }) == 100);
+    assert(ranged.size() == 100);
+    last = Ticket { 100, -1 };
+    while (!ranged.empty()) {
+        assert(ranged.top().id % 2 == 0);
+        assert(ranged.top().priority < last.priority
+               || (ranged.top().priority == last.priority && ranged.top().id > last.id));
+        last = ranged.top();
+        ranged.pop();
+    }
+
+    std::vector<int> data(100);
+    StablePQ<PQ, int const*, IntPtrComp> pointers;
+    for (int i = 0; i < 100; ++i) {
+        data[static_cast<size_t>(i)] = i % 3;
+    }
+    for (auto& datum : data) {
+        pointers.push(&datum);
+    }
+    // Reverse the priorities; ties must still pop in push (address) order.
+    for (auto& datum : data) {
+        datum = 2 - datum;
+    }
+    pointers.updatePriorities();
+    int const* previous = nullptr;
+    while (!pointers.empty()) {
+        int const* top = pointers.top();
+        assert(previous == nullptr || *top < *previous || (*top == *previous && top > previous));
+        previous = top;
+        pointers.pop();
+    }
+
+    StablePQ<PQ, int, std::greater<int>> ints;
+    for (int i = 0; i < 50; ++i) {
+        ints.push(nextValue());
+    }
+    int smallest = -1;
+    while (!ints.empty()) {
+        assert(ints.top() >= smallest);
+        smallest = ints.top();
+        ints.pop();
+    }
+
+    std::cout << "testStable succeeded!" << std::endl;
+}
+
+
+// Test ShiftablePQ over this PQ type: shift_all() must move every key held
+//   and none pushed later, against a multiset shifted by hand, for signed,
+//   unsigned (pushed below the base) and floating keys, and through the
+//   range-based constructor.
+template <template <typename...> typename PQ>
+void testShiftable() {
+    std::cout << "Testing shift_all..." << std::endl;
+
+    unsigned int state = 1618;
+    auto next = [&state](unsigned int bound) {
+        state = state * 1103515245u + 12345u;
+        return (state >> 16) % bound;
+    };
+
+    ShiftablePQ<PQ, int> pq;
+    Eecs281PQ<int>& eecsPQ = pq;
+    std::multiset<int> expected;
+    for (int step = 0; step < 2000; ++step) {
+        unsigned int op = next(8);
+        if (expected.empty() || op < 4) {
+            int value = static_cast<int>(next(1000)) - 500;
+            eecsPQ.push(value);
+            expected.insert(value);
+        }
+        else if (op < 7) {
+            assert(eecsPQ.top() == *expected.rbegin());
+            eecsPQ.pop();
+            expected.erase(std::prev(expected.end()));
+        }
+        else {
+            int delta = static_cast<int>(next(100)) - 40;
+            pq.shift_all(delta);
+            std::multiset<int> shifted;
+            for (int value : expected) {
+                shifted.insert(value + delta);
+            }
+            expected.swap(shifted);
+        }
+        assert(eecsPQ.size() == expected.size());
+    }
+    pq.updatePriorities();
+    while (!eecsPQ.empty()) {
+        assert(eecsPQ.top() == *expected.rbegin());
+        eecsPQ.pop();
+        expected.erase(std::prev(expected.end()));
+    }
+
+    ShiftablePQ<PQ, unsigned int, std::greater<>> aging;
+    aging.push(5);
+    aging.push(7);
+    aging.shift_all(100);
+    aging.push(3);
+    aging.push(106);
+    assert(aging.top() == 3);
+    aging.pop();
+    assert(aging.top() == 105);
+    aging.pop();
+    assert(aging.top() == 106);
+    aging.shift_all(-6);
+    assert(aging.top() == 100);
+    aging.pop();
+    assert(aging.top() == 101);
+
+    std::vector<double> values { 0.5, -2.0, 8.25 };
+    ShiftablePQ<PQ, double, std::less<double>> ranged { values.begin(), values.end() };
+    ranged.shift_all(0.25);
+    assert(ranged.top() == 8.5);
+    ranged.pop();
+    ranged.push(1.0);
+    assert(ranged.top() == 1.0);
+    ranged.pop();
+    assert(ranged.top() == 0.75);
+
+    // remove_if() sees the keys with the shifts applied.
+    ShiftablePQ<PQ, int> purged;
+    for (int i = 1; i <= 10; ++i) {
+        purged.push(i);
+    }
+    purged.shift_all(10);
+    assert(purged.remove_if([](int key) { return key > 15; }) == 5);
+    assert(purged.size() == 5 && purged.top() == 15);
+
+    static_assert(std::is_same<typename ShiftablePQ<PQ, unsigned short>::Offset, std::int64_t>::value,
+                  "integral keys are stored as 64-bit offsets");
+    static_assert(std::is_same<pmr::ShiftablePQ<PQ, int>,
+                               ShiftablePQ<PQ, int, std::less<int>, std::pmr::polymorphic_allocator<int>>>::value,
+                  "pmr::ShiftablePQ");
+
+    std::cout << "testShiftable succeeded!" << std::endl;
+}
+
+
+// Record a workload on this PQ type through RecordingPQ, read the trace back
+//   and replay it against a fresh PQ, which must see the same top() values.
+template <template <typename...> typename PQ>
+void testRecording() {
+    std::cout << "Testing trace recording and replay..." << std::endl;
+
+    std::ostringstream trace;
+    size_t operations = 0;
+    {
+        RecordingPQ<PQ, int> recording { trace };
+        Eecs281PQ<int>& eecsPQ = recording;
+        unsigned int state = 31337;
+        auto nextValue = [&state]() {
+            state = state * 1103515245u + 12345u;
+            return static_cast<int>((state >> 16) % 2000) - 1000;
+        };
+        for (int step = 0; step < 2000; ++step) {
+            if (step % 500 == 499) {
+                // Recorded as the call plus one event per value removed.
+                operations += recording.remove_if([](int value) { return value % 7 == 0; });
+            }
+            else if (eecsPQ.empty() || nextValue() < 200) {
+                eecsPQ.push(nextValue());
+            }
+            else {
+                eecsPQ.top();
+                eecsPQ.pop();
+                ++operations;
+            }
+            ++operations;
+        }
+        eecsPQ.updatePriorities();
+        ++operations;
+    }
+
+    std::istringstream in { trace.str() };
+    std::vector<TraceEvent<int>> events = readTrace<int>(in);
+    assert(events.size() == operations);
+    assert(!traceNeedsHandles(events));
+    // Opcode plus a varint for values within a couple of thousand.
+    assert(trace.str().size() < 7 + 3 * events.size());
+
+    PQ<int> fresh;
+    assert(replayTrace(events, fresh) == 0);
+
+    // A replay that diverges is reported.
+    events.front().value = 5000;
+    PQ<int> diverged;
+    assert(replayTrace(events, diverged) > 0);
+
+    // A trace for another key type is rejected.
+    std::istringstream wrongType { trace.str() };
+    bool rejected = false;
+    try {
+        readTrace<long long>(wrongType);
+    }
+    catch (std::runtime_error const&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    std::cout << "testRecording succeeded!" << std::endl;
+}
+
+
+// Record addNode() and updateElt() through RecordingPQ on a PQ with handles
+//   and replay the trace against a fresh one.
+template <template <typename...> typename PQ>
+void testRecordingHandles() {
+    std::cout << "Testing trace recording with handles..." << std::endl;
+
+    using Node = typename PQ<int>::Node;
+    std::ostringstream trace;
+    {
+        RecordingPQ<PQ, int> recording { trace };
+        std::vector<Node*> handles;
+        for (int i = 0; i < 200; ++i) {
+            handles.push_back(recording.addNode(i * 7 % 101));
+        }
+        for (int i = 0; i < 100; ++i) {
+            recording.top();
+            recording.pop();
+            if (i % 3 == 0) {
+                recording.updateElt(recording.addNode(i), 500 + i);
+            }
+            if (i == 50) {
+                assert(recording.remove_if([](int value) { return value % 5 == 0; }) > 0);
+            }
+        }
+        while (!recording.empty()) {
+            recording.top();
+            recording.pop();
+        }
+    }
+
+    std::istringstream in { trace.str() };
+    std::vector<TraceEvent<int>> events = readTrace<int>(in);
+    assert(traceNeedsHandles(events));
+    PQ<int> fresh;
+    assert(replayTrace(events, fresh) == 0);
+    assert(fresh.empty());
+
+    BinaryPQ<int> noHandles;
+    bool refused = false;
+    try {
+        replayTrace(events, noHandles);
+    }
+    catch (std::runtime_error const&) {
+        refused = true;
+    }
+    assert(refused);
+
+    // A popped node's handle is forgotten: once everything is popped, the
+    //   recording holds little more memory than the bare PQ, its empty
+    //   handle table's buckets, where keeping the entries would hold a
+    //   pair per node.
+    using Alloc = std::pmr::polymorphic_allocator<int>;
+    CountingResource recorded, bare;
+    {
+        std::ostringstream discard;
+        pmr::RecordingPQ<PQ, int> recording { discard, std::less<int>(), Alloc { &recorded } };
+        PQ<int, std::less<int>, Alloc> plain { std::less<int>(), Alloc { &bare } };
+        for (int i = 0; i < 2000; ++i) {
+            recording.addNode(i);
+            plain.addNode(i);
+        }
+        while (!recording.empty()) {
+            recording.pop();
+            plain.pop();
+        }
+        assert(recorded.outstanding - bare.outstanding < 2000 * sizeof(std::pair<const void*, std::uint64_t>));
+    }
+    assert(recorded.outstanding == 0);
+
+    std::cout << "testRecordingHandles succeeded!" << std::endl;
+}
+
+
+// Test PriorityExecutor backed by this PQ type: priority and FIFO order on a
+//   single worker, results and exceptions through futures, and tasks that
+//   submit more tasks on several workers.
+template <template <typename...> typename PQ>
+void testExecutor() {
+    std::cout << "Testing PriorityExecutor..." << std::endl;
+
+    {
+        PriorityExecutor<PQ> executor { 1 };
+        std::promise<void> gate;
+        std::promise<void> holding;
+        std::shared_future<void> opened { gate.get_future() };
+        std::vector<int> order;
+
+        // Hold the only worker so everything below is queued before any of
+        //   it runs.
+        executor.submit(0, [opened, &holding]() {
+            holding.set_value();
+            opened.wait();
+        });
+        holding.get_future().wait();
+        std::vector<std::future<void>> done;
+        int const priorities[] { 1, 5, 3, 5, 1, 9 };
+        for (int i = 0; i < 6; ++i) {
+            done.push_back(executor.submit(priorities[i], [&order, i]() { order.push_back(i); }));
+        }
+        gate.set_value();
+        for (auto& future : done) {
+            future.get();
+        }
+        assert((order == std::vector<int> { 5, 1, 3, 2, 0, 4 }));
+    }
+
+    {
+        PriorityExecutor<PQ> executor { 4 };
+        assert(executor.workers() == 4);
+
+        std::vector<std::future<int>> results;
+        for (int i = 0; i < 500; ++i) {
+            results.push_back(executor.submit(i % 7, [i]() { return i * 2; }));
+        }
+        long long sum = 0;
+        for (auto& result : results) {
+            sum += result.get();
+        }
+        assert(sum == 499LL * 500LL);
+
+        auto failed = executor.submit(3, []() -> int { throw std::runtime_error("task"); });
+        bool caught = false;
+        try {
+            failed.get();
+        }
+        catch (std::runtime_error const&) {
+            caught = true;
+        }
+        assert(caught);
+
+        // Follow-up tasks go to the submitting worker's queue.
+        std::atomic<int> leaves { 0 };
+        auto parent = executor.submit(1, [&executor, &leaves]() {
+            std::vector<std::future<void>> children;
+            for (int i = 0; i < 50; ++i) {
+                children.push_back(executor.submit(2, [&leaves]() { leaves++; }));
+            }
+            return children;
+        });
+        for (auto& child : parent.get()) {
+            child.get();
+        }
+        assert(leaves == 50);
+    }
+
+    std::cout << "testExecutor succeeded!" << std::endl;
+}
+
+
+// Test that a PQ built on a polymorphic_allocator does all its allocation
+//   through that allocator's resource, in every operation including copies
+//   and the StablePQ built on it. Storage that ignored the allocator would
+//   come from the default resource, which is switched off meanwhile.
+template <template <typename...> typename PQ>
+void testAllocator() {
+    std::cout << "Testing allocation through a memory_resource..." << std::endl;
+
+    using Alloc = std::pmr::polymorphic_allocator<int>;
+    CountingResource counting;
+    CountingResource elsewhere;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    {
+        PQ<int, std::less<int>, Alloc> pq { Alloc { &counting } };
+        assert(pq.get_allocator().resource() == &counting);
+        unsigned int state = 4242;
+        std::multiset<int> expected;
+        for (int i = 0; i < 3000; ++i) {
+            state = state * 1103515245u + 12345u;
+            int value = static_cast<int>((state >> 16) % 5000);
+            pq.push(value);
+            expected.insert(value);
+        }
+        assert(counting.allocations > 0);
+        pq.updatePriorities();
+        for (int i = 0; i < 1000; ++i) {
+            assert(pq.top() == *expected.rbegin());
+            expected.erase(std::prev(expected.end()));
+            pq.pop();
+        }
+
+        PQ<int, std::less<int>, Alloc> copy { Alloc { &counting } };
+        copy = pq;
+        // Assigning across resources must give every block back to the
+        //   resource it came from (PersistentPQ shares nodes instead).
+        PQ<int, std::less<int>, Alloc> moved { Alloc { &elsewhere } };
+        moved = pq;
+        assert(moved.top() == pq.top() && moved.size() == pq.size());
+        std::vector<int> values { 7, 3, 9, 1 };
+        PQ<int, std::less<int>, Alloc> ranged { values.begin(), values.end(), std::less<int>(), Alloc { &counting } };
+        assert(ranged.top() == 9);
+        while (!pq.empty()) {
+            assert(pq.top() == copy.top());
+            pq.pop();
+            copy.pop();
+        }
+
+        StablePQ<PQ, int, std::less<int>, Alloc> stable { Alloc { &counting } };
+        for (int i = 0; i < 100; ++i) {
+            stable.push(i % 10);
+        }
+        stable.updatePriorities();
+        assert(stable.top() == 9);
+    }
+    std::pmr::set_default_resource(previous);
+    assert(counting.outstanding == 0);
+    assert(elsewhere.outstanding == 0);
+
+    // The aliases in namespace pmr are the same types.
+    static_assert(std::is_same<pmr::StablePQ<PQ, int>, StablePQ<PQ, int, std::less<int>, Alloc>>::value,
+                  "pmr::StablePQ");
+
+    std::cout << "testAllocator succeeded!" << std::endl;
+}
+
+
+// Test InlinePQ over this PQ type: queues of up to N elements must never
+//   reach the upstream resource, over many fill and empty cycles, and
+//   past N the storage must move upstream without losing order, and all
+//   be given back by the end. Copies get their own buffer.
+template <template <typename...> typename PQ>
+void testInline() {
+    std::cout << "Testing inline storage..." << std::endl;
+
+    CountingResource upstream;
+    unsigned int state = 777;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 100);
+    };
+    auto popAll = [](Eecs281PQ<int>& pq, std::multiset<int>& expected) {
+        while (!pq.empty()) {
+            assert(pq.top() == *expected.rbegin());
+            expected.erase(std::prev(expected.end()));
+            pq.pop();
+        }
+        assert(expected.empty());
+    };
+
+    {
+        InlinePQ<PQ, int, std::less<int>, 16> pq { std::less<int>(), &upstream };
+        std::multiset<int> expected;
+        for (int round = 0; round < 50; ++round) {
+            int count = nextValue() % 17;
+            for (int i = 0; i < count; ++i) {
+                int value = nextValue();
+                pq.push(value);
+                expected.insert(value);
+                if (i % 3 == 2) {
+                    assert(pq.top() == *expected.rbegin());
+                    expected.erase(std::prev(expected.end()));
+                    pq.pop();
+                }
+            }
+            popAll(pq, expected);
+        }
+        assert(upstream.allocations == 0);
+
+        for (int i = 0; i < 100; ++i) {
+            int value = nextValue();
+            pq.push(value);
+            expected.insert(value);
+        }
+        assert(upstream.allocations > 0);
+        InlinePQ<PQ, int, std::less<int>, 16> copy { pq };
+        std::multiset<int> copied = expected;
+        size_t small = static_cast<size_t>(std::distance(expected.begin(), expected.lower_bound(50)));
+        assert(copy.remove_if([](int value) { return value < 50; }) == small);
+        copied.erase(copied.begin(), copied.lower_bound(50));
+        popAll(pq, expected);
+        popAll(copy, copied);
+
+        std::vector<int> values { 4, 8, 1 };
+        InlinePQ<PQ, int, std::greater<int>, 4> ranged { values.begin(), values.end(), std::greater<int>(), &upstream };
+        std::vector<int> drained;
+        ranged.drain(std::back_inserter(drained));
+        assert((drained == std::vector<int> { 1, 4, 8 }));
+    }
+    assert(upstream.outstanding == 0);
+
+    std::cout << "testInline succeeded!" << std::endl;
+}
+
+
+// Test that versions of a persistent PQ never see each other's changes:
+//   snapshots taken along the way must each pop exactly what they held when
+//   taken, after the original and other snapshots have moved on. Copies
+//   must allocate nothing, a push on a large version only O(log(n)) nodes,
+//   and a version with a long left spine must be torn down without
+//   overflowing the stack.
+void testPersistent() {
+    std::cout << "Testing Persistent PQ versions..." << std::endl;
+
+    auto popAll = [](PersistentPQ<int>& pq, std::multiset<int>& expected) {
+        while (!pq.empty()) {
+            assert(pq.top() == *expected.rbegin());
+            expected.erase(std::prev(expected.end()));
+            pq.pop();
+        }
+        assert(expected.empty());
+    };
+
+    unsigned int state = 2718;
+    auto nextValue = [&state]() {
+        state = state * 1103515245u + 12345u;
+        return static_cast<int>((state >> 16) % 1000);
+    };
+
+    PersistentPQ<int> pq;
+    std::multiset<int> expected;
+    std::vector<PersistentPQ<int>> snapshots;
+    std::vector<std::multiset<int>> snapshotExpected;
+    for (int i = 0; i < 2000; ++i) {
+        int value = nextValue();
+        pq.push(value);
+        expected.insert(value);
+        if (i % 3 == 2) {
+            assert(pq.top() == *expected.rbegin());
+            expected.erase(std::prev(expected.end()));
+            pq.pop();
+        }
+        if (i % 200 == 199) {
+            snapshots.push_back(pq);
+            snapshotExpected.push_back(expected);
+            assert(snapshots.back().sharesAllWith(pq));
+        }
+    }
+    // Moving one snapshot on leaves the others as they were.
+    snapshots[3].pop();
+    snapshotExpected[3].erase(std::prev(snapshotExpected[3].end()));
+    snapshots[3].push(5000);
+    snapshotExpected[3].insert(5000);
+    assert(!snapshots[3].sharesAllWith(snapshots[4]));
+    popAll(pq, expected);
+    for (std::size_t v = snapshots.size(); v-- > 0;) {
+        assert(snapshots[v].size() == snapshotExpected[v].size());
+        popAll(snapshots[v], snapshotExpected[v]);
+    }
+
+    // pushed() and popped() leave the version they start from alone.
+    std::vector<int> values { 5, 1, 9, 3 };
+    PersistentPQ<int> base { values.begin(), values.end() };
+    PersistentPQ<int> more = base.pushed(12);
+    PersistentPQ<int> fewer = base.popped().popped();
+    assert(base.size() == 4 && base.top() == 9);
+    assert(more.size() == 5 && more.top() == 12);
+    assert(fewer.size() == 2 && fewer.top() == 3);
+    std::vector<int> drained;
+    base.drain(std::back_inserter(drained));
+    assert((drained == std::vector<int> { 9, 5, 3, 1 }));
+    assert(more.top() == 12 && fewer.top() == 3);
+
+    CountingResource counting;
+    {
+        using Alloc = std::pmr::polymorphic_allocator<int>;
+        pmr::PersistentPQ<int> big { Alloc { &counting } };
+        for (int i = 0; i < 100000; ++i) {
+            big.push(nextValue());
+        }
+        std::size_t before = counting.allocations;
+        pmr::PersistentPQ<int> copy { big };
+        assert(counting.allocations == before);
+        copy.push(nextValue());
+        copy.pop();
+        // both spines of the meld in each, at most log2(n + 1) + 1 nodes
+        assert(counting.allocations - before <= 2 * 19);
+        assert(copy.size() == big.size());
+
+        // Ascending keys each become the new root with the old root as its
+        // left child: a left spine as long as the PQ.
+        pmr::PersistentPQ<int> spine { Alloc { &counting } };
+        for (int i = 0; i < 200000; ++i) {
+            spine.push(i);
+        }
+        pmr::PersistentPQ<int> spineCopy { spine };
+        spine.pop();
+        assert(spine.top() == 199998 && spineCopy.top() == 199999);
+    }
+    assert(counting.outstanding == 0);
+
+    std::cout << "testPersistent succeeded!" << std::endl;
+}
+
+
+// A job with a small integer priority class, ordered and bucketed by it.
+struct QosJob {
+    int qos;
+    int id;
+};
+
+struct QosJobComp {
+    bool operator()(QosJob const& a, QosJob const& b) const { return a.qos < b.qos; }
+    size_t level(QosJob const& job) const { return static_cast<size_t>(job.qos); }
+};
+
+struct IntPtrLevel {
+    bool operator()(int const* a, int const* b) const { return *a < *b; }
+    size_t level(int const* a) const { return static_cast<size_t>(*a); }
+};
+
+
+// Test BitmapPQ's buckets: jobs of the same level must pop in push order,
+//   levels must be found across every tier of the bitmaps, out of range
+//   elements and level counts must throw, and updatePriorities() must move
+//   elements to their new levels.
+void testBitmap() {
+    std::cout << "Testing Bitmap PQ buckets..." << std::endl;
+
+    bool threw = false;
+    try {
+        BitmapPQ<int> invalid { BitmapPQ<int>::MAX_LEVELS + 1 };
+    }
+    catch (std::invalid_argument const&) {
+        threw = true;
+    }
+    assert(threw);
+
+    // FIFO within a level, against a stable sort of what was pushed.
+    {
+        BitmapPQ<QosJob, QosJobComp> pq { 300 };
+        std::vector<QosJob> expected;
+        unsigned int state = 4242;
+        int nextId = 0;
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 200; ++i) {
+                state = state * 1103515245u + 12345u;
+                QosJob job { static_cast<int>((state >> 16) % 300), nextId++ };
+                pq.push(job);
+                expected.push_back(job);
+            }
+            std::stable_sort(expected.begin(), expected.end(), [](QosJob const& a, QosJob const& b) {
+                return a.qos > b.qos;
+            });
+            for (int i = 0; i < 150; ++i) {
+                assert(pq.top().qos == expected.front().qos && pq.top().id == expected.front().id);
+                expected.erase(expected.begin());
+                pq.pop();
+            }
+        }
+        assert(pq.size() == expected.size());
+        BitmapPQ<QosJob, QosJobComp> copy { pq };
+        std::vector<QosJob> drained;
+        copy.drain(std::back_inserter(drained));
+        for (size_t i = 0; i < drained.size(); ++i) {
+            assert(drained[i].id == expected[i].id);
+        }
+        assert(pq.size() == expected.size());
+
+        threw = false;
+        try {
+            pq.push(QosJob { 300, nextId });
+        }
+        catch (std::out_of_range const&) {
+            threw = true;
+        }
+        assert(threw && pq.size() == expected.size());
+    }
+
+    // Under std::greater the lowest value is the highest level.
+    {
+        std::vector<int> values { 999, 0, 500, 0, 63, 64 };
+        BitmapPQ<int, std::greater<int>> pq { values.begin(), values.end(), 1000 };
+        std::vector<int> drained;
+        pq.drain(std::back_inserter(drained));
+        assert((drained == std::vector<int> { 0, 0, 63, 64, 500, 999 }));
+        threw = false;
+        try {
+            pq.push(-1);
+        }
+        catch (std::out_of_range const&) {
+            threw = true;
+        }
+        assert(threw && pq.empty());
+    }
+
+    // Levels at the edges of words in every tier, emptied and refilled.
+    {
+        std::vector<int> values { 0, 63, 64, 4095, 4096, 262143, 131072, 1 };
+        BitmapPQ<int> pq { values.begin(), values.end(), BitmapPQ<int>::MAX_LEVELS };
+        std::multiset<int> expected(values.begin(), values.end());
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 0; i < 4; ++i) {
+                assert(pq.top() == *expected.rbegin());
+                expected.erase(std::prev(expected.end()));
+                pq.pop();
+            }
+            for (int value : { 4095, 65, 262143 - round }) {
+                pq.push(value);
+                expected.insert(value);
+            }
+        }
+        while (!pq.empty()) {
+            assert(pq.top() == *expected.rbegin());
+            expected.erase(std::prev(expected.end()));
+            pq.pop();
+        }
+        assert(expected.empty());
+    }
+
+    // updatePriorities() moves elements between levels.
+    {
+        std::vector<int> data { 3, 1, 4, 1, 5, 9, 2, 6 };
+        BitmapPQ<int const*, IntPtrLevel> pq { 16 };
+        for (int const& datum : data) {
+            pq.push(&datum);
+        }
+        data[1] = 15;
+        data[5] = 0;
+        pq.updatePriorities();
+        assert(pq.top() == &data[1]);
+        std::vector<int const*> drained;
+        pq.drain(std::back_inserter(drained));
+        std::vector<int> order;
+        for (int const* p : drained) {
+            order.push_back(*p);
+        }
+        assert((order == std::vector<int> { 15, 6, 5, 4, 3, 2, 1, 0 }));
+    }
+
+    CountingResource counting;
+    {
+        using Alloc = std::pmr::polymorphic_allocator<int>;
+        pmr::BitmapPQ<int> pq { 256, std::less<int>(), Alloc { &counting } };
+        for (int i = 0; i < 1000; ++i) {
+            pq.push(i % 256);
+        }
+        assert(counting.allocations > 0);
+        assert(pq.top() == 255);
+    }
+    assert(counting.outstanding == 0);
+
+    std::cout << "testBitmap succeeded!" << std::endl;
+}
+
+
+// Test BoundedPairingPQ's rank bound: a tree of rank k holds at least
+//   F(k+2) nodes, so after pushes in the orders that give PairingPQ its
+//   longest child lists, and after a mix of updateElt() and erase() calls
+//   that cascade cuts, no rank may pass that bound for the current size.
+//   Pops must come out in order and never allocate.
+void testBoundedPairing() {
+    std::cout << "Testing BoundedPairing ranks..." << std::endl;
+
+    auto rankBound = [](size_t n) {
+        size_t k = 0;
+        for (size_t a = 1, b = 2; b <= n; ++k) {
+            b += a;
+            a = b - a;
+        }
+        return k;
+    };
+
+    using Alloc = std::pmr::polymorphic_allocator<int>;
+    CountingResource counting;
+    for (bool ascending : { true, false }) {
+        pmr::BoundedPairingPQ<int> pq { Alloc { &counting } };
+        int const n = 100000;
+        for (int i = 0; i < n; ++i) {
+            pq.push(ascending ? i : n - 1 - i);
+        }
+        assert(pq.maxRank() <= rankBound(pq.size()));
+        size_t const allocations = counting.allocations;
+        for (int expected = n - 1; expected >= 0; --expected) {
+            assert(pq.top() == expected);
+            pq.pop();
+            if (expected % 1000 == 0) {
+                assert(pq.maxRank() <= rankBound(pq.size()));
+            }
+        }
+        assert(pq.empty());
+        assert(counting.allocations == allocations);
+    }
+    assert(counting.outstanding == 0);
+
+    {
+        BoundedPairingPQ<int> pq;
+        std::vector<BoundedPairingPQ<int>::Node*> handles;
+        std::multiset<int> expected;
+        unsigned int state = 47;
+        auto nextValue = [&state]() {
+            state = state * 1103515245u + 12345u;
+            return static_cast<int>((state >> 16) % 100000);
+        };
+        for (int i = 0; i < 20000; ++i) {
+            int value = nextValue();
+            handles.push_back(pq.addNode(value));
+            expected.insert(value);
+        }
+        // Pop a few so the updates below cut out of deep, linked trees.
+        for (int i = 0; i < 100; ++i) {
+            expected.erase(expected.find(pq.top()));
+            auto top = std::find_if(handles.begin(), handles.end(),
+                                    [&pq](auto const* node) { return node != nullptr && &node->getElt() == &pq.top(); });
+            *top = nullptr;
+            pq.pop();
+        }
+        for (int step = 0; step < 40000; ++step) {
+            size_t i = static_cast<size_t>(nextValue()) % handles.size();
+            if (handles[i] == nullptr) {
+                continue;
+            }
+            int old = handles[i]->getElt();
+            expected.erase(expected.find(old));
+            if (step % 4 == 0) {
+                pq.erase(handles[i]);
+                handles[i] = nullptr;
+            }
+            else {
+                pq.updateElt(handles[i], old + 1 + nextValue() % 1000);
+                expected.insert(handles[i]->getElt());
+            }
+            assert(pq.top() == *expected.rbegin());
+            assert(pq.size() == expected.size());
+            assert(pq.maxRank() <= rankBound(pq.size()));
+        }
+        std::vector<int> drained;
+        pq.drain(std::back_inserter(drained));
+        assert(std::equal(drained.begin(), drained.end(), expected.rbegin(), expected.rend()));
+    }
+
+    std::cout << "testBoundedPairing succeeded!" << std::endl;
+}
+
+
+// Run all tests for a particular PQ type.
+template <template <typename...> typename PQ>
+void testPriorityQueue() {
+    testPrimitiveOperations<PQ>();
+    testPopOrder<PQ>();
+    testArithmeticKeys<PQ>();
+    testPopK<PQ>();
+    testHiddenData<PQ>();
+    testUpdatePriorities<PQ>();
+    testExecutor<PQ>();
+    testStable<PQ>();
+    testShiftable<PQ>();
+    testRecording<PQ>();
+    testAllocator<PQ>();
+    testInline<PQ>();
+    testRemoveIf<PQ>();
+}
+
+// PairingPQ has some extra behavior we need to test in updateElement.
+// This template specialization handles that without changing the nice uniform
+//   interface of testPriorityQueue.
+template <>
+void testPriorityQueue<PairingPQ>() {
+    testPrimitiveOperations<PairingPQ>();
+    testPopOrder<PairingPQ>();
+    testArithmeticKeys<PairingPQ>();
+    testPopK<PairingPQ>();
+    testRemoveIf<PairingPQ>();
+    testHiddenData<PairingPQ>();
+    testUpdatePriorities<PairingPQ>();
+    testExecutor<PairingPQ>();
+    testStable<PairingPQ>();
+    testShiftable<PairingPQ>();
+    testRecording<PairingPQ>();
+    testAllocator<PairingPQ>();
+    testInline<PairingPQ>();
+    testRecordingHandles<PairingPQ>();
+    testPairing();
+    testShiftPairing();
+    testUpdateEltMany<PairingPQ>();
+    testErase<PairingPQ>();
+    testRemoveIf<ShiftPairingPQ>();
+    testRemoveIfHandles<PairingPQ>();
+}
+
+template <>
+void testPriorityQueue<AdaptivePQ>() {
+    testPrimitiveOperations<AdaptivePQ>();
+    testPopOrder<AdaptivePQ>();
+    testArithmeticKeys<AdaptivePQ>();
+    testPopK<AdaptivePQ>();
+    testRemoveIf<AdaptivePQ>();
+    testHiddenData<AdaptivePQ>();
+    testUpdatePriorities<AdaptivePQ>();
+    testExecutor<AdaptivePQ>();
+    testStable<AdaptivePQ>();
+    testShiftable<AdaptivePQ>();
+    testRecording<AdaptivePQ>();
+    testAllocator<AdaptivePQ>();
+    testAdaptive();
+}
+
+template <>
+void testPriorityQueue<SequenceHeapPQ>() {
+    testPrimitiveOperations<SequenceHeapPQ>();
+    testPopOrder<SequenceHeapPQ>();
+    testArithmeticKeys<SequenceHeapPQ>();
+    testPopK<SequenceHeapPQ>();
+    testRemoveIf<SequenceHeapPQ>();
+    testHiddenData<SequenceHeapPQ>();
+    testUpdatePriorities<SequenceHeapPQ>();
+    testExecutor<SequenceHeapPQ>();
+    testStable<SequenceHeapPQ>();
+    testShiftable<SequenceHeapPQ>();
+    testRecording<SequenceHeapPQ>();
+    testAllocator<SequenceHeapPQ>();
+    testSequenceHeap();
+}
+
+template <>
+void testPriorityQueue<CompactPairingPQ>() {
+    testPrimitiveOperations<CompactPairingPQ>();
+    testPopOrder<CompactPairingPQ>();
+    testArithmeticKeys<CompactPairingPQ>();
+    testPopK<CompactPairingPQ>();
+    testRemoveIf<CompactPairingPQ>();
+    testHiddenData<CompactPairingPQ>();
+    testUpdatePriorities<CompactPairingPQ>();
+    testExecutor<CompactPairingPQ>();
+    testStable<CompactPairingPQ>();
+    testShiftable<CompactPairingPQ>();
+    testRecording<CompactPairingPQ>();
+    testAllocator<CompactPairingPQ>();
+    testCompactPairing();
+    testErase<CompactPairingPQ>();
+    testRemoveIfHandles<CompactPairingPQ>();
+}
+
+template <>
+void testPriorityQueue<IndexedBinaryPQ>() {
+    testPrimitiveOperations<IndexedBinaryPQ>();
+    testPopOrder<IndexedBinaryPQ>();
+    testArithmeticKeys<IndexedBinaryPQ>();
+    testPopK<IndexedBinaryPQ>();
+    testRemoveIf<IndexedBinaryPQ>();
+    testHiddenData<IndexedBinaryPQ>();
+    testUpdatePriorities<IndexedBinaryPQ>();
+    testExecutor<IndexedBinaryPQ>();
+    testStable<IndexedBinaryPQ>();
+    testShiftable<IndexedBinaryPQ>();
+    testRecording<IndexedBinaryPQ>();
+    testAllocator<IndexedBinaryPQ>();
+    testErase<IndexedBinaryPQ>();
+    testRemoveIfHandles<IndexedBinaryPQ>();
+}
+
+template <>
+void testPriorityQueue<RankPairingPQ>() {
+    testPrimitiveOperations<RankPairingPQ>();
+    testPopOrder<RankPairingPQ>();
+    testArithmeticKeys<RankPairingPQ>();
+    testPopK<RankPairingPQ>();
+    testRemoveIf<RankPairingPQ>();
+    testHiddenData<RankPairingPQ>();
+    testUpdatePriorities<RankPairingPQ>();
+    testExecutor<RankPairingPQ>();
+    testStable<RankPairingPQ>();
+    testShiftable<RankPairingPQ>();
+    testRecording<RankPairingPQ>();
+    testAllocator<RankPairingPQ>();
+    testRecordingHandles<RankPairingPQ>();
+    testRankPairing();
+    testUpdateEltMany<RankPairingPQ>();
+    testRemoveIfHandles<RankPairingPQ>();
+}
+
+
+template <>
+void testPriorityQueue<SharedMemoryPQ>() {
+    testPrimitiveOperations<SharedMemoryPQ>();
+    testPopOrder<SharedMemoryPQ>();
+    testArithmeticKeys<SharedMemoryPQ>();
+    testPopK<SharedMemoryPQ>();
+    testRemoveIf<SharedMemoryPQ>();
+    testHiddenData<SharedMemoryPQ>();
+    testUpdatePriorities<SharedMemoryPQ>();
+    testSharedMemory();
+}
+
+
+template <>
+void testPriorityQueue<SoftHeapPQ>() {
+    testPrimitiveOperations<SoftHeapPQ>();
+    testPopOrder<SoftHeapPQ>();
+    testArithmeticKeys<SoftHeapPQ>();
+    testPopK<SoftHeapPQ>();
+    testRemoveIf<SoftHeapPQ>();
+    testHiddenData<SoftHeapPQ>();
+    testUpdatePriorities<SoftHeapPQ>();
+    testExecutor<SoftHeapPQ>();
+    testStable<SoftHeapPQ>();
+    testShiftable<SoftHeapPQ>();
+    testRecording<SoftHeapPQ>();
+    testAllocator<SoftHeapPQ>();
+    testSoftHeap();
+}
+
+
+template <>
+void testPriorityQueue<PersistentPQ>() {
+    testPrimitiveOperations<PersistentPQ>();
+    testPopOrder<PersistentPQ>();
+    testArithmeticKeys<PersistentPQ>();
+    testPopK<PersistentPQ>();
+    testRemoveIf<PersistentPQ>();
+    testHiddenData<PersistentPQ>();
+    testUpdatePriorities<PersistentPQ>();
+    testExecutor<PersistentPQ>();
+    testStable<PersistentPQ>();
+    testShiftable<PersistentPQ>();
+    testRecording<PersistentPQ>();
+    testAllocator<PersistentPQ>();
+    testPersistent();
+}
+
+
+// BitmapPQ needs elements that map to integer levels, which the wrappers
+//   and pointer tests don't have, so it runs the integer tests only.
+template <>
+void testPriorityQueue<BitmapPQ>() {
+    testPrimitiveOperations<BitmapPQ>();
+    testPopOrder<BitmapPQ>();
+    testPopK<BitmapPQ>();
+    testRemoveIf<BitmapPQ>();
+    testHiddenData<BitmapPQ>();
+    testBitmap();
+}
+
+template <>
+void testPriorityQueue<BoundedPairingPQ>() {
+    testPrimitiveOperations<BoundedPairingPQ>();
+    testPopOrder<BoundedPairingPQ>();
+    testArithmeticKeys<BoundedPairingPQ>();
+    testPopK<BoundedPairingPQ>();
+    testRemoveIf<BoundedPairingPQ>();
+    testHiddenData<BoundedPairingPQ>();
+    testUpdatePriorities<BoundedPairingPQ>();
+    testExecutor<BoundedPairingPQ>();
+    testStable<BoundedPairingPQ>();
+    testShiftable<BoundedPairingPQ>();
+    testRecording<BoundedPairingPQ>();
+    testAllocator<BoundedPairingPQ>();
+    testInline<BoundedPairingPQ>();
+    testRecordingHandles<BoundedPairingPQ>();
+    testUpdateEltMany<BoundedPairingPQ>();
+    testErase<BoundedPairingPQ>();
+    testBoundedPairing();
+    testRemoveIfHandles<BoundedPairingPQ>();
+}
+
+
+int main() {
+    std::vector<PQType> const types {
+        PQType::Unordered,
+        PQType::Sorted,
+        PQType::Binary,
+        PQType::Pairing,
+        PQType::RankPairing,
+        PQType::UnorderedFast,
+        PQType::Adaptive,
+        PQType::SequenceHeap,
+        PQType::CompactPairing,
+        PQType::IndexedBinary,
+        PQType::SharedMemory,
+        PQType::SoftHeap,
+        PQType::Persistent,
+        PQType::Bitmap,
+        PQType::BoundedPairing,
+    };
+
+    std::cout << "PQ tester" << std::endl << std::endl;
+    int idx { 0 };
+    for (auto const& type : types) {
+        std::cout << "  " << idx++ << ") " << type << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::cout << "Select one: ";
+    int choice {};
+    std::cin >> choice;
+    PQType const pqType = types.at(choice);
+
+    std::cout << "Testing the " << pqType << " PQ...";
+
+    // TODO: Add more cases to test other priority queue types.
+    switch (pqType) {
+    case PQType::Unordered:
+        testPriorityQueue<UnorderedPQ>();
+        break;
+    case PQType::Sorted:
+        testPriorityQueue<SortedPQ>();
+        break;
+    case PQType::Binary:
+        testPriorityQueue<BinaryPQ>();
+        break;
+    case PQType::Pairing:
+        testPriorityQueue<PairingPQ>();
+        break;
+    case PQType::RankPairing:
+        testPriorityQueue<RankPairingPQ>();
+        break;
+    case PQType::UnorderedFast:
+        testPriorityQueue<UnorderedFastPQ>();
+        break;
+    case PQType::Adaptive:
+        testPriorityQueue<AdaptivePQ>();
+        break;
+    case PQType::SequenceHeap:
+        testPriorityQueue<SequenceHeapPQ>();
+        break;
+    case PQType::CompactPairing:
+        testPriorityQueue<CompactPairingPQ>();
+        break;
+    case PQType::IndexedBinary:
+        testPriorityQueue<IndexedBinaryPQ>();
+        break;
+    case PQType::SharedMemory:
+        testPriorityQueue<SharedMemoryPQ>();
+        break;
+    case PQType::SoftHeap:
+        testPriorityQueue<SoftHeapPQ>();
+        break;
+    case PQType::Persistent:
+        testPriorityQueue<PersistentPQ>();
+        break;
+    case PQType::Bitmap:
+        testPriorityQueue<BitmapPQ>();
+        break;
+    case PQType::BoundedPairing:
+        testPriorityQueue<BoundedPairingPQ>();
+        break;
+    default:
+        std::cout << "Unrecognized PQ type " << pqType << " in main." << std::endl
+                  << "Perhaps you forgot to add tests for all four PQ types." << std::endl;
+        return 1;
+    }
+
+    // LoserTreeMerge is not a PQ and does not depend on the choice above, so
+    //   it runs whichever PQ is being tested.
+    testLoserTreeMerge();
+
     std::cout << "All tests succeeded!" << std::endl;
 
     return 0;